@@ -183,5 +183,43 @@ namespace ActivationFunctionsTest
             Assert::AreEqual(true, derivedTanhCenterLeft >= derivedTanhLeft);
             Assert::AreEqual(true, derivedTanhCenterRight >= derivedTanhRight);
         }
+
+        //------------------------------------
+        // approximations
+        //------------------------------------
+        TEST_METHOD(ActivationFunctions_approximateSigmoid)
+        {
+            // stays within the documented error bound over the whole range, including outside the table
+            for (double val = -20; val <= 20; val += 0.0123)
+            {
+                Assert::AreEqual(ActivationFunctions::sigmoid(val), ActivationFunctions::approximateSigmoid(val), 0.000003);
+            }
+
+            Assert::AreEqual(0.5, ActivationFunctions::approximateSigmoid(0), 0.000003);
+            Assert::AreEqual(0, ActivationFunctions::approximateSigmoid(-1000), 0.000003);
+            Assert::AreEqual(1, ActivationFunctions::approximateSigmoid(1000), 0.000003);
+            Assert::AreEqual(1, ActivationFunctions::approximateSigmoid(INFINITY), 0.000003);
+        }
+
+        TEST_METHOD(ActivationFunctions_approximateHyperbolicTan)
+        {
+            for (double val = -20; val <= 20; val += 0.0123)
+            {
+                Assert::AreEqual(ActivationFunctions::hyperbolicTan(val), ActivationFunctions::approximateHyperbolicTan(val), 0.000006);
+            }
+
+            Assert::AreEqual(0, ActivationFunctions::approximateHyperbolicTan(0), 0.000006);
+            Assert::AreEqual(-1, ActivationFunctions::approximateHyperbolicTan(-1000), 0.000006);
+            Assert::AreEqual(1, ActivationFunctions::approximateHyperbolicTan(1000), 0.000006);
+        }
+
+        TEST_METHOD(ActivationFunctions_derivedApproximations)
+        {
+            for (double val = -10; val <= 10; val += 0.25)
+            {
+                Assert::AreEqual(ActivationFunctions::sigmoid(val, true), ActivationFunctions::approximateSigmoid(val, true), 0.00001);
+                Assert::AreEqual(ActivationFunctions::hyperbolicTan(val, true), ActivationFunctions::approximateHyperbolicTan(val, true), 0.00002);
+            }
+        }
     };
 }
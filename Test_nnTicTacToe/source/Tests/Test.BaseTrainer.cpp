@@ -0,0 +1,61 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Training/BaseTrainer.h"
+
+#include <vector>
+
+namespace BaseTrainerTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Training;
+
+    TEST_CLASS(BaseTrainer_Test)
+    {
+    public:
+        TEST_METHOD(BaseTrainer_computeRungEndSteps)
+        {
+            std::vector<int> rungEndSteps;
+
+            // each rung uses a third of the steps of the next one, the last one all of them
+            BaseTrainer::computeRungEndSteps(222, 3, 3, rungEndSteps);
+            Assert::AreEqual(true, rungEndSteps == std::vector<int>({ 24, 74, 222 }));
+
+            // a single rung scores on all steps
+            BaseTrainer::computeRungEndSteps(222, 1, 3, rungEndSteps);
+            Assert::AreEqual(true, rungEndSteps == std::vector<int>({ 222 }));
+
+            // too many rungs: the ones that wouldn't add any steps are left out, but the last one still covers all steps
+            BaseTrainer::computeRungEndSteps(222, 12, 3, rungEndSteps);
+            Assert::AreEqual(true, rungEndSteps == std::vector<int>({ 1, 2, 8, 24, 74, 222 }));
+
+            BaseTrainer::computeRungEndSteps(2, 3, 2, rungEndSteps);
+            Assert::AreEqual(true, rungEndSteps == std::vector<int>({ 1, 2 }));
+        }
+
+        TEST_METHOD(BaseTrainer_computeNumSurvivors)
+        {
+            // rounded up
+            Assert::AreEqual(4, BaseTrainer::computeNumSurvivors(10, 1, 3));
+            Assert::AreEqual(3, BaseTrainer::computeNumSurvivors(9, 1, 3));
+
+            // at least the minimum, but never more than there are
+            Assert::AreEqual(5, BaseTrainer::computeNumSurvivors(10, 5, 3));
+            Assert::AreEqual(3, BaseTrainer::computeNumSurvivors(3, 5, 3));
+            Assert::AreEqual(1, BaseTrainer::computeNumSurvivors(1, 1, 3));
+        }
+
+        TEST_METHOD(BaseTrainer_capEliminatedScores)
+        {
+            // the sets that got to the last rung scored 10 or more; rung 1 dropped sets with 11 and 9, rung 0 sets with 12 and 5
+            std::vector<std::vector<double>> eliminatedScoresPerRung({ { 12, 5 }, { 11, 9 }, {} });
+            BaseTrainer::capEliminatedScores(10, eliminatedScoresPerRung);
+
+            // a dropped set ends up just below the lowest set that got further, lower scores are kept
+            Assert::AreEqual(true, eliminatedScoresPerRung[1][0] < 10 && eliminatedScoresPerRung[1][0] > 9.9999);
+            Assert::AreEqual(9.0, eliminatedScoresPerRung[1][1]);
+            Assert::AreEqual(true, eliminatedScoresPerRung[0][0] < 9 && eliminatedScoresPerRung[0][0] > 8.9999);
+            Assert::AreEqual(5.0, eliminatedScoresPerRung[0][1]);
+            Assert::AreEqual(true, eliminatedScoresPerRung[2].empty());
+        }
+    };
+}
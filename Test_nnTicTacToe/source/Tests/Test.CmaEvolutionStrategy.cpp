@@ -0,0 +1,112 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "NeuralNetwork/CmaEvolutionStrategy.h"
+#include "Math/Random.h"
+
+#include <vector>
+
+namespace CmaEvolutionStrategyTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace NeuralNetwork;
+
+    TEST_CLASS(CmaEvolutionStrategy_Test)
+    {
+    public:
+        TEST_METHOD(CmaEvolutionStrategy_choleskyDecomposition)
+        {
+            // L = [2 0 0; 1 3 0; -1 2 1]
+            std::vector<double> matrix({ 4, 2, -2,
+                                         2, 10, 5,
+                                         -2, 5, 6 });
+            Assert::AreEqual(true, CmaEvolutionStrategy::choleskyDecomposition(matrix, 3));
+
+            const std::vector<double> expected({ 2, 0, 0,
+                                                 1, 3, 0,
+                                                 -1, 2, 1 });
+            for (int k = 0; k < 9; k++)
+            {
+                Assert::AreEqual(expected[k], matrix[k], 0.000001);
+            }
+
+            std::vector<double> indefinite({ 1, 2,
+                                             2, 1 });
+            Assert::AreEqual(false, CmaEvolutionStrategy::choleskyDecomposition(indefinite, 2));
+        }
+
+        TEST_METHOD(CmaEvolutionStrategy_full)
+        {
+            Assert::AreEqual(true, optimizesEllipsoid(false));
+        }
+
+        TEST_METHOD(CmaEvolutionStrategy_separable)
+        {
+            Assert::AreEqual(true, optimizesEllipsoid(true));
+        }
+
+        TEST_METHOD(CmaEvolutionStrategy_reproducible)
+        {
+            Math::Random::setMasterSeed(11);
+
+            CmaEvolutionStrategy cma1;
+            CmaEvolutionStrategy cma2;
+            cma1.setup(std::vector<double>(6, 1.0), 0.5, 8, false);
+            cma2.setup(std::vector<double>(6, 1.0), 0.5, 8, false);
+
+            // the second strategy samples in parallel
+            cma2.setThreadPool(std::make_shared<General::ThreadPool>(3));
+
+            cma1.samplePopulation();
+            cma2.samplePopulation();
+
+            for (int k = 0; k < 8; k++)
+            {
+                for (int i = 0; i < 6; i++)
+                {
+                    Assert::AreEqual(cma1.getCandidate(k)[i], cma2.getCandidate(k)[i]);
+                }
+            }
+        }
+
+    private:
+        /// maximizes -sum of i * (x_i - 3)^2 starting at 0
+        static bool optimizesEllipsoid(bool separable)
+        {
+            Math::Random::setMasterSeed(7);
+
+            const int numParams = 5;
+            const int populationSize = 10;
+
+            CmaEvolutionStrategy cma;
+            cma.setup(std::vector<double>(numParams, 0.0), 1.0, populationSize, separable);
+
+            std::vector<double> scores(populationSize);
+            for (int generation = 0; generation < 300; generation++)
+            {
+                cma.samplePopulation();
+                for (int k = 0; k < populationSize; k++)
+                {
+                    const double* candidate = cma.getCandidate(k);
+
+                    scores[k] = 0;
+                    for (int i = 0; i < numParams; i++)
+                    {
+                        scores[k] -= (i + 1) * (candidate[i] - 3) * (candidate[i] - 3);
+                    }
+                }
+
+                cma.update(scores);
+            }
+
+            for (auto value : cma.getMean())
+            {
+                if (std::abs(value - 3) > 0.001)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
@@ -0,0 +1,151 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "NeuralNetwork/EvolutionKernels.h"
+
+#include <vector>
+
+namespace EvolutionKernelsTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Math;
+    using namespace NeuralNetwork;
+
+    TEST_CLASS(EvolutionKernels_Test)
+    {
+    public:
+        //------------------------------------
+        // mutate
+        //------------------------------------
+        TEST_METHOD(EvolutionKernels_mutate_noMutation)
+        {
+            const std::vector<double> parent({ 0.5, -2, 3, 100 });
+            std::vector<double> child(4);
+
+            RandomGenerator generator(1);
+            MutationSettings settings;
+            EvolutionKernels::mutate(generator, parent.data(), 4, settings, child.data());
+
+            for (int k = 0; k < 4; k++)
+            {
+                Assert::AreEqual(parent[k], child[k], 0.000001);
+            }
+        }
+
+        TEST_METHOD(EvolutionKernels_mutate_alwaysReplace)
+        {
+            const std::vector<double> parent(100, 10.0);
+            std::vector<double> child(100);
+
+            RandomGenerator generator(2);
+            MutationSettings settings;
+            settings.minValue = -1;
+            settings.maxValue = 1;
+            settings.replacementChance = 1;
+            EvolutionKernels::mutate(generator, parent.data(), 100, settings, child.data());
+
+            for (auto value : child)
+            {
+                Assert::AreEqual(true, value >= -1 && value < 1);
+            }
+        }
+
+        TEST_METHOD(EvolutionKernels_mutate_replacementChance)
+        {
+            const int numParams = 100000;
+            const std::vector<double> parent(numParams, 10.0);
+            std::vector<double> child(numParams);
+
+            RandomGenerator generator(3);
+            MutationSettings settings;
+            settings.replacementChance = 0.05;
+            EvolutionKernels::mutate(generator, parent.data(), numParams, settings, child.data());
+
+            int numChanged = 0;
+            for (auto value : child)
+            {
+                if (value != 10.0)
+                {
+                    Assert::AreEqual(true, value >= -1 && value < 1);
+                    numChanged++;
+                }
+            }
+
+            Assert::AreEqual(0.05, numChanged / static_cast<double>(numParams), 0.005);
+        }
+
+        TEST_METHOD(EvolutionKernels_mutate_bonusIsClamped)
+        {
+            const std::vector<double> parent({ 0.99, -0.99, 0.99, -0.99 });
+            std::vector<double> child(4);
+
+            RandomGenerator generator(4);
+            MutationSettings settings;
+            settings.bonusChance = 1;
+            settings.bonusScale = 5;
+            EvolutionKernels::mutate(generator, parent.data(), 4, settings, child.data());
+
+            for (int k = 0; k < 4; k++)
+            {
+                Assert::AreEqual(true, child[k] >= -1 && child[k] <= 1);
+                Assert::AreNotEqual(parent[k], child[k]);
+            }
+        }
+
+        //------------------------------------
+        // crossover
+        //------------------------------------
+        TEST_METHOD(EvolutionKernels_crossover)
+        {
+            // more than one block of 64 parameters
+            const int numParams = 1000;
+            const std::vector<double> parent1(numParams, 1.0);
+            const std::vector<double> parent2(numParams, 2.0);
+            std::vector<double> child(numParams);
+
+            RandomGenerator generator(5);
+            MutationSettings settings;
+            EvolutionKernels::crossover(generator, parent1.data(), parent2.data(), numParams, settings, child.data());
+
+            int numFromFirst = 0;
+            for (auto value : child)
+            {
+                Assert::AreEqual(true, value == 1.0 || value == 2.0);
+                if (value == 1.0)
+                {
+                    numFromFirst++;
+                }
+            }
+
+            Assert::AreEqual(0.5, numFromFirst / static_cast<double>(numParams), 0.06);
+        }
+
+        TEST_METHOD(EvolutionKernels_crossover_reproducible)
+        {
+            const int numParams = 70;
+            std::vector<double> parent1(numParams);
+            std::vector<double> parent2(numParams);
+            for (int k = 0; k < numParams; k++)
+            {
+                parent1[k] = k * 0.01;
+                parent2[k] = -k * 0.01;
+            }
+
+            MutationSettings settings;
+            settings.replacementChance = 0.1;
+            settings.bonusChance = 0.1;
+
+            std::vector<double> child1(numParams);
+            std::vector<double> child2(numParams);
+
+            RandomGenerator generator1(6);
+            RandomGenerator generator2(6);
+            EvolutionKernels::crossover(generator1, parent1.data(), parent2.data(), numParams, settings, child1.data());
+            EvolutionKernels::crossover(generator2, parent1.data(), parent2.data(), numParams, settings, child2.data());
+
+            for (int k = 0; k < numParams; k++)
+            {
+                Assert::AreEqual(child1[k], child2[k]);
+            }
+        }
+    };
+}
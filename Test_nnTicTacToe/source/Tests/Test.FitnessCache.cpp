@@ -0,0 +1,96 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "NeuralNetwork/FitnessCache.h"
+
+#include <vector>
+
+namespace FitnessCacheTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace NeuralNetwork;
+
+    TEST_CLASS(FitnessCache_Test)
+    {
+    public:
+        TEST_METHOD(FitnessCache_computeHash)
+        {
+            const std::vector<double> params({ 0.5, -1.25, 3.0 });
+
+            // identical values give identical hashes
+            Assert::AreEqual(FitnessCache::computeHash(params), FitnessCache::computeHash(std::vector<double>({ 0.5, -1.25, 3.0 })));
+
+            // any difference in the values, their order or their number changes the hash
+            Assert::AreNotEqual(FitnessCache::computeHash(params), FitnessCache::computeHash(std::vector<double>({ 0.5, -1.25, 3.0000000000000004 })));
+            Assert::AreNotEqual(FitnessCache::computeHash(params), FitnessCache::computeHash(std::vector<double>({ -1.25, 0.5, 3.0 })));
+            Assert::AreNotEqual(FitnessCache::computeHash(params), FitnessCache::computeHash(std::vector<double>({ 0.5, -1.25, 3.0, 0.0 })));
+            Assert::AreNotEqual(FitnessCache::computeHash(std::vector<double>({ 0.0 })), FitnessCache::computeHash(std::vector<double>({ -0.0 })));
+        }
+
+        TEST_METHOD(FitnessCache_computeHash_moves)
+        {
+            const std::vector<int> moves({ 4, 0, 8, 2 });
+
+            Assert::AreEqual(FitnessCache::computeHash(moves), FitnessCache::computeHash(std::vector<int>({ 4, 0, 8, 2 })));
+
+            // a single different move, the order of the moves or their number changes the hash
+            Assert::AreNotEqual(FitnessCache::computeHash(moves), FitnessCache::computeHash(std::vector<int>({ 4, 0, 8, 3 })));
+            Assert::AreNotEqual(FitnessCache::computeHash(moves), FitnessCache::computeHash(std::vector<int>({ 0, 4, 8, 2 })));
+            Assert::AreNotEqual(FitnessCache::computeHash(moves), FitnessCache::computeHash(std::vector<int>({ 4, 0, 8, 2, 0 })));
+        }
+
+        TEST_METHOD(FitnessCache_insertAndFind)
+        {
+            FitnessCache cache;
+            cache.setCapacity(10);
+
+            FitnessCache::Entry entry;
+            entry.id = 3;
+            entry.score = 0; // a legitimate score, not "unknown"
+            entry.error = 0.25;
+            cache.insert(42, entry);
+
+            FitnessCache::Entry found;
+            Assert::AreEqual(true, cache.find(42, found));
+            Assert::AreEqual(3, found.id);
+            Assert::AreEqual(0.0, found.score);
+            Assert::AreEqual(0.25, found.error);
+
+            Assert::AreEqual(false, cache.find(43, found));
+
+            // known hashes are updated in place
+            entry.score = 7;
+            cache.insert(42, entry);
+            Assert::AreEqual(1, cache.size());
+            Assert::AreEqual(true, cache.find(42, found));
+            Assert::AreEqual(7.0, found.score);
+        }
+
+        TEST_METHOD(FitnessCache_capacity)
+        {
+            FitnessCache cache;
+            FitnessCache::Entry entry;
+
+            // disabled by default
+            cache.insert(1, entry);
+            Assert::AreEqual(false, cache.isEnabled());
+            Assert::AreEqual(0, cache.size());
+
+            cache.setCapacity(3);
+            for (uint64_t hash = 1; hash <= 5; hash++)
+            {
+                cache.insert(hash, entry);
+            }
+
+            // the oldest entries are dropped first
+            Assert::AreEqual(3, cache.size());
+            Assert::AreEqual(false, cache.find(1, entry));
+            Assert::AreEqual(false, cache.find(2, entry));
+            Assert::AreEqual(true, cache.find(3, entry));
+            Assert::AreEqual(true, cache.find(5, entry));
+
+            cache.setCapacity(1);
+            Assert::AreEqual(1, cache.size());
+            Assert::AreEqual(true, cache.find(5, entry));
+        }
+    };
+}
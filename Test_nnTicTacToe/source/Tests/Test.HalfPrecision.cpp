@@ -0,0 +1,100 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Math/HalfPrecision.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace HalfPrecisionTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Math;
+
+    TEST_CLASS(HalfPrecision_Test)
+    {
+    public:
+        TEST_METHOD(HalfPrecision_float16_exactValues)
+        {
+            Assert::AreEqual(static_cast<uint16_t>(0x0000), HalfPrecision::floatToFloat16(0.0f));
+            Assert::AreEqual(static_cast<uint16_t>(0x3c00), HalfPrecision::floatToFloat16(1.0f));
+            Assert::AreEqual(static_cast<uint16_t>(0xc000), HalfPrecision::floatToFloat16(-2.0f));
+            Assert::AreEqual(static_cast<uint16_t>(0x7bff), HalfPrecision::floatToFloat16(65504.0f));
+
+            // smallest subnormal
+            Assert::AreEqual(static_cast<uint16_t>(0x0001), HalfPrecision::floatToFloat16(std::ldexp(1.0f, -24)));
+            Assert::AreEqual(std::ldexp(1.0f, -24), HalfPrecision::float16ToFloat(0x0001));
+
+            Assert::AreEqual(1.0f, HalfPrecision::float16ToFloat(0x3c00));
+            Assert::AreEqual(-0.5f, HalfPrecision::float16ToFloat(0xb800));
+            Assert::AreEqual(65504.0f, HalfPrecision::float16ToFloat(0x7bff));
+        }
+
+        TEST_METHOD(HalfPrecision_float16_rounding)
+        {
+            // 1 + 2^-11 lies exactly between 1 and the next float16 value, ties go to the even mantissa
+            Assert::AreEqual(static_cast<uint16_t>(0x3c00), HalfPrecision::floatToFloat16(1.0f + std::ldexp(1.0f, -11)));
+            Assert::AreEqual(static_cast<uint16_t>(0x3c02), HalfPrecision::floatToFloat16(1.0f + 3 * std::ldexp(1.0f, -11)));
+
+            // out of range values are clamped, NaN stays NaN
+            Assert::AreEqual(static_cast<uint16_t>(0x7bff), HalfPrecision::floatToFloat16(1e10f));
+            Assert::AreEqual(static_cast<uint16_t>(0xfbff), HalfPrecision::floatToFloat16(-std::numeric_limits<float>::infinity()));
+            Assert::AreEqual(true, std::isnan(HalfPrecision::float16ToFloat(HalfPrecision::floatToFloat16(std::numeric_limits<float>::quiet_NaN()))));
+
+            // every float16 value survives the round trip
+            for (int bits = 0; bits < 0x10000; bits++)
+            {
+                if ((bits & 0x7fff) >= 0x7c00)
+                {
+                    continue;
+                }
+
+                const uint16_t value = static_cast<uint16_t>(bits);
+                Assert::AreEqual(value, HalfPrecision::floatToFloat16(HalfPrecision::float16ToFloat(value)));
+            }
+        }
+
+        TEST_METHOD(HalfPrecision_bFloat16)
+        {
+            Assert::AreEqual(static_cast<uint16_t>(0x3f80), HalfPrecision::floatToBFloat16(1.0f));
+            Assert::AreEqual(1.0f, HalfPrecision::bFloat16ToFloat(0x3f80));
+            Assert::AreEqual(-2.0f, HalfPrecision::bFloat16ToFloat(0xc000));
+
+            // ties to even
+            Assert::AreEqual(static_cast<uint16_t>(0x3f80), HalfPrecision::floatToBFloat16(1.0f + std::ldexp(1.0f, -8)));
+            Assert::AreEqual(static_cast<uint16_t>(0x3f82), HalfPrecision::floatToBFloat16(1.0f + 3 * std::ldexp(1.0f, -8)));
+
+            // large values keep their magnitude
+            Assert::AreEqual(1e30, static_cast<double>(HalfPrecision::bFloat16ToFloat(HalfPrecision::floatToBFloat16(1e30f))), 1e28);
+            Assert::AreEqual(true, std::isnan(HalfPrecision::bFloat16ToFloat(HalfPrecision::floatToBFloat16(std::numeric_limits<float>::quiet_NaN()))));
+        }
+
+        TEST_METHOD(HalfPrecision_arrays)
+        {
+            std::vector<double> values;
+            for (int k = 0; k < 1000; k++)
+            {
+                values.push_back((k - 500) * 0.0137);
+            }
+
+            std::vector<uint16_t> stored(values.size());
+            std::vector<double> restored(values.size());
+
+            HalfPrecision::toFloat16(values.data(), static_cast<int>(values.size()), stored.data());
+            HalfPrecision::fromFloat16(stored.data(), static_cast<int>(values.size()), restored.data());
+            for (size_t k = 0; k < values.size(); k++)
+            {
+                // 10 mantissa bits
+                Assert::AreEqual(values[k], restored[k], std::abs(values[k]) * std::ldexp(1.0, -11) + 1e-7);
+            }
+
+            HalfPrecision::toBFloat16(values.data(), static_cast<int>(values.size()), stored.data());
+            HalfPrecision::fromBFloat16(stored.data(), static_cast<int>(values.size()), restored.data());
+            for (size_t k = 0; k < values.size(); k++)
+            {
+                // 7 mantissa bits
+                Assert::AreEqual(values[k], restored[k], std::abs(values[k]) * std::ldexp(1.0, -8) + 1e-30);
+            }
+        }
+    };
+}
@@ -0,0 +1,124 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Game/GameLogic.h"
+#include "Game/InputEncoder.h"
+
+namespace InputEncoderTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Game;
+
+    TEST_CLASS(InputEncoder_Test)
+    {
+    public:
+        // empty, own (player1), other (player2)
+        const std::vector<CellState> m_gameCells = { CS_EMPTY, CS_PLAYER1, CS_PLAYER2 };
+
+        void checkValues(const std::vector<double>& expectedValues, const std::vector<double>& values)
+        {
+            Assert::AreEqual(static_cast<int>(expectedValues.size()), static_cast<int>(values.size()));
+            for (unsigned int k = 0; k < values.size(); k++)
+            {
+                Assert::AreEqual(expectedValues[k], values[k], 0.0001);
+            }
+        }
+
+        TEST_METHOD(InputEncoder_parseInputEncoding)
+        {
+            InputEncoding encoding = IE_TWO_PLANES;
+            Assert::AreEqual(true, InputEncoder::parseInputEncoding("ternary", encoding));
+            Assert::AreEqual(static_cast<int>(IE_TERNARY), static_cast<int>(encoding));
+
+            Assert::AreEqual(true, InputEncoder::parseInputEncoding("one_hot", encoding));
+            Assert::AreEqual(static_cast<int>(IE_ONE_HOT), static_cast<int>(encoding));
+
+            Assert::AreEqual(true, InputEncoder::parseInputEncoding("bitplanes", encoding));
+            Assert::AreEqual(static_cast<int>(IE_BITPLANES), static_cast<int>(encoding));
+
+            Assert::AreEqual(true, InputEncoder::parseInputEncoding("two_planes", encoding));
+            Assert::AreEqual(static_cast<int>(IE_TWO_PLANES), static_cast<int>(encoding));
+
+            // unknown names don't change the encoding
+            encoding = IE_TERNARY;
+            Assert::AreEqual(false, InputEncoder::parseInputEncoding("none", encoding));
+            Assert::AreEqual(static_cast<int>(IE_TERNARY), static_cast<int>(encoding));
+        }
+
+        TEST_METHOD(InputEncoder_getNumInputValues)
+        {
+            Assert::AreEqual(18, InputEncoder::getNumInputValues(IE_TWO_PLANES, 9));
+            Assert::AreEqual(9, InputEncoder::getNumInputValues(IE_TERNARY, 9));
+            Assert::AreEqual(27, InputEncoder::getNumInputValues(IE_ONE_HOT, 9));
+            Assert::AreEqual(18, InputEncoder::getNumInputValues(IE_BITPLANES, 9));
+        }
+
+        TEST_METHOD(InputEncoder_encode_twoPlanes)
+        {
+            std::vector<double> inputValues;
+            InputEncoder::encode(IE_TWO_PLANES, m_gameCells, CS_PLAYER1, inputValues);
+            checkValues({ -1, -1, 1, -1, -1, 1 }, inputValues);
+
+            // switch perspective
+            InputEncoder::encode(IE_TWO_PLANES, m_gameCells, CS_PLAYER2, inputValues);
+            checkValues({ -1, -1, -1, 1, 1, -1 }, inputValues);
+        }
+
+        TEST_METHOD(InputEncoder_encode_ternary)
+        {
+            std::vector<double> inputValues;
+            InputEncoder::encode(IE_TERNARY, m_gameCells, CS_PLAYER1, inputValues);
+            checkValues({ 0, 1, -1 }, inputValues);
+
+            InputEncoder::encode(IE_TERNARY, m_gameCells, CS_PLAYER2, inputValues);
+            checkValues({ 0, -1, 1 }, inputValues);
+        }
+
+        TEST_METHOD(InputEncoder_encode_oneHot)
+        {
+            std::vector<double> inputValues;
+            InputEncoder::encode(IE_ONE_HOT, m_gameCells, CS_PLAYER1, inputValues);
+            checkValues({ 1, 0, 0, 0, 1, 0, 0, 0, 1 }, inputValues);
+
+            InputEncoder::encode(IE_ONE_HOT, m_gameCells, CS_PLAYER2, inputValues);
+            checkValues({ 1, 0, 0, 0, 0, 1, 0, 1, 0 }, inputValues);
+        }
+
+        TEST_METHOD(InputEncoder_encode_bitplanes)
+        {
+            std::vector<double> inputValues;
+            InputEncoder::encode(IE_BITPLANES, m_gameCells, CS_PLAYER1, inputValues);
+
+            // own plane, then other plane
+            checkValues({ 0, 1, 0, 0, 0, 1 }, inputValues);
+        }
+
+        TEST_METHOD(InputEncoder_packBitplanes)
+        {
+            const std::vector<CellState> gameCells = { CS_PLAYER2, CS_EMPTY, CS_PLAYER1, CS_PLAYER1, CS_EMPTY, CS_EMPTY, CS_EMPTY, CS_EMPTY, CS_PLAYER2 };
+
+            const uint64_t bits = InputEncoder::packBitplanes(gameCells, CS_PLAYER1);
+            Assert::AreEqual(static_cast<int>(0xC), static_cast<int>(bits & 0xFFFFFFFF));
+            Assert::AreEqual(static_cast<int>(0x101), static_cast<int>(bits >> 32));
+        }
+
+        TEST_METHOD(InputEncoder_getRequiredNetworkSize)
+        {
+            // network input size follows the encoding
+            TicTacToeLogic ticTacToe;
+            NetworkSizeData sizeData;
+
+            ticTacToe.getRequiredNetworkSize(sizeData);
+            Assert::AreEqual(18, sizeData.numInputNodes);
+            Assert::AreEqual(9, sizeData.numOutputNodes);
+
+            ticTacToe.setInputEncoding(IE_TERNARY);
+            ticTacToe.getRequiredNetworkSize(sizeData);
+            Assert::AreEqual(9, sizeData.numInputNodes);
+            Assert::AreEqual(9, sizeData.numOutputNodes);
+
+            std::vector<double> inputValues;
+            ticTacToe.getNodeNetworkInputValues(inputValues);
+            Assert::AreEqual(sizeData.numInputNodes, static_cast<int>(inputValues.size()));
+        }
+    };
+}
@@ -0,0 +1,100 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Training/IslandMigration.h"
+
+#include <vector>
+
+namespace IslandMigrationTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace NeuralNetwork;
+    using namespace Training;
+
+    // islands far from the ones of a real run, so their mailboxes aren't touched
+    const int NUM_ISLANDS = 100;
+    const int SENDING_ISLAND = 98;
+    const int RECEIVING_ISLAND = 99;
+
+    std::vector<ParamSet> createMigrants()
+    {
+        std::vector<ParamSet> migrants(2);
+        migrants[0].score = 12.5;
+        migrants[0].params = { 0.25, -1.5, 3.0 };
+        migrants[1].score = 7.0;
+        migrants[1].params = { -0.125, 2.0, 0.0 };
+        return migrants;
+    }
+
+    TEST_CLASS(IslandMigration_Test)
+    {
+    public:
+        TEST_METHOD(IslandMigration_sendMigrants_receiveMigrants)
+        {
+            IslandMigration sender(SENDING_ISLAND, NUM_ISLANDS);
+            IslandMigration receiver(RECEIVING_ISLAND, NUM_ISLANDS);
+            sender.clearMailbox();
+
+            // nothing sent yet
+            std::vector<ParamSet> received;
+            Assert::AreEqual(false, receiver.receiveMigrants(received));
+
+            const std::vector<ParamSet> migrants = createMigrants();
+            Assert::AreEqual(true, sender.sendMigrants(5, migrants));
+            Assert::AreEqual(true, receiver.receiveMigrants(received));
+
+            Assert::AreEqual(static_cast<int>(migrants.size()), static_cast<int>(received.size()));
+            for (size_t k = 0; k < migrants.size(); k++)
+            {
+                Assert::AreEqual(migrants[k].score, received[k].score);
+                Assert::AreEqual(true, migrants[k].params == received[k].params);
+            }
+
+            sender.clearMailbox();
+        }
+
+        TEST_METHOD(IslandMigration_receiveMigrants_generation)
+        {
+            IslandMigration sender(SENDING_ISLAND, NUM_ISLANDS);
+            IslandMigration receiver(RECEIVING_ISLAND, NUM_ISLANDS);
+            sender.clearMailbox();
+
+            std::vector<ParamSet> received;
+            Assert::AreEqual(true, sender.sendMigrants(5, createMigrants()));
+            Assert::AreEqual(true, receiver.receiveMigrants(received));
+
+            // the same generation is only imported once, even if it's sent again
+            Assert::AreEqual(false, receiver.receiveMigrants(received));
+            Assert::AreEqual(true, received.empty());
+            Assert::AreEqual(true, sender.sendMigrants(5, createMigrants()));
+            Assert::AreEqual(false, receiver.receiveMigrants(received));
+
+            // a newer generation replaces the mailbox
+            Assert::AreEqual(true, sender.sendMigrants(10, createMigrants()));
+            Assert::AreEqual(true, receiver.receiveMigrants(received));
+            Assert::AreEqual(2, static_cast<int>(received.size()));
+
+            sender.clearMailbox();
+        }
+
+        TEST_METHOD(IslandMigration_clearMailbox)
+        {
+            // migrants left over from an earlier run
+            IslandMigration earlierSender(SENDING_ISLAND, NUM_ISLANDS);
+            Assert::AreEqual(true, earlierSender.sendMigrants(20, createMigrants()));
+
+            // are gone once the island starts again
+            IslandMigration sender(SENDING_ISLAND, NUM_ISLANDS);
+            sender.clearMailbox();
+
+            IslandMigration receiver(RECEIVING_ISLAND, NUM_ISLANDS);
+            std::vector<ParamSet> received;
+            Assert::AreEqual(false, receiver.receiveMigrants(received));
+
+            // and the first generation of the new run still gets through
+            Assert::AreEqual(true, sender.sendMigrants(5, createMigrants()));
+            Assert::AreEqual(true, receiver.receiveMigrants(received));
+
+            sender.clearMailbox();
+        }
+    };
+}
@@ -0,0 +1,93 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Math/Lbfgs.h"
+
+#include <vector>
+
+namespace LbfgsTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Math;
+
+    TEST_CLASS(Lbfgs_Test)
+    {
+    public:
+        TEST_METHOD(Lbfgs_quadratic)
+        {
+            // sum of (k + 1) * (x_k - 1)^2, badly scaled for steepest descent
+            const Lbfgs::Objective objective = [](const std::vector<double>& x, std::vector<double>& gradient)
+            {
+                double value = 0;
+                gradient.resize(x.size());
+                for (size_t k = 0; k < x.size(); k++)
+                {
+                    value += (k + 1) * (x[k] - 1) * (x[k] - 1);
+                    gradient[k] = 2 * (k + 1) * (x[k] - 1);
+                }
+
+                return value;
+            };
+
+            std::vector<double> x(5, 0.0);
+            std::vector<double> gradient;
+            double value = objective(x, gradient);
+
+            Lbfgs optimizer(5);
+            for (int k = 0; k < 20 && value > 1e-12; k++)
+            {
+                Assert::AreEqual(true, optimizer.step(objective, x, value, gradient));
+            }
+
+            Assert::AreEqual(0.0, value, 1e-10);
+            for (auto val : x)
+            {
+                Assert::AreEqual(1.0, val, 1e-5);
+            }
+        }
+
+        TEST_METHOD(Lbfgs_rosenbrock)
+        {
+            const Lbfgs::Objective objective = [](const std::vector<double>& x, std::vector<double>& gradient)
+            {
+                const double a = 1 - x[0];
+                const double b = x[1] - x[0] * x[0];
+                gradient = { -2 * a - 400 * x[0] * b, 200 * b };
+                return a * a + 100 * b * b;
+            };
+
+            std::vector<double> x({ -1.2, 1 });
+            std::vector<double> gradient;
+            double value = objective(x, gradient);
+
+            Lbfgs optimizer;
+            for (int k = 0; k < 200; k++)
+            {
+                if (!optimizer.step(objective, x, value, gradient))
+                {
+                    break;
+                }
+            }
+
+            Assert::AreEqual(1.0, x[0], 1e-4);
+            Assert::AreEqual(1.0, x[1], 1e-4);
+        }
+
+        TEST_METHOD(Lbfgs_minimum)
+        {
+            const Lbfgs::Objective objective = [](const std::vector<double>& x, std::vector<double>& gradient)
+            {
+                gradient = { 2 * x[0] };
+                return x[0] * x[0];
+            };
+
+            // nothing left to improve
+            std::vector<double> x({ 0.0 });
+            std::vector<double> gradient;
+            double value = objective(x, gradient);
+
+            Lbfgs optimizer;
+            Assert::AreEqual(false, optimizer.step(objective, x, value, gradient));
+            Assert::AreEqual(0.0, x[0]);
+        }
+    };
+}
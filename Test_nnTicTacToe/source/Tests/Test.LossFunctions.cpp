@@ -0,0 +1,115 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Math/LossFunctions.h"
+
+#include <cmath>
+#include <vector>
+
+namespace LossFunctionsTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Math;
+
+    TEST_CLASS(LossFunctions_Test)
+    {
+    public:
+        //------------------------------------
+        // parseLossFunction
+        //------------------------------------
+        TEST_METHOD(LossFunctions_parseLossFunction)
+        {
+            LossFunction lossFunction = LF_SQUARED_ERROR;
+            Assert::AreEqual(true, LossFunctions::parseLossFunction("softmax_cross_entropy", lossFunction));
+            Assert::AreEqual(static_cast<int>(LF_SOFTMAX_CROSS_ENTROPY), static_cast<int>(lossFunction));
+
+            Assert::AreEqual(true, LossFunctions::parseLossFunction("squared_error", lossFunction));
+            Assert::AreEqual(static_cast<int>(LF_SQUARED_ERROR), static_cast<int>(lossFunction));
+
+            Assert::AreEqual(false, LossFunctions::parseLossFunction("hinge", lossFunction));
+            Assert::AreEqual(static_cast<int>(LF_SQUARED_ERROR), static_cast<int>(lossFunction));
+        }
+
+        //------------------------------------
+        // softMax
+        //------------------------------------
+        TEST_METHOD(LossFunctions_softMax)
+        {
+            const std::vector<double> values({ 1, 2, 3 });
+            std::vector<double> result(3);
+            LossFunctions::softMax(values.data(), 3, 1, result.data());
+
+            const double sum = std::exp(1) + std::exp(2) + std::exp(3);
+            Assert::AreEqual(std::exp(1) / sum, result[0], 0.000001);
+            Assert::AreEqual(std::exp(2) / sum, result[1], 0.000001);
+            Assert::AreEqual(std::exp(3) / sum, result[2], 0.000001);
+        }
+
+        TEST_METHOD(LossFunctions_softMax_largeValues)
+        {
+            // exp(1000) overflows, but the result is the same as for (0, 1)
+            const std::vector<double> values({ 1000, 1001 });
+            std::vector<double> result(2);
+            LossFunctions::softMax(values.data(), 2, 1, result.data());
+
+            Assert::AreEqual(1 / (1 + std::exp(1)), result[0], 0.000001);
+            Assert::AreEqual(std::exp(1) / (1 + std::exp(1)), result[1], 0.000001);
+        }
+
+        TEST_METHOD(LossFunctions_softMax_stride)
+        {
+            // second column of a (2 x 2) matrix
+            const std::vector<double> values({ 5, 0, 7, 0 });
+            std::vector<double> result({ -1, -1, -1, -1 });
+            LossFunctions::softMax(values.data() + 1, 2, 2, result.data() + 1);
+
+            Assert::AreEqual(-1.0, result[0], 0.000001);
+            Assert::AreEqual(0.5, result[1], 0.000001);
+            Assert::AreEqual(-1.0, result[2], 0.000001);
+            Assert::AreEqual(0.5, result[3], 0.000001);
+        }
+
+        //------------------------------------
+        // softMaxCrossEntropy
+        //------------------------------------
+        TEST_METHOD(LossFunctions_softMaxCrossEntropy)
+        {
+            const std::vector<double> logits({ 0.5, -1.0, 2.0, 0.0 });
+            const std::vector<double> targets({ 0.0, 0.25, 0.75, 0.0 });
+
+            std::vector<double> probabilities(4);
+            LossFunctions::softMax(logits.data(), 4, 1, probabilities.data());
+
+            double expectedLoss = 0;
+            for (int k = 0; k < 4; k++)
+            {
+                expectedLoss -= targets[k] * std::log(probabilities[k]);
+            }
+
+            std::vector<double> gradient(4);
+            const double loss = LossFunctions::softMaxCrossEntropy(logits.data(), targets.data(), 4, 1, gradient.data());
+            Assert::AreEqual(expectedLoss, loss, 0.000001);
+
+            for (int k = 0; k < 4; k++)
+            {
+                Assert::AreEqual(probabilities[k] - targets[k], gradient[k], 0.000001);
+            }
+
+            // gradient is optional
+            Assert::AreEqual(expectedLoss, LossFunctions::softMaxCrossEntropy(logits.data(), targets.data(), 4, 1, nullptr), 0.000001);
+        }
+
+        TEST_METHOD(LossFunctions_softMaxCrossEntropy_largeValues)
+        {
+            // the probability of the first value underflows to 0, but the loss stays finite
+            const std::vector<double> logits({ -800, 800 });
+            const std::vector<double> targets({ 1, 0 });
+
+            std::vector<double> gradient(2);
+            const double loss = LossFunctions::softMaxCrossEntropy(logits.data(), targets.data(), 2, 1, gradient.data());
+
+            Assert::AreEqual(1600.0, loss, 0.000001);
+            Assert::AreEqual(-1.0, gradient[0], 0.000001);
+            Assert::AreEqual(1.0, gradient[1], 0.000001);
+        }
+    };
+}
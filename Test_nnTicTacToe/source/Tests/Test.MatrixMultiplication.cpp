@@ -0,0 +1,115 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Math/MatrixMultiplication.h"
+
+#include <cmath>
+#include <vector>
+
+namespace MatrixMultiplicationTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Math;
+
+    TEST_CLASS(MatrixMultiplication_Test)
+    {
+    public:
+        //------------------------------------
+        // helpers
+        //------------------------------------
+        static void fillMatrix(std::vector<double>& matrix, int size, int seed)
+        {
+            matrix.clear();
+            for (int k = 0; k < size; k++)
+            {
+                // deterministic values within [-1, 1]
+                matrix.push_back(((k * 37 + seed * 11) % 201) / 100.0 - 1.0);
+            }
+        }
+
+        static double referenceEntry(bool transposeA, bool transposeB, int m, int n, int k, const std::vector<double>& a, const std::vector<double>& b, int row, int col)
+        {
+            double sum = 0;
+            for (int p = 0; p < k; p++)
+            {
+                const double valA = transposeA ? a[p * m + row] : a[row * k + p];
+                const double valB = transposeB ? b[col * k + p] : b[p * n + col];
+                sum += valA * valB;
+            }
+
+            return sum;
+        }
+
+        static void compareWithReference(bool transposeA, bool transposeB, int m, int n, int k)
+        {
+            std::vector<double> a;
+            std::vector<double> b;
+            std::vector<double> c;
+            fillMatrix(a, m * k, 1);
+            fillMatrix(b, k * n, 2);
+            fillMatrix(c, m * n, 3);
+
+            const std::vector<double> initialC = c;
+            const double alpha = 0.5;
+            const double beta = -2.0;
+
+            MatrixMultiplication::gemm(transposeA, transposeB, m, n, k,
+                                       alpha, a.data(), transposeA ? m : k, b.data(), transposeB ? k : n,
+                                       beta, c.data(), n);
+
+            for (int i = 0; i < m; i++)
+            {
+                for (int j = 0; j < n; j++)
+                {
+                    const double expected = alpha * referenceEntry(transposeA, transposeB, m, n, k, a, b, i, j) + beta * initialC[i * n + j];
+                    Assert::AreEqual(expected, c[i * n + j], 0.000001);
+                }
+            }
+        }
+
+        //------------------------------------
+        // gemm
+        //------------------------------------
+        TEST_METHOD(MatrixMultiplication_gemm_small)
+        {
+            // (2 x 3) * (3 x 2)
+            const std::vector<double> a({ 1, 2, 3, 4, 5, 6 });
+            const std::vector<double> b({ 7, 8, 9, 10, 11, 12 });
+            std::vector<double> c(4, 0.0);
+
+            MatrixMultiplication::gemm(false, false, 2, 2, 3, 1.0, a.data(), 3, b.data(), 2, 0.0, c.data(), 2);
+
+            Assert::AreEqual(58.0, c[0], 0.0001);
+            Assert::AreEqual(64.0, c[1], 0.0001);
+            Assert::AreEqual(139.0, c[2], 0.0001);
+            Assert::AreEqual(154.0, c[3], 0.0001);
+        }
+
+        TEST_METHOD(MatrixMultiplication_gemm_vector)
+        {
+            // matrix-vector products use the unblocked code path
+            compareWithReference(false, false, 37, 1, 19);
+            compareWithReference(true, false, 37, 1, 19);
+            compareWithReference(false, true, 1, 23, 41);
+        }
+
+        TEST_METHOD(MatrixMultiplication_gemm_blocked)
+        {
+            // sizes that aren't multiples of any block size, so all edge cases are covered
+            compareWithReference(false, false, 133, 67, 301);
+            compareWithReference(true, false, 133, 67, 301);
+            compareWithReference(false, true, 133, 67, 301);
+            compareWithReference(true, true, 133, 67, 301);
+        }
+
+        TEST_METHOD(MatrixMultiplication_gemm_betaZero)
+        {
+            // with beta = 0, previous content of C is ignored (even if it is not a number)
+            const std::vector<double> a({ 1, 2 });
+            const std::vector<double> b({ 3, 4 });
+            std::vector<double> c(1, NAN);
+
+            MatrixMultiplication::gemm(false, false, 1, 1, 2, 1.0, a.data(), 2, b.data(), 1, 0.0, c.data(), 1);
+            Assert::AreEqual(11.0, c[0], 0.0001);
+        }
+    };
+}
@@ -1,7 +1,10 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
+#include "General/ThreadPool.h"
 #include "NeuralNetwork/NodeNetwork.h"
 
+#include <cmath>
+
 namespace NodeNetworkTest
 {
     using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -532,5 +535,380 @@ namespace NodeNetworkTest
             // the error should improve over time
             Assert::AreEqual(true, secondIterationError < firstIterationError);
         }
+
+        //---------------------------------------
+        // Batched computation
+        //---------------------------------------
+        TEST_METHOD(NodeNetwork_computeValues_batch)
+        {
+            NetworkSizeData sizeData;
+            sizeData.numInputNodes = 3;
+            sizeData.numOutputNodes = 2;
+            sizeData.numHiddenNodes = { 4 };
+
+            std::shared_ptr<NodeNetwork> network = std::make_shared<NodeNetwork>();
+            network->createNetwork(sizeData, "tanh");
+
+            std::vector<double> params;
+            for (int k = 0; k < network->getNumParameters(); k++)
+            {
+                params.push_back(0.1 * (k % 7) - 0.3);
+            }
+            network->assignParameters(params);
+
+            const std::vector<std::vector<double>> inputValues({ { 0.5, -1.0, 0.25 }, { -0.75, 0.1, 1.0 }, { 0.0, 0.0, 0.0 } });
+
+            std::vector<std::vector<double>> batchOutputValues;
+            Assert::AreEqual(true, network->computeValues(inputValues, batchOutputValues));
+            Assert::AreEqual(3, static_cast<int>(batchOutputValues.size()));
+
+            // each sample has the same output as when computed on its own
+            for (unsigned int s = 0; s < inputValues.size(); s++)
+            {
+                network->assignInputValues(inputValues[s]);
+                network->computeValues();
+
+                std::vector<double> outputValues;
+                network->getOutputValues(outputValues);
+
+                Assert::AreEqual(2, static_cast<int>(batchOutputValues[s].size()));
+                Assert::AreEqual(outputValues[0], batchOutputValues[s][0], 0.000001);
+                Assert::AreEqual(outputValues[1], batchOutputValues[s][1], 0.000001);
+            }
+        }
+
+        TEST_METHOD(NodeNetwork_computeValues_batch_invalidInput)
+        {
+            NetworkSizeData sizeData;
+            sizeData.numInputNodes = 2;
+            sizeData.numOutputNodes = 1;
+
+            NodeNetwork nnet;
+            nnet.createNetwork(sizeData);
+
+            // second sample has too many values
+            std::vector<std::vector<double>> outputValues;
+            Assert::AreEqual(false, nnet.computeValues({ { 0.2, 0.3 }, { 0.1, 0.4, 0.5 } }, outputValues));
+        }
+
+        TEST_METHOD(NodeNetwork_handleBackpropagation_batch)
+        {
+            NetworkSizeData sizeData;
+            sizeData.numInputNodes = 2;
+            sizeData.numOutputNodes = 2;
+            sizeData.numHiddenNodes = { 3, 2 };
+
+            std::shared_ptr<NodeNetwork> network = std::make_shared<NodeNetwork>();
+            network->createNetwork(sizeData, "leakyrelu");
+
+            std::vector<double> params;
+            for (int k = 0; k < network->getNumParameters(); k++)
+            {
+                params.push_back(0.15 * (k % 5) - 0.2);
+            }
+            network->assignParameters(params);
+
+            const std::vector<std::vector<double>> inputValues({ { 0.5, 0.7 }, { -0.3, 1.2 } });
+            const std::vector<std::vector<double>> targetValues({ { -0.7, 0.345 }, { 0.2, 0.1 } });
+
+            // the batched adjustment values are the sum of the adjustment values of each sample
+            std::vector<double> summedAdjustments(network->getNumParameters(), 0.0);
+            for (unsigned int s = 0; s < inputValues.size(); s++)
+            {
+                network->assignInputValues(inputValues[s]);
+                network->computeValues();
+
+                std::vector<double> parameterAdjustments;
+                network->handleBackpropagation(targetValues[s], parameterAdjustments);
+
+                for (unsigned int k = 0; k < parameterAdjustments.size(); k++)
+                {
+                    summedAdjustments[k] += parameterAdjustments[k];
+                }
+            }
+
+            std::vector<std::vector<double>> outputValues;
+            network->computeValues(inputValues, outputValues);
+
+            std::vector<double> batchAdjustments;
+            network->handleBackpropagation(targetValues, batchAdjustments);
+
+            Assert::AreEqual(network->getNumParameters(), static_cast<int>(batchAdjustments.size()));
+            for (unsigned int k = 0; k < batchAdjustments.size(); k++)
+            {
+                Assert::AreEqual(summedAdjustments[k], batchAdjustments[k], 0.000001);
+            }
+        }
+
+        TEST_METHOD(NodeNetwork_setUseExactGradient)
+        {
+            NetworkSizeData sizeData;
+            sizeData.numInputNodes = 2;
+            sizeData.numOutputNodes = 2;
+            sizeData.numHiddenNodes = { 3, 2 };
+
+            std::shared_ptr<NodeNetwork> network = std::make_shared<NodeNetwork>();
+            network->createNetwork(sizeData, "sigmoid");
+            network->setUseExactGradient(true);
+
+            std::vector<double> params;
+            for (int k = 0; k < network->getNumParameters(); k++)
+            {
+                params.push_back(0.15 * (k % 5) - 0.2);
+            }
+
+            const std::vector<std::vector<double>> inputValues({ { 0.5, 0.7 }, { -0.3, 1.2 } });
+            const std::vector<std::vector<double>> targetValues({ { -0.7, 0.345 }, { 0.2, 0.1 } });
+
+            auto computeError = [&](const std::vector<double>& currentParams)
+            {
+                network->assignParameters(currentParams);
+
+                std::vector<std::vector<double>> outputValues;
+                network->computeValues(inputValues, outputValues);
+
+                double error = 0;
+                for (unsigned int s = 0; s < outputValues.size(); s++)
+                {
+                    for (unsigned int n = 0; n < outputValues[s].size(); n++)
+                    {
+                        error += (outputValues[s][n] - targetValues[s][n]) * (outputValues[s][n] - targetValues[s][n]);
+                    }
+                }
+
+                return error;
+            };
+
+            computeError(params);
+            std::vector<double> gradient;
+            network->handleBackpropagation(targetValues, gradient);
+
+            // compare with central differences
+            const double h = 1e-6;
+            for (unsigned int k = 0; k < params.size(); k++)
+            {
+                std::vector<double> shiftedParams(params);
+                shiftedParams[k] = params[k] + h;
+                const double upperError = computeError(shiftedParams);
+                shiftedParams[k] = params[k] - h;
+                const double lowerError = computeError(shiftedParams);
+
+                Assert::AreEqual((upperError - lowerError) / (2 * h), gradient[k], 1e-6);
+            }
+        }
+
+        TEST_METHOD(NodeNetwork_setUseApproximateActivation)
+        {
+            NetworkSizeData sizeData;
+            sizeData.numInputNodes = 4;
+            sizeData.numOutputNodes = 3;
+            sizeData.numHiddenNodes = { 5 };
+
+            NodeNetwork exactNetwork;
+            exactNetwork.createNetwork(sizeData, "sigmoid");
+
+            NodeNetwork approximateNetwork;
+            approximateNetwork.createNetwork(sizeData, "sigmoid");
+            approximateNetwork.setUseApproximateActivation(true);
+
+            std::vector<double> params;
+            for (int k = 0; k < exactNetwork.getNumParameters(); k++)
+            {
+                params.push_back(0.4 * (k % 9) - 1.5);
+            }
+            exactNetwork.assignParameters(params);
+            approximateNetwork.assignParameters(params);
+
+            exactNetwork.assignInputValues({ 1, -1, 0.5, 2 });
+            approximateNetwork.assignInputValues({ 1, -1, 0.5, 2 });
+            exactNetwork.computeValues();
+            approximateNetwork.computeValues();
+
+            // same decision, nearly the same values
+            std::vector<double> exactOutput;
+            std::vector<double> approximateOutput;
+            Assert::AreEqual(exactNetwork.getOutputValues(exactOutput), approximateNetwork.getOutputValues(approximateOutput));
+            for (unsigned int k = 0; k < exactOutput.size(); k++)
+            {
+                Assert::AreEqual(exactOutput[k], approximateOutput[k], 0.0001);
+            }
+        }
+
+        // -----------------------------------------
+        // Softmax cross entropy
+        // -----------------------------------------
+        TEST_METHOD(NodeNetwork_handleSoftMaxCrossEntropyBackpropagation)
+        {
+            // without hidden layers, the adjustment values are exactly the gradient of the loss
+            NetworkSizeData sizeData;
+            sizeData.numInputNodes = 3;
+            sizeData.numOutputNodes = 4;
+
+            NodeNetwork nnet;
+            nnet.createNetwork(sizeData);
+
+            std::vector<double> params;
+            for (int k = 0; k < nnet.getNumParameters(); k++)
+            {
+                params.push_back(0.3 * (k % 7) - 0.9);
+            }
+            nnet.assignParameters(params);
+            nnet.assignInputValues({ 0.5, -1.0, 2.0 });
+
+            const std::vector<double> targetValues({ 0.0, 0.5, 0.5, 0.0 });
+
+            std::vector<double> parameterAdjustments;
+            const double loss = nnet.handleSoftMaxCrossEntropyBackpropagation(targetValues, parameterAdjustments);
+            Assert::AreEqual(nnet.getSoftMaxCrossEntropyError(targetValues), loss, 0.000001);
+
+            // compare with central differences
+            const double delta = 0.00001;
+            for (unsigned int k = 0; k < params.size(); k++)
+            {
+                std::vector<double> changedParams = params;
+                changedParams[k] = params[k] + delta;
+                nnet.assignParameters(changedParams);
+                nnet.computeValues();
+                const double lossPlus = nnet.getSoftMaxCrossEntropyError(targetValues);
+
+                changedParams[k] = params[k] - delta;
+                nnet.assignParameters(changedParams);
+                nnet.computeValues();
+                const double lossMinus = nnet.getSoftMaxCrossEntropyError(targetValues);
+
+                Assert::AreEqual((lossPlus - lossMinus) / (2 * delta), parameterAdjustments[k], 0.0001);
+            }
+        }
+
+        TEST_METHOD(NodeNetwork_handleSoftMaxCrossEntropyBackpropagation_batch)
+        {
+            NetworkSizeData sizeData;
+            sizeData.numInputNodes = 2;
+            sizeData.numOutputNodes = 3;
+            sizeData.numHiddenNodes = { 4 };
+
+            NodeNetwork nnet;
+            nnet.createNetwork(sizeData, "tanh");
+
+            std::vector<double> params;
+            for (int k = 0; k < nnet.getNumParameters(); k++)
+            {
+                params.push_back(0.2 * (k % 5) - 0.3);
+            }
+            nnet.assignParameters(params);
+
+            const std::vector<std::vector<double>> inputValues({ { 0.5, 0.7 }, { -0.3, 1.2 }, { 1.0, 0.0 } });
+            const std::vector<std::vector<double>> targetValues({ { 1, 0, 0 }, { 0, 0.5, 0.5 }, { 0.2, 0.2, 0.6 } });
+
+            // the batched values are the sums of the values of each sample
+            double summedLoss = 0;
+            std::vector<double> summedAdjustments(nnet.getNumParameters(), 0.0);
+            for (unsigned int s = 0; s < inputValues.size(); s++)
+            {
+                nnet.assignInputValues(inputValues[s]);
+
+                std::vector<double> parameterAdjustments;
+                summedLoss += nnet.handleSoftMaxCrossEntropyBackpropagation(targetValues[s], parameterAdjustments);
+
+                for (unsigned int k = 0; k < parameterAdjustments.size(); k++)
+                {
+                    summedAdjustments[k] += parameterAdjustments[k];
+                }
+            }
+
+            std::vector<std::vector<double>> outputValues;
+            nnet.computeValues(inputValues, outputValues);
+
+            std::vector<double> batchAdjustments;
+            const double batchLoss = nnet.handleSoftMaxCrossEntropyBackpropagation(targetValues, batchAdjustments);
+
+            Assert::AreEqual(summedLoss, batchLoss, 0.000001);
+            Assert::AreEqual(nnet.getNumParameters(), static_cast<int>(batchAdjustments.size()));
+            for (unsigned int k = 0; k < batchAdjustments.size(); k++)
+            {
+                Assert::AreEqual(summedAdjustments[k], batchAdjustments[k], 0.000001);
+            }
+        }
+
+        TEST_METHOD(NodeNetwork_getOutputValues_softMaxLargeValues)
+        {
+            NetworkSizeData sizeData;
+            sizeData.numInputNodes = 1;
+            sizeData.numOutputNodes = 2;
+
+            NodeNetwork nnet;
+            nnet.createNetwork(sizeData);
+
+            // outputs are 1000 and 1001, which would overflow exp
+            nnet.assignParameters({ 1000, 0, 1000, 1 });
+            nnet.assignInputValues({ 1 });
+            nnet.computeValues();
+
+            std::vector<double> outputValues;
+            Assert::AreEqual(1, nnet.getOutputValues(outputValues, true));
+            Assert::AreEqual(1 / (1 + std::exp(1)), outputValues[0], 0.000001);
+            Assert::AreEqual(std::exp(1) / (1 + std::exp(1)), outputValues[1], 0.000001);
+        }
+
+        // -----------------------------------------
+        // Intra-layer parallelism
+        // -----------------------------------------
+        TEST_METHOD(NodeNetwork_setThreadPool)
+        {
+            NetworkSizeData sizeData;
+            sizeData.numInputNodes = 18;
+            sizeData.numOutputNodes = 9;
+            sizeData.numHiddenNodes = { 150, 70 };
+
+            NodeNetwork serialNetwork;
+            serialNetwork.createNetwork(sizeData, "tanh");
+
+            NodeNetwork parallelNetwork;
+            parallelNetwork.createNetwork(sizeData, "tanh");
+            parallelNetwork.setThreadPool(std::make_shared<General::ThreadPool>(4), 64);
+
+            std::vector<double> params;
+            for (int k = 0; k < serialNetwork.getNumParameters(); k++)
+            {
+                params.push_back(0.01 * (k % 13) - 0.06);
+            }
+            serialNetwork.assignParameters(params);
+            parallelNetwork.assignParameters(params);
+
+            std::vector<double> inputValues;
+            for (int k = 0; k < sizeData.numInputNodes; k++)
+            {
+                inputValues.push_back((k % 3) - 1.0);
+            }
+            serialNetwork.assignInputValues(inputValues);
+            parallelNetwork.assignInputValues(inputValues);
+
+            // splitting the wide layers between threads doesn't change the results
+            serialNetwork.computeValues();
+            parallelNetwork.computeValues();
+
+            std::vector<double> serialOutput;
+            std::vector<double> parallelOutput;
+            serialNetwork.getOutputValues(serialOutput);
+            parallelNetwork.getOutputValues(parallelOutput);
+
+            Assert::AreEqual(static_cast<int>(serialOutput.size()), static_cast<int>(parallelOutput.size()));
+            for (unsigned int k = 0; k < serialOutput.size(); k++)
+            {
+                Assert::AreEqual(serialOutput[k], parallelOutput[k], 0.000001);
+            }
+
+            const std::vector<double> targetValues({ 1, 0, 0, 0, 0, 0, 0, 0, 0 });
+            std::vector<double> serialAdjustments;
+            std::vector<double> parallelAdjustments;
+            serialNetwork.handleBackpropagation(targetValues, serialAdjustments);
+            parallelNetwork.handleBackpropagation(targetValues, parallelAdjustments);
+
+            Assert::AreEqual(static_cast<int>(serialAdjustments.size()), static_cast<int>(parallelAdjustments.size()));
+            for (unsigned int k = 0; k < serialAdjustments.size(); k++)
+            {
+                Assert::AreEqual(serialAdjustments[k], parallelAdjustments[k], 0.000001);
+            }
+        }
     };
 }
\ No newline at end of file
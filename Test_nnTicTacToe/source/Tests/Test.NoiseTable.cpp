@@ -0,0 +1,105 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Math/NoiseTable.h"
+
+#include <vector>
+
+namespace NoiseTableTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Math;
+
+    TEST_CLASS(NoiseTable_Test)
+    {
+    public:
+        TEST_METHOD(NoiseTable_create)
+        {
+            const int size = 100000;
+
+            NoiseTable table;
+            RandomGenerator generator(1);
+            table.create(generator, size);
+            Assert::AreEqual(size, table.size());
+
+            double mean = 0;
+            double variance = 0;
+            for (int k = 0; k < size; k++)
+            {
+                mean += table.getSlice(k)[0];
+            }
+
+            mean /= size;
+            for (int k = 0; k < size; k++)
+            {
+                variance += (table.getSlice(k)[0] - mean) * (table.getSlice(k)[0] - mean);
+            }
+
+            variance /= size;
+
+            Assert::AreEqual(0.0, mean, 0.02);
+            Assert::AreEqual(1.0, variance, 0.02);
+        }
+
+        TEST_METHOD(NoiseTable_create_reproducible)
+        {
+            NoiseTable table1;
+            NoiseTable table2;
+            RandomGenerator generator1(2);
+            RandomGenerator generator2(2);
+            table1.create(generator1, 50);
+            table2.create(generator2, 50);
+
+            for (int k = 0; k < 50; k++)
+            {
+                Assert::AreEqual(table1.getSlice(0)[k], table2.getSlice(0)[k]);
+            }
+        }
+
+        TEST_METHOD(NoiseTable_sampleOffset)
+        {
+            NoiseTable table;
+            RandomGenerator generator(3);
+            table.create(generator, 20);
+
+            bool foundLastOffset = false;
+            for (int k = 0; k < 1000; k++)
+            {
+                const int offset = table.sampleOffset(generator, 16);
+                Assert::AreEqual(true, offset >= 0 && offset <= 4);
+                foundLastOffset |= (offset == 4);
+            }
+
+            Assert::AreEqual(true, foundLastOffset);
+
+            // a slice covering the whole table can only start at the beginning
+            Assert::AreEqual(0, table.sampleOffset(generator, 20));
+        }
+
+        TEST_METHOD(NoiseTable_addWeightedSum)
+        {
+            const int sliceLength = 37;
+
+            NoiseTable table;
+            RandomGenerator generator(4);
+            table.create(generator, 1000);
+
+            // one full pass of four slices plus three remaining ones
+            const std::vector<int> offsets({ 0, 900, 17, 17, 500, 3, 963 });
+            const std::vector<double> weights({ 0.5, -1, 2, 0.25, -0.75, 1, 0 });
+
+            std::vector<double> result(sliceLength, 1.0);
+            table.addWeightedSum(offsets, weights, sliceLength, result.data());
+
+            for (int k = 0; k < sliceLength; k++)
+            {
+                double expected = 1.0;
+                for (size_t i = 0; i < offsets.size(); i++)
+                {
+                    expected += weights[i] * table.getSlice(offsets[i])[k];
+                }
+
+                Assert::AreEqual(expected, result[k], 0.000001);
+            }
+        }
+    };
+}
@@ -2,6 +2,7 @@
 #include "CppUnitTest.h"
 #include "NeuralNetwork/ParameterManager.h"
 
+#include <algorithm>
 #include <set>
 
 namespace ParameterManagerTest
@@ -69,6 +70,50 @@ namespace ParameterManagerTest
             Assert::AreEqual(-1.3, pset2.params[1], 0.0001);
         }
 
+        TEST_METHOD(ParameterManager_getParameters)
+        {
+            ParameterManagerData data;
+            data.numParams = 2;
+
+            ParameterManager pm(data);
+
+            ParamSet pset;
+            pset.score = 12.5;
+            pset.error = 0.3;
+            pset.params = std::vector<double>({ 0.8, -1.3 });
+            const int id = pm.addNewParamSet(pset);
+
+            const ParameterView params = pm.getParameters(id);
+            Assert::AreEqual(2, params.size());
+            Assert::AreEqual(0.8, params[0], 0.0001);
+            Assert::AreEqual(-1.3, params[1], 0.0001);
+            Assert::AreEqual(12.5, pm.getScore(id), 0.0001);
+            Assert::AreEqual(0.3, pm.getError(id), 0.0001);
+
+            pm.setScore(id, 20);
+            pm.setError(id, 0.1);
+            Assert::AreEqual(20.0, pm.getScore(id), 0.0001);
+            Assert::AreEqual(0.1, pm.getError(id), 0.0001);
+
+            // a child of the first set (only stored as differences for larger sets) reads the same either way
+            ParamSet child = pset;
+            child.params[1] = 0.5;
+            const int childId = pm.addNewParamSet(child, id);
+
+            std::vector<double> childParams;
+            Assert::AreEqual(true, pm.copyParameters(childId, childParams));
+            Assert::AreEqual(2, static_cast<int>(childParams.size()));
+            Assert::AreEqual(0.8, childParams[0], 0.0001);
+            Assert::AreEqual(0.5, childParams[1], 0.0001);
+            Assert::AreEqual(0.5, pm.getParameters(childId)[1], 0.0001);
+
+            // invalid id
+            Assert::AreEqual(false, pm.copyParameters(childId + 1, childParams));
+            Assert::AreEqual(true, pm.getParameters(childId + 1).empty());
+            Assert::AreEqual(0.0, pm.getScore(childId + 1), 0.0001);
+            Assert::AreEqual(-1.0, pm.getError(childId + 1), 0.0001);
+        }
+
         TEST_METHOD(ParameterManager_getParameterSetIds)
         {
             ParameterManagerData data;
@@ -142,6 +187,103 @@ namespace ParameterManagerTest
             Assert::AreEqual(5.0, bestSet.params[2], 0.0001);
         }
 
+        TEST_METHOD(ParameterManager_getBestParameterSetIds)
+        {
+            ParameterManagerData data;
+            data.numParams = 1;
+
+            ParameterManager pm(data);
+
+            for (int k = 0; k < 5; k++)
+            {
+                ParamSet pset;
+                pset.score = k;
+                pset.params = std::vector<double>({ 0.0 });
+                pm.addNewParamSet(pset);
+            }
+
+            // ranking follows score changes and deactivated sets drop out
+            pm.setScore(0, 10);
+            pm.setParameterSetActive(4, false);
+            pm.removeParameterSetForId(3);
+
+            std::vector<int> bestIds;
+            pm.getBestParameterSetIds(2, bestIds);
+            Assert::AreEqual(2, static_cast<int>(bestIds.size()));
+            Assert::AreEqual(0, bestIds[0]);
+            Assert::AreEqual(2, bestIds[1]);
+            Assert::AreEqual(0, pm.getBestParameterSetId());
+
+            pm.setParameterSetActive(4, true);
+            pm.getParameterSetIdsSortedByScore(bestIds);
+            Assert::AreEqual(4, static_cast<int>(bestIds.size()));
+            Assert::AreEqual(0, bestIds[0]);
+            Assert::AreEqual(4, bestIds[1]);
+            Assert::AreEqual(2, bestIds[2]);
+            Assert::AreEqual(1, bestIds[3]);
+        }
+
+        TEST_METHOD(ParameterManager_evictRetiredParameterSets)
+        {
+            ParameterManagerData data;
+            data.numParams = 2;
+            data.hallOfFameSize = 2;
+
+            ParameterManager pm(data);
+
+            // scores 1, 5, 3, 5, 2, 4 for ids 0 to 5; ids 0 to 3 are retired
+            const std::vector<double> scores({ 1, 5, 3, 5, 2, 4 });
+            for (size_t k = 0; k < scores.size(); k++)
+            {
+                ParamSet pset;
+                pset.score = scores[k];
+                pset.params = std::vector<double>({ 0.1 * k, 0.2 });
+                pset.active = k >= 4;
+                pm.addNewParamSet(pset);
+            }
+
+            Assert::AreEqual(2, pm.evictRetiredParameterSets());
+
+            // the two best retired sets are kept, active sets are never removed
+            Assert::AreEqual(false, pm.hasParameterSet(0));
+            Assert::AreEqual(true, pm.hasParameterSet(1));
+            Assert::AreEqual(false, pm.hasParameterSet(2));
+            Assert::AreEqual(true, pm.hasParameterSet(3));
+            Assert::AreEqual(true, pm.hasParameterSet(4));
+            Assert::AreEqual(true, pm.hasParameterSet(5));
+
+            // the best active set is still found
+            Assert::AreEqual(5, pm.getBestParameterSetId());
+
+            // nothing left to remove
+            Assert::AreEqual(0, pm.evictRetiredParameterSets());
+
+            // on a tie, the older set stays
+            pm.setParameterSetActive(4, false);
+            pm.setScore(4, 5);
+            Assert::AreEqual(1, pm.evictRetiredParameterSets());
+            Assert::AreEqual(false, pm.hasParameterSet(4));
+        }
+
+        TEST_METHOD(ParameterManager_evictRetiredParameterSets_unbounded)
+        {
+            ParameterManagerData data;
+            data.numParams = 2;
+
+            ParameterManager pm(data);
+
+            ParamSet pset;
+            pset.params = std::vector<double>({ 0.1, 0.2 });
+            pset.active = false;
+            pm.addNewParamSet(pset);
+            pm.addNewParamSet(pset);
+
+            // the default keeps everything
+            Assert::AreEqual(0, pm.evictRetiredParameterSets());
+            Assert::AreEqual(true, pm.hasParameterSet(0));
+            Assert::AreEqual(true, pm.hasParameterSet(1));
+        }
+
         TEST_METHOD(ParameterManager_fillParameterSetProbabilityMap)
         {
             ParameterManagerData data;
@@ -582,5 +724,192 @@ namespace ParameterManagerTest
                 Assert::AreEqual(true, pset.params[1] >= 0 && pset.params[1] <= 5 || pset.params[1] >= -6 && pset.params[1] <= -2);
             }
         }
+
+        TEST_METHOD(ParameterManager_evolveParameterSets_halfPrecision)
+        {
+            ParameterManagerData data;
+            data.numParamSets = 6;
+            data.numParams = 3;
+            data.precision = PP_FLOAT16;
+
+            ParameterManager pm(data);
+
+            for (int k = 0; k < data.numParamSets; k++)
+            {
+                ParamSet pset;
+                pset.score = k + 1;
+                pset.params = std::vector<double>(3, 0.25 * k);
+                pm.addNewParamSet(pset);
+            }
+
+            // reading whole sets or creating children from them doesn't keep widened copies around
+            ParamSet pset;
+            Assert::AreEqual(true, pm.getParamSetForId(1, pset));
+            Assert::AreEqual(true, pm.createMutatedParameterSet(2, pset));
+            Assert::AreEqual(true, pm.createCrossoverParameterSet(3, 4, pset));
+            Assert::AreEqual(0, pm.getNumMaterializedSets());
+
+            // views need a cached copy
+            Assert::AreEqual(3, pm.getParameters(5).size());
+            Assert::AreEqual(1, pm.getNumMaterializedSets());
+
+            std::vector<int> newParameterSetIds;
+            Assert::AreEqual(true, pm.evolveParameterSets(newParameterSetIds));
+            Assert::AreEqual(data.numParamSets, static_cast<int>(newParameterSetIds.size()));
+            Assert::AreEqual(0, pm.getNumMaterializedSets());
+
+            // the children are stored with the reduced precision as well
+            for (auto id : newParameterSetIds)
+            {
+                Assert::AreEqual(true, pm.getParamSetForId(id, pset));
+                Assert::AreEqual(3, static_cast<int>(pset.params.size()));
+            }
+            Assert::AreEqual(0, pm.getNumMaterializedSets());
+        }
+
+        TEST_METHOD(ParameterManager_retireWorstParameterSet)
+        {
+            ParameterManagerData data;
+            data.numParamSets = 3;
+            data.numParams = 2;
+
+            ParameterManager pm(data);
+
+            const std::vector<double> scores({ 5, 10, 2 });
+            for (auto score : scores)
+            {
+                ParamSet pset;
+                pset.score = score;
+                pset.params = { 1, 2 };
+                pm.addNewParamSet(pset);
+            }
+
+            // the population isn't larger than numParamSets yet
+            Assert::AreEqual(-1, pm.retireWorstParameterSet(2));
+
+            // a child that doesn't beat the worst member is disabled itself
+            ParamSet child;
+            child.params = { 3, 4 };
+            const int weakId = pm.addNewParamSet(child);
+            Assert::AreEqual(-1, pm.retireWorstParameterSet(weakId));
+            pm.setScore(weakId, 1);
+            Assert::AreEqual(weakId, pm.retireWorstParameterSet(weakId));
+
+            // a better child replaces the worst member
+            const int strongId = pm.addNewParamSet(child);
+            pm.setScore(strongId, 3);
+            Assert::AreEqual(2, pm.retireWorstParameterSet(strongId));
+
+            std::vector<int> activeIds;
+            pm.getActiveParameterSetIds(activeIds);
+            Assert::AreEqual(3, static_cast<int>(activeIds.size()));
+            Assert::AreEqual(true, std::find(activeIds.begin(), activeIds.end(), strongId) != activeIds.end());
+        }
+
+        TEST_METHOD(ParameterManager_addOffspringParameterSet)
+        {
+            ParameterManagerData data;
+            data.numParamSets = 6;
+            data.numParams = 2;
+            data.minRandomParamValue = 0;
+            data.maxRandomParamValue = 5;
+            data.numBestSetsKeptDuringEvolution = 1;
+            data.numBestSetsMutatedDuringEvolution = 2;
+            data.numAddedRandomSetsDuringEvolution = 1;
+
+            ParameterManager pm(data);
+
+            for (int k = 0; k < data.numParamSets; k++)
+            {
+                ParamSet pset;
+                pset.score = k + 1;
+                pset.params = std::vector<double>(2, k);
+                pm.addNewParamSet(pset);
+            }
+
+            // several rounds of adding, scoring and retiring keep the population size
+            for (int round = 0; round < 50; round++)
+            {
+                const int childId = pm.addOffspringParameterSet();
+                Assert::AreEqual(true, childId >= 0);
+                Assert::AreEqual(false, pm.isEvaluated(childId));
+
+                ParamSet child;
+                pm.getParamSetForId(childId, child);
+                Assert::AreEqual(2, static_cast<int>(child.params.size()));
+
+                pm.setScore(childId, round % 10);
+                pm.retireWorstParameterSet(childId);
+
+                std::vector<int> activeIds;
+                pm.getActiveParameterSetIds(activeIds);
+                const auto numEvaluated = std::count_if(activeIds.begin(), activeIds.end(), [&pm](int id) { return pm.isEvaluated(id); });
+                Assert::AreEqual(data.numParamSets, static_cast<int>(numEvaluated));
+                Assert::AreEqual(data.numParamSets, static_cast<int>(activeIds.size()));
+            }
+
+            // the scores of the population only improve
+            std::vector<int> bestIds;
+            pm.getParameterSetIdsSortedByScore(bestIds);
+            Assert::AreEqual(9.0, pm.getScore(bestIds.front()), 0.0001);
+            Assert::AreEqual(true, pm.getScore(bestIds.back()) >= 1);
+        }
+
+        TEST_METHOD(ParameterManager_addOffspringParameterSet_tooFewEvaluated)
+        {
+            ParameterManagerData data;
+            data.numParams = 2;
+
+            ParameterManager pm(data);
+
+            ParamSet evaluated;
+            evaluated.score = 3;
+            evaluated.params = { 1, 2 };
+            pm.addNewParamSet(evaluated);
+
+            ParamSet unevaluated;
+            unevaluated.params = { 3, 4 };
+            pm.addNewParamSet(unevaluated);
+
+            Assert::AreEqual(-1, pm.addOffspringParameterSet());
+
+            std::vector<int> activeIds;
+            pm.getActiveParameterSetIds(activeIds);
+            Assert::AreEqual(2, static_cast<int>(activeIds.size()));
+        }
+
+        TEST_METHOD(ParameterManager_isEvaluated)
+        {
+            ParameterManagerData data;
+            data.numParams = 2;
+
+            ParameterManager pm(data);
+
+            ParamSet pset;
+            pset.params = { 1, 2 };
+            const int newId = pm.addNewParamSet(pset);
+
+            pset.score = 4;
+            const int scoredId = pm.addNewParamSet(pset);
+
+            Assert::AreEqual(false, pm.isEvaluated(newId));
+            Assert::AreEqual(true, pm.isEvaluated(scoredId));
+            Assert::AreEqual(false, pm.isEvaluated(17));
+
+            // a score of 0 is a valid result as well
+            pm.setScore(newId, 0);
+            Assert::AreEqual(true, pm.isEvaluated(newId));
+
+            ParamSet copy;
+            pm.getParamSetForId(newId, copy);
+            Assert::AreEqual(true, copy.evaluated);
+
+            // also kept when another set moves into a freed slot
+            pm.removeParameterSetForId(newId);
+            pset.score = 0;
+            const int lastId = pm.addNewParamSet(pset);
+            pm.removeParameterSetForId(scoredId);
+            Assert::AreEqual(false, pm.isEvaluated(lastId));
+        }
     };
 }
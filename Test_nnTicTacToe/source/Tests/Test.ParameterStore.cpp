@@ -0,0 +1,363 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "NeuralNetwork/ParameterStore.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace ParameterStoreTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace NeuralNetwork;
+
+    TEST_CLASS(ParameterStore_Test)
+    {
+    public:
+        // -----------------------------------------
+        // ParameterStore
+        // -----------------------------------------
+        TEST_METHOD(ParameterStore_addParamSet)
+        {
+            ParameterStore store;
+
+            ParamSet pset;
+            pset.score = 3.5;
+            pset.error = 0.25;
+            pset.active = false;
+            pset.params = std::vector<double>({ 1, 2, 3 });
+            store.addParamSet(7, pset);
+
+            Assert::AreEqual(1, store.getNumParamSets());
+            Assert::AreEqual(true, store.contains(7));
+            Assert::AreEqual(false, store.contains(0));
+            Assert::AreEqual(-1, store.getSlot(100));
+
+            const int slot = store.getSlot(7);
+            const ParamSetInfo& info = store.getInfo(slot);
+            Assert::AreEqual(7, info.id);
+            Assert::AreEqual(3.5, info.score, 0.0001);
+            Assert::AreEqual(0.25, info.error, 0.0001);
+            Assert::AreEqual(false, info.active);
+
+            const ParameterView params = store.getParameters(slot);
+            Assert::AreEqual(3, params.size());
+            Assert::AreEqual(1.0, params[0], 0.0001);
+            Assert::AreEqual(2.0, params[1], 0.0001);
+            Assert::AreEqual(3.0, params[2], 0.0001);
+        }
+
+        TEST_METHOD(ParameterStore_alignedRows)
+        {
+            ParameterStore store;
+
+            // sets of different sizes force the matrix to grow in both directions
+            for (int k = 0; k < 40; k++)
+            {
+                ParamSet pset;
+                pset.params = std::vector<double>(k + 1, static_cast<double>(k));
+                store.addParamSet(k, pset);
+            }
+
+            for (int k = 0; k < 40; k++)
+            {
+                const ParameterView params = store.getParameters(store.getSlot(k));
+                Assert::AreEqual(k + 1, params.size());
+                Assert::AreEqual(static_cast<double>(k), params[0], 0.0001);
+                Assert::AreEqual(static_cast<double>(k), params[k], 0.0001);
+
+                // every set starts at a cache line
+                Assert::AreEqual(0, static_cast<int>(reinterpret_cast<uintptr_t>(params.data()) % 64));
+            }
+        }
+
+        TEST_METHOD(ParameterStore_removeParamSet)
+        {
+            ParameterStore store;
+
+            for (int k = 0; k < 3; k++)
+            {
+                ParamSet pset;
+                pset.score = k;
+                pset.params = std::vector<double>({ k * 10.0, k * 10.0 + 1 });
+                store.addParamSet(k, pset);
+            }
+
+            Assert::AreEqual(true, store.removeParamSet(0));
+            Assert::AreEqual(false, store.removeParamSet(0));
+            Assert::AreEqual(2, store.getNumParamSets());
+            Assert::AreEqual(false, store.contains(0));
+
+            // the remaining sets are unchanged, even though the last one moved into the free slot
+            for (int k = 1; k < 3; k++)
+            {
+                const int slot = store.getSlot(k);
+                Assert::AreEqual(true, slot >= 0 && slot < 2);
+                Assert::AreEqual(k, store.getInfo(slot).id);
+                Assert::AreEqual(static_cast<double>(k), store.getInfo(slot).score, 0.0001);
+
+                const ParameterView params = store.getParameters(slot);
+                Assert::AreEqual(2, params.size());
+                Assert::AreEqual(k * 10.0, params[0], 0.0001);
+                Assert::AreEqual(k * 10.0 + 1, params[1], 0.0001);
+            }
+        }
+
+        TEST_METHOD(ParameterStore_perSetArrays)
+        {
+            ParameterStore store;
+            for (int k = 0; k < 5; k++)
+            {
+                ParamSet pset;
+                pset.score = 10.0 * k;
+                pset.error = k;
+                pset.active = (k % 2) == 0;
+                pset.params = std::vector<double>(3, static_cast<double>(k));
+                store.addParamSet(k, pset);
+            }
+
+            // the last set moves into the freed slot, together with all its values
+            store.removeParamSet(1);
+            store.setScore(store.getSlot(3), 35);
+            store.setActive(store.getSlot(3), true);
+
+            Assert::AreEqual(4, store.getNumParamSets());
+            for (int slot = 0; slot < store.getNumParamSets(); slot++)
+            {
+                const int id = store.getIds()[slot];
+                Assert::AreEqual(slot, store.getSlot(id));
+                Assert::AreEqual(id == 3 ? 35.0 : 10.0 * id, store.getScores()[slot]);
+                Assert::AreEqual(static_cast<double>(id), store.getError(slot));
+                Assert::AreEqual(static_cast<int>(id % 2 == 0 || id == 3), static_cast<int>(store.getActiveFlags()[slot]));
+                Assert::AreEqual(3, store.getNumParams(slot));
+                Assert::AreEqual(static_cast<double>(id), store.getParameters(slot)[2]);
+            }
+        }
+
+        TEST_METHOD(ParameterStore_setParameters)
+        {
+            ParameterStore store;
+
+            ParamSet pset;
+            pset.params = std::vector<double>({ 1, 2 });
+            store.addParamSet(0, pset);
+            store.addParamSet(1, pset);
+
+            // longer than any row so far
+            store.setParameters(store.getSlot(1), std::vector<double>(20, 5.0));
+
+            const ParameterView params0 = store.getParameters(store.getSlot(0));
+            Assert::AreEqual(2, params0.size());
+            Assert::AreEqual(2.0, params0[1], 0.0001);
+
+            const ParameterView params1 = store.getParameters(store.getSlot(1));
+            Assert::AreEqual(20, params1.size());
+            Assert::AreEqual(5.0, params1[19], 0.0001);
+        }
+
+        TEST_METHOD(ParameterStore_emptyParamSet)
+        {
+            ParameterStore store;
+
+            ParamSet pset;
+            pset.params = std::vector<double>({ 1, 2 });
+            store.addParamSet(0, pset);
+            store.addParamSet(1, ParamSet());
+
+            const int slot = store.getSlot(1);
+            Assert::AreEqual(0, store.getInfo(slot).numParams);
+            Assert::AreEqual(true, store.getParameters(slot).empty());
+
+            // values can still be assigned later on
+            store.setParameters(slot, std::vector<double>({ 3, 4 }));
+            Assert::AreEqual(4.0, store.getParameters(slot)[1], 0.0001);
+            Assert::AreEqual(2.0, store.getParameters(store.getSlot(0))[1], 0.0001);
+
+            Assert::AreEqual(true, store.removeParamSet(1));
+            Assert::AreEqual(1, store.getNumParamSets());
+        }
+
+        TEST_METHOD(ParameterStore_addParamSet_differences)
+        {
+            ParameterStore store;
+
+            ParamSet parent;
+            parent.params = std::vector<double>(100, 1.0);
+            store.addParamSet(0, parent);
+
+            // few changes: stored as differences
+            ParamSet child = parent;
+            child.params[3] = 5;
+            child.params[70] = -2;
+            Assert::AreEqual(true, store.addParamSet(1, child, 0));
+            Assert::AreEqual(2, store.getNumStoredDifferences());
+            Assert::AreEqual(0, store.getInfo(store.getSlot(1)).parentId);
+            Assert::AreEqual(1, store.getInfo(store.getSlot(0)).numDependents);
+
+            // too many changes: full copy
+            ParamSet other(parent);
+            std::fill(other.params.begin(), other.params.begin() + 50, 3.0);
+            Assert::AreEqual(false, store.addParamSet(2, other, 0));
+            Assert::AreEqual(-1, store.getInfo(store.getSlot(2)).parentId);
+
+            const ParameterView params = store.getParameters(store.getSlot(1));
+            Assert::AreEqual(100, params.size());
+            Assert::AreEqual(1.0, params[0], 0.0001);
+            Assert::AreEqual(5.0, params[3], 0.0001);
+            Assert::AreEqual(-2.0, params[70], 0.0001);
+
+            std::vector<double> copied(100);
+            store.copyParameters(store.getSlot(1), copied.data());
+            Assert::AreEqual(true, std::equal(copied.begin(), copied.end(), params.begin()));
+        }
+
+        TEST_METHOD(ParameterStore_differences_depth)
+        {
+            ParameterStore store;
+
+            ParamSet pset;
+            pset.params = std::vector<double>(100, 0.0);
+            store.addParamSet(0, pset);
+
+            // each set changes one more value of its predecessor, until the chain is flattened
+            int numStoredAsDifferences = 0;
+            for (int id = 1; id < 10; id++)
+            {
+                pset.params[id] = id;
+                if (store.addParamSet(id, pset, id - 1))
+                {
+                    numStoredAsDifferences++;
+                }
+            }
+
+            Assert::AreEqual(true, numStoredAsDifferences > 0 && numStoredAsDifferences < 9);
+            for (int id = 0; id < 10; id++)
+            {
+                Assert::AreEqual(true, store.getInfo(store.getSlot(id)).depth <= 4);
+
+                const ParameterView params = store.getParameters(store.getSlot(id));
+                for (int k = 1; k < 10; k++)
+                {
+                    Assert::AreEqual(k <= id ? k : 0.0, params[k], 0.0001);
+                }
+            }
+        }
+
+        TEST_METHOD(ParameterStore_removeParent)
+        {
+            ParameterStore store;
+
+            ParamSet parent;
+            parent.params = std::vector<double>(40, 2.0);
+            store.addParamSet(0, parent);
+
+            ParamSet child = parent;
+            child.params[5] = 7;
+            Assert::AreEqual(true, store.addParamSet(1, child, 0));
+
+            // the child keeps its values
+            Assert::AreEqual(true, store.removeParamSet(0));
+            Assert::AreEqual(0, store.getNumStoredDifferences());
+            Assert::AreEqual(-1, store.getInfo(store.getSlot(1)).parentId);
+
+            const ParameterView params = store.getParameters(store.getSlot(1));
+            Assert::AreEqual(2.0, params[4], 0.0001);
+            Assert::AreEqual(7.0, params[5], 0.0001);
+        }
+
+        TEST_METHOD(ParameterStore_setParameters_parent)
+        {
+            ParameterStore store;
+
+            ParamSet parent;
+            parent.params = std::vector<double>(40, 2.0);
+            store.addParamSet(0, parent);
+
+            ParamSet child = parent;
+            child.params[5] = 7;
+            store.addParamSet(1, child, 0);
+
+            // changing the parent doesn't change the child
+            store.setParameters(store.getSlot(0), std::vector<double>(40, -1.0));
+
+            const ParameterView params = store.getParameters(store.getSlot(1));
+            Assert::AreEqual(2.0, params[4], 0.0001);
+            Assert::AreEqual(7.0, params[5], 0.0001);
+            Assert::AreEqual(-1.0, store.getParameters(store.getSlot(0))[5], 0.0001);
+        }
+
+        TEST_METHOD(ParameterStore_halfPrecision)
+        {
+            ParameterStore store;
+            store.setPrecision(PP_FLOAT16);
+            Assert::AreEqual(static_cast<int>(PP_FLOAT16), static_cast<int>(store.getPrecision()));
+
+            // 1/3 isn't representable, 0.75 is
+            ParamSet pset;
+            pset.params = std::vector<double>({ 0.75, 1.0 / 3, -2 });
+            store.addParamSet(0, pset);
+
+            const double rounded = store.roundToPrecision(1.0 / 3);
+            Assert::AreNotEqual(1.0 / 3, rounded);
+            Assert::AreEqual(1.0 / 3, rounded, 0.001);
+
+            const ParameterView params = store.getParameters(store.getSlot(0));
+            Assert::AreEqual(3, params.size());
+            Assert::AreEqual(0.75, params[0]);
+            Assert::AreEqual(rounded, params[1]);
+            Assert::AreEqual(-2.0, params[2]);
+
+            std::vector<double> copied(3);
+            store.copyParameters(store.getSlot(0), copied.data());
+            Assert::AreEqual(rounded, copied[1]);
+
+            // the cached values follow changes
+            store.setParameters(store.getSlot(0), std::vector<double>({ 4, 5, 6 }));
+            Assert::AreEqual(5.0, store.getParameters(store.getSlot(0))[1]);
+        }
+
+        TEST_METHOD(ParameterStore_halfPrecision_differences)
+        {
+            ParameterStore store;
+            store.setPrecision(PP_BFLOAT16);
+
+            ParamSet parent;
+            for (int k = 0; k < 40; k++)
+            {
+                parent.params.push_back(k * 0.1);
+            }
+
+            store.addParamSet(0, parent);
+
+            // a child created from the rounded values of its parent only differs where it was changed
+            const ParameterView parentParams = store.getParameters(store.getSlot(0));
+            ParamSet child;
+            child.params.assign(parentParams.begin(), parentParams.end());
+            child.params[3] = 0.123;
+            Assert::AreEqual(true, store.addParamSet(1, child, 0));
+            Assert::AreEqual(1, store.getNumStoredDifferences());
+
+            const ParameterView params = store.getParameters(store.getSlot(1));
+            Assert::AreEqual(store.roundToPrecision(0.123), params[3]);
+            Assert::AreEqual(store.roundToPrecision(0.4), params[4]);
+
+            // flattening keeps the values
+            store.removeParamSet(0);
+            store.releaseMaterializedSets();
+            Assert::AreEqual(store.roundToPrecision(0.123), store.getParameters(store.getSlot(1))[3]);
+            Assert::AreEqual(store.roundToPrecision(3.9), store.getParameters(store.getSlot(1))[39]);
+        }
+
+        TEST_METHOD(ParameterStore_parsePrecision)
+        {
+            ParameterPrecision precision = PP_DOUBLE;
+            Assert::AreEqual(true, ParameterStore::parsePrecision("bfloat16", precision));
+            Assert::AreEqual(static_cast<int>(PP_BFLOAT16), static_cast<int>(precision));
+            Assert::AreEqual(true, ParameterStore::parsePrecision("float16", precision));
+            Assert::AreEqual(static_cast<int>(PP_FLOAT16), static_cast<int>(precision));
+
+            // unknown names leave the value unchanged
+            Assert::AreEqual(false, ParameterStore::parsePrecision("float8", precision));
+            Assert::AreEqual(static_cast<int>(PP_FLOAT16), static_cast<int>(precision));
+        }
+    };
+}
@@ -0,0 +1,110 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "NeuralNetwork/ParentSampler.h"
+
+#include <map>
+
+namespace ParentSamplerTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace NeuralNetwork;
+
+    const int NUM_DRAWS = 100000;
+
+    TEST_CLASS(ParentSampler_Test)
+    {
+    public:
+        // -----------------------------------------
+        // ParentSampler
+        // -----------------------------------------
+        TEST_METHOD(ParentSampler_parseSelectionMethod)
+        {
+            SelectionMethod selectionMethod = SM_FITNESS_PROPORTIONAL;
+            Assert::AreEqual(true, ParentSampler::parseSelectionMethod("tournament", selectionMethod));
+            Assert::AreEqual(static_cast<int>(SM_TOURNAMENT), static_cast<int>(selectionMethod));
+
+            Assert::AreEqual(true, ParentSampler::parseSelectionMethod("rank", selectionMethod));
+            Assert::AreEqual(static_cast<int>(SM_RANK), static_cast<int>(selectionMethod));
+
+            Assert::AreEqual(false, ParentSampler::parseSelectionMethod("roulette", selectionMethod));
+            Assert::AreEqual(static_cast<int>(SM_RANK), static_cast<int>(selectionMethod));
+        }
+
+        TEST_METHOD(ParentSampler_fitnessProportional)
+        {
+            // same scores as in ParameterManager_fillParameterSetProbabilityMap: chances are 10/16, 6/16 and 0
+            ParentSampler sampler;
+            sampler.seed(42);
+            sampler.setup(SM_FITNESS_PROPORTIONAL, { 0, 2, 1 }, { 8, 4, -2 });
+
+            std::map<int, int> counts;
+            for (int k = 0; k < NUM_DRAWS; k++)
+            {
+                counts[sampler.sample()]++;
+            }
+
+            Assert::AreEqual(2, static_cast<int>(counts.size()));
+            Assert::AreEqual(0.625, counts[0] / static_cast<double>(NUM_DRAWS), 0.01);
+            Assert::AreEqual(0.375, counts[2] / static_cast<double>(NUM_DRAWS), 0.01);
+        }
+
+        TEST_METHOD(ParentSampler_fitnessProportional_equalScores)
+        {
+            // no set is better than another, so all of them are equally likely
+            ParentSampler sampler;
+            sampler.seed(42);
+            sampler.setup(SM_FITNESS_PROPORTIONAL, { 3, 4 }, { 1, 1 });
+
+            std::map<int, int> counts;
+            for (int k = 0; k < NUM_DRAWS; k++)
+            {
+                counts[sampler.sample()]++;
+            }
+
+            Assert::AreEqual(0.5, counts[3] / static_cast<double>(NUM_DRAWS), 0.01);
+            Assert::AreEqual(0.5, counts[4] / static_cast<double>(NUM_DRAWS), 0.01);
+        }
+
+        TEST_METHOD(ParentSampler_rank)
+        {
+            // weights 3, 2, 1
+            ParentSampler sampler;
+            sampler.seed(7);
+            sampler.setup(SM_RANK, { 5, 6, 7 }, { 100, 1, 0 });
+
+            std::map<int, int> counts;
+            for (int k = 0; k < NUM_DRAWS; k++)
+            {
+                counts[sampler.sample()]++;
+            }
+
+            Assert::AreEqual(3 / 6.0, counts[5] / static_cast<double>(NUM_DRAWS), 0.01);
+            Assert::AreEqual(2 / 6.0, counts[6] / static_cast<double>(NUM_DRAWS), 0.01);
+            Assert::AreEqual(1 / 6.0, counts[7] / static_cast<double>(NUM_DRAWS), 0.01);
+        }
+
+        TEST_METHOD(ParentSampler_tournament)
+        {
+            // with 2 participants out of 2 candidates, the worst one only wins if it's drawn twice
+            ParentSampler sampler;
+            sampler.seed(3);
+            sampler.setup(SM_TOURNAMENT, { 1, 0 }, { 5, 2 }, 2);
+
+            std::map<int, int> counts;
+            for (int k = 0; k < NUM_DRAWS; k++)
+            {
+                counts[sampler.sample()]++;
+            }
+
+            Assert::AreEqual(0.75, counts[1] / static_cast<double>(NUM_DRAWS), 0.01);
+            Assert::AreEqual(0.25, counts[0] / static_cast<double>(NUM_DRAWS), 0.01);
+        }
+
+        TEST_METHOD(ParentSampler_noCandidates)
+        {
+            ParentSampler sampler;
+            sampler.setup(SM_FITNESS_PROPORTIONAL, {}, {});
+            Assert::AreEqual(-1, sampler.sample());
+        }
+    };
+}
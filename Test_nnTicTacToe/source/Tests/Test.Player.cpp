@@ -14,6 +14,24 @@ namespace PlayerTest
     TEST_CLASS(Player_Test)
     {
     public:
+        // -----------------------------------------
+        // BasePlayer
+        // -----------------------------------------
+        TEST_METHOD(BasePlayer_parseMatchOpponent)
+        {
+            MatchOpponent opponent = MO_NONE;
+            Assert::AreEqual(true, BasePlayer::parseMatchOpponent("random", opponent));
+            Assert::AreEqual(static_cast<int>(MO_RANDOM), static_cast<int>(opponent));
+            Assert::AreEqual(true, BasePlayer::parseMatchOpponent("semi_random", opponent));
+            Assert::AreEqual(static_cast<int>(MO_SEMI_RANDOM), static_cast<int>(opponent));
+            Assert::AreEqual(true, BasePlayer::parseMatchOpponent("none", opponent));
+            Assert::AreEqual(static_cast<int>(MO_NONE), static_cast<int>(opponent));
+
+            // unknown names leave the value unchanged
+            Assert::AreEqual(false, BasePlayer::parseMatchOpponent("perfect", opponent));
+            Assert::AreEqual(static_cast<int>(MO_NONE), static_cast<int>(opponent));
+        }
+
         // -----------------------------------------
         // RandomPlayer
         // -----------------------------------------
@@ -70,9 +88,48 @@ namespace PlayerTest
             Assert::AreEqual(true, uniqueRandomMoves.size() > 1);
         }
 
+        TEST_METHOD(RandomPlayer_setSeed)
+        {
+            const std::vector<CellState> gameCells(9, CellState::CS_EMPTY);
+
+            RandomPlayer player1(0, CellState::CS_PLAYER1);
+            RandomPlayer player2(1, CellState::CS_PLAYER1);
+            player1.setSeed(42);
+            player2.setSeed(42);
+
+            // the same seed results in the same moves
+            std::vector<int> moves;
+            for (int k = 0; k < 50; k++)
+            {
+                moves.push_back(player1.decideMove(gameCells));
+                Assert::AreEqual(moves.back(), player2.decideMove(gameCells));
+            }
+
+            // setting the seed again starts over
+            player1.setSeed(42);
+            for (int k = 0; k < 50; k++)
+            {
+                Assert::AreEqual(moves[k], player1.decideMove(gameCells));
+            }
+        }
+
         // -----------------------------------------
         // SemiRandomPlayer
         // -----------------------------------------
+        TEST_METHOD(SemiRandomPlayer_decideMove_noTriple)
+        {
+            // without any triple to complete or block, an empty cell is picked randomly
+            std::vector<CellState> gameCells(9, CellState::CS_EMPTY);
+            gameCells[4] = CellState::CS_PLAYER2;
+
+            SemiRandomPlayer player(2, CellState::CS_PLAYER1);
+            for (int k = 0; k < 20; k++)
+            {
+                const int result = player.decideMove(gameCells);
+                Assert::AreEqual(true, result >= 0 && result < 9 && result != 4);
+            }
+        }
+
         TEST_METHOD(SemiRandomPlayer_decideMove_avoidLoss_row)
         {
             // if a single triple can be completed, the completing cell will be returned
@@ -0,0 +1,149 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Math/Random.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace RandomTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Math;
+
+    TEST_CLASS(Random_Test)
+    {
+    public:
+        //------------------------------------
+        // RandomGenerator
+        //------------------------------------
+        TEST_METHOD(RandomGenerator_sameSeed)
+        {
+            RandomGenerator gen1(123);
+            RandomGenerator gen2(123);
+            RandomGenerator gen3(124);
+
+            bool allEqual = true;
+            bool allEqualOtherSeed = true;
+            for (int k = 0; k < 100; k++)
+            {
+                const uint64_t value = gen1();
+                allEqual = allEqual && (value == gen2());
+                allEqualOtherSeed = allEqualOtherSeed && (value == gen3());
+            }
+
+            Assert::AreEqual(true, allEqual);
+            Assert::AreEqual(false, allEqualOtherSeed);
+        }
+
+        TEST_METHOD(RandomGenerator_jump)
+        {
+            RandomGenerator gen1(5);
+            RandomGenerator gen2(5);
+            gen2.jump();
+
+            Assert::AreEqual(false, gen1() == gen2());
+        }
+
+        TEST_METHOD(RandomGenerator_nextDouble)
+        {
+            RandomGenerator gen(9);
+
+            double sum = 0;
+            const int numValues = 100000;
+            for (int k = 0; k < numValues; k++)
+            {
+                const double value = gen.nextDouble();
+                Assert::AreEqual(true, value >= 0 && value < 1);
+                sum += value;
+            }
+
+            Assert::AreEqual(0.5, sum / numValues, 0.01);
+        }
+
+        //------------------------------------
+        // Random
+        //------------------------------------
+        TEST_METHOD(Random_masterSeed)
+        {
+            std::vector<double> values1(10);
+            std::vector<double> values2(10);
+
+            Random::setMasterSeed(77);
+            Assert::AreEqual(true, Random::getMasterSeed() == 77);
+            Random::fillUniform(values1.data(), 10, 0, 1);
+
+            // resetting the seed restarts the sequence
+            Random::setMasterSeed(77);
+            Random::fillUniform(values2.data(), 10, 0, 1);
+
+            for (int k = 0; k < 10; k++)
+            {
+                Assert::AreEqual(values1[k], values2[k]);
+            }
+
+            // 0 picks a random seed
+            Random::setMasterSeed(0);
+            Assert::AreEqual(false, Random::getMasterSeed() == 0);
+        }
+
+        TEST_METHOD(Random_threadStreams)
+        {
+            Random::setMasterSeed(11);
+            const uint64_t mainValue = Random::getGenerator()();
+
+            // another thread gets a different stream
+            uint64_t otherValue = mainValue;
+            std::thread worker([&otherValue]() { otherValue = Random::getGenerator()(); });
+            worker.join();
+
+            Assert::AreEqual(false, mainValue == otherValue);
+        }
+
+        TEST_METHOD(Random_createStream)
+        {
+            Random::setMasterSeed(21);
+            RandomGenerator stream1 = Random::createStream(1);
+            RandomGenerator stream1Again = Random::createStream(1);
+            RandomGenerator stream2 = Random::createStream(2);
+
+            const uint64_t value = stream1();
+            Assert::AreEqual(true, value == stream1Again());
+            Assert::AreEqual(false, value == stream2());
+        }
+
+        TEST_METHOD(Random_fillUniform)
+        {
+            std::vector<double> values(1000);
+            Random::fillUniform(values.data(), 1000, -3, 2);
+
+            for (auto value : values)
+            {
+                Assert::AreEqual(true, value >= -3 && value < 2);
+            }
+        }
+
+        TEST_METHOD(Random_fillNormal)
+        {
+            // odd number of values, the last pair only uses its first value
+            const int numValues = 100001;
+            std::vector<double> values(numValues);
+
+            RandomGenerator gen(3);
+            Random::fillNormal(gen, values.data(), numValues, 2, 0.5);
+
+            double sum = 0;
+            double squaredSum = 0;
+            for (auto value : values)
+            {
+                sum += value;
+                squaredSum += value * value;
+            }
+
+            const double mean = sum / numValues;
+            const double variance = squaredSum / numValues - mean * mean;
+            Assert::AreEqual(2.0, mean, 0.01);
+            Assert::AreEqual(0.5, std::sqrt(variance), 0.01);
+        }
+    };
+}
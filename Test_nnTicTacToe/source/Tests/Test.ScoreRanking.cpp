@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "NeuralNetwork/ScoreRanking.h"
+
+namespace ScoreRankingTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace NeuralNetwork;
+
+    TEST_CLASS(ScoreRanking_Test)
+    {
+    public:
+        // -----------------------------------------
+        // ScoreRanking
+        // -----------------------------------------
+        TEST_METHOD(ScoreRanking_getAllIds)
+        {
+            ScoreRanking ranking;
+            ranking.insert(0, 5.0);
+            ranking.insert(1, 8.0);
+            ranking.insert(2, -1.0);
+            ranking.insert(3, 5.0);
+
+            std::vector<int> ids;
+            ranking.getAllIds(ids);
+
+            // equal scores are ordered by id
+            Assert::AreEqual(4, static_cast<int>(ids.size()));
+            Assert::AreEqual(1, ids[0]);
+            Assert::AreEqual(0, ids[1]);
+            Assert::AreEqual(3, ids[2]);
+            Assert::AreEqual(2, ids[3]);
+
+            Assert::AreEqual(1, ranking.getBestId());
+            Assert::AreEqual(-1.0, ranking.getLowestScore(), 0.0001);
+        }
+
+        TEST_METHOD(ScoreRanking_getBestIds)
+        {
+            ScoreRanking ranking;
+            for (int k = 0; k < 10; k++)
+            {
+                ranking.insert(k, k * 1.5);
+            }
+
+            std::vector<int> ids;
+            ranking.getBestIds(3, ids);
+            Assert::AreEqual(3, static_cast<int>(ids.size()));
+            Assert::AreEqual(9, ids[0]);
+            Assert::AreEqual(8, ids[1]);
+            Assert::AreEqual(7, ids[2]);
+
+            // more than available
+            ranking.getBestIds(20, ids);
+            Assert::AreEqual(10, static_cast<int>(ids.size()));
+        }
+
+        TEST_METHOD(ScoreRanking_getWorstIds)
+        {
+            ScoreRanking ranking;
+            ranking.insert(0, 5.0);
+            ranking.insert(1, 8.0);
+            ranking.insert(2, -1.0);
+            ranking.insert(3, 5.0);
+
+            // the reverse order of getAllIds, so the higher id of two equal scores comes first
+            std::vector<int> ids;
+            ranking.getWorstIds(3, ids);
+            Assert::AreEqual(3, static_cast<int>(ids.size()));
+            Assert::AreEqual(2, ids[0]);
+            Assert::AreEqual(3, ids[1]);
+            Assert::AreEqual(0, ids[2]);
+
+            // more than available
+            ranking.getWorstIds(20, ids);
+            Assert::AreEqual(4, static_cast<int>(ids.size()));
+            Assert::AreEqual(1, ids.back());
+        }
+
+        TEST_METHOD(ScoreRanking_update)
+        {
+            ScoreRanking ranking;
+            ranking.insert(0, 1.0);
+            ranking.insert(1, 2.0);
+            ranking.insert(2, 3.0);
+
+            ranking.update(0, 1.0, 10.0);
+            ranking.remove(2, 3.0);
+
+            std::vector<int> ids;
+            ranking.getAllIds(ids);
+            Assert::AreEqual(2, static_cast<int>(ids.size()));
+            Assert::AreEqual(0, ids[0]);
+            Assert::AreEqual(1, ids[1]);
+            Assert::AreEqual(2.0, ranking.getLowestScore(), 0.0001);
+
+            ranking.clear();
+            Assert::AreEqual(true, ranking.empty());
+            Assert::AreEqual(-1, ranking.getBestId());
+        }
+    };
+}
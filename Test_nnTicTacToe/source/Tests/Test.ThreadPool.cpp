@@ -0,0 +1,131 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "General/ThreadPool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ThreadPoolTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace General;
+
+    TEST_CLASS(ThreadPool_Test)
+    {
+    public:
+        TEST_METHOD(ThreadPool_getNumThreads)
+        {
+            ThreadPool singlePool(1);
+            Assert::AreEqual(1, singlePool.getNumThreads());
+
+            ThreadPool pool(3);
+            Assert::AreEqual(3, pool.getNumThreads());
+
+            // use all hardware threads
+            ThreadPool defaultPool;
+            Assert::AreEqual(true, defaultPool.getNumThreads() >= 1);
+        }
+
+        TEST_METHOD(ThreadPool_parallelFor)
+        {
+            ThreadPool pool(4);
+
+            // run several times to make sure the workers pick up consecutive jobs
+            for (int run = 0; run < 20; run++)
+            {
+                std::vector<int> counts(1000, 0);
+                pool.parallelFor(0, 1000, 10, [&](int begin, int end)
+                {
+                    for (int k = begin; k < end; k++)
+                    {
+                        counts[k]++;
+                    }
+                });
+
+                // each index is handled exactly once
+                for (auto count : counts)
+                {
+                    Assert::AreEqual(1, count);
+                }
+            }
+        }
+
+        TEST_METHOD(ThreadPool_parallelFor_pinned)
+        {
+            ThreadPool pool(4, true);
+            Assert::AreEqual(true, pool.isPinnedToNumaNodes());
+
+            // each chunk goes to the same thread every time
+            std::vector<std::thread::id> firstThreads(1000);
+            for (int run = 0; run < 20; run++)
+            {
+                std::vector<int> counts(1000, 0);
+                std::vector<std::thread::id> threads(1000);
+                pool.parallelFor(0, 1000, 10, [&](int begin, int end)
+                {
+                    for (int k = begin; k < end; k++)
+                    {
+                        counts[k]++;
+                        threads[k] = std::this_thread::get_id();
+                    }
+                });
+
+                for (int k = 0; k < 1000; k++)
+                {
+                    Assert::AreEqual(1, counts[k]);
+                    if (run > 0)
+                    {
+                        Assert::AreEqual(true, threads[k] == firstThreads[k]);
+                    }
+                }
+
+                firstThreads = threads;
+            }
+        }
+
+        TEST_METHOD(ThreadPool_parallelFor_smallRange)
+        {
+            ThreadPool pool(4);
+
+            // range is smaller than the minimum chunk size, so it's handled as a single chunk
+            int numCalls = 0;
+            pool.parallelFor(5, 12, 10, [&](int begin, int end)
+            {
+                numCalls++;
+                Assert::AreEqual(5, begin);
+                Assert::AreEqual(12, end);
+            });
+
+            Assert::AreEqual(1, numCalls);
+
+            // empty range
+            pool.parallelFor(3, 3, 1, [&](int begin, int end)
+            {
+                numCalls++;
+            });
+
+            Assert::AreEqual(1, numCalls);
+        }
+
+        TEST_METHOD(ThreadPool_parallelFor_nested)
+        {
+            ThreadPool pool(4);
+
+            std::atomic<int> sum(0);
+            pool.parallelFor(0, 8, 1, [&](int begin, int end)
+            {
+                for (int k = begin; k < end; k++)
+                {
+                    // inner call runs on the current thread
+                    pool.parallelFor(0, 100, 1, [&](int innerBegin, int innerEnd)
+                    {
+                        sum += innerEnd - innerBegin;
+                    });
+                }
+            });
+
+            Assert::AreEqual(800, sum.load());
+        }
+    };
+}
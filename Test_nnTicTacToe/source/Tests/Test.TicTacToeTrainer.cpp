@@ -2,8 +2,10 @@
 #include "CppUnitTest.h"
 
 #include "Training/TicTacToeTrainer.h"
+#include "Math/Random.h"
 #include "NeuralNetwork/ParameterManager.h"
 
+#include <algorithm>
 #include <set>
 
 namespace TicTacToeTrainerTest
@@ -12,6 +14,43 @@ namespace TicTacToeTrainerTest
     using namespace Game;
     using namespace Training;
 
+    // set up without a config file, so single iterations can be run and inspected
+    class TestTicTacToeTrainer
+        : public TicTacToeTrainer
+    {
+    public:
+        TestTicTacToeTrainer(std::shared_ptr<GameLogic>& gameLogic)
+            : TicTacToeTrainer(gameLogic)
+        {
+        }
+
+        void setSteadyStateEvolution(bool steadyState) { m_steadyStateEvolution = steadyState; }
+        void setFitnessCacheSize(int size) { m_fitnessCacheSize = size; }
+        void setPolicyCacheSize(int size) { m_policyCacheSize = size; }
+
+        bool setupGeneticAlgorithm(int numParamSets, int numIterations)
+        {
+            m_trainingMethod = TM_GENETIC_ALGORITHM;
+            m_paramData.numParamSets = numParamSets;
+            m_numIterations = numIterations;
+            m_numThreads = 1;
+
+            return handleOptionValidation() && setupTrainingData() && setupNetwork() && setupParameters() && setupTrainingMethod();
+        }
+
+        NeuralNetwork::ParameterManager& getParameterManager() { return *m_paramManager; }
+
+        // active sets with and without a score
+        void countActiveSets(int& numEvaluated, int& numUnevaluated) const
+        {
+            std::vector<int> activeIds;
+            m_paramManager->getActiveParameterSetIds(activeIds);
+
+            numEvaluated = static_cast<int>(std::count_if(activeIds.begin(), activeIds.end(), [this](int id) { return m_paramManager->isEvaluated(id); }));
+            numUnevaluated = static_cast<int>(activeIds.size()) - numEvaluated;
+        }
+    };
+
     TEST_CLASS(TicTacToeTrainer_Test)
     {
     public:
@@ -85,5 +124,171 @@ namespace TicTacToeTrainerTest
 
             Assert::AreEqual(0, countInvalid);
         }
+
+        TEST_METHOD(TicTacToeTrainer_isMatchScoreDecided)
+        {
+            // too few matches to decide anything
+            Assert::AreEqual(false, TicTacToeTrainer::isMatchScoreDecided(4, 40, 400, 5));
+
+            // 20 matches with scores 10 and 12 (mean 11, standard error ~0.23)
+            const int numMatches = 20;
+            const double scoreSum = 10 * 10 + 10 * 12;
+            const double squareSum = 10 * 100 + 10 * 144;
+
+            Assert::AreEqual(true, TicTacToeTrainer::isMatchScoreDecided(numMatches, scoreSum, squareSum, 10));
+            Assert::AreEqual(true, TicTacToeTrainer::isMatchScoreDecided(numMatches, scoreSum, squareSum, 12));
+            Assert::AreEqual(false, TicTacToeTrainer::isMatchScoreDecided(numMatches, scoreSum, squareSum, 11.2));
+
+            // identical scores: only the threshold itself is undecided
+            Assert::AreEqual(true, TicTacToeTrainer::isMatchScoreDecided(numMatches, 20 * 10.0, 20 * 100.0, 9.99));
+            Assert::AreEqual(false, TicTacToeTrainer::isMatchScoreDecided(numMatches, 20 * 10.0, 20 * 100.0, 10));
+        }
+
+        TEST_METHOD(TicTacToeTrainer_steadyStateEvolution_fitnessCacheHit)
+        {
+            using namespace NeuralNetwork;
+
+            std::shared_ptr<GameLogic> gameLogic = std::make_shared<TicTacToeLogic>();
+            TestTicTacToeTrainer trainer(gameLogic);
+            trainer.setSteadyStateEvolution(true);
+            trainer.setFitnessCacheSize(100);
+            Assert::AreEqual(true, trainer.setupGeneticAlgorithm(6, 3));
+
+            // the initial population is complete, and each scored set except the first one (no second parent yet) added a child
+            int numEvaluated = 0;
+            int numUnevaluated = 0;
+            trainer.handleTrainingIteration(0);
+            trainer.countActiveSets(numEvaluated, numUnevaluated);
+            Assert::AreEqual(6, numEvaluated);
+            Assert::AreEqual(5, numUnevaluated);
+
+            // a copy of a scored set gets its score from the fitness cache
+            ParamSet copy;
+            Assert::AreEqual(true, trainer.getParameterManager().getParamSetForId(0, copy));
+            copy.score = 0;
+            copy.evaluated = false;
+            trainer.getParameterManager().addNewParamSet(copy);
+
+            // the cache hit takes part in the replacement like the five children and adds a child as well
+            trainer.handleTrainingIteration(1);
+            trainer.countActiveSets(numEvaluated, numUnevaluated);
+            Assert::AreEqual(6, numEvaluated);
+            Assert::AreEqual(6, numUnevaluated);
+        }
+
+        TEST_METHOD(TicTacToeTrainer_policyCache)
+        {
+            using namespace NeuralNetwork;
+
+            const uint64_t seed = 7;
+            const int numParamSets = 4;
+
+            // four random sets plus a copy of the first one, which picks the same moves
+            const auto addCopyOfFirstSet = [](ParameterManager& paramManager)
+            {
+                ParamSet copy;
+                Assert::AreEqual(true, paramManager.getParamSetForId(0, copy));
+                copy.score = 0;
+                copy.evaluated = false;
+                return paramManager.addNewParamSet(copy);
+            };
+
+            std::shared_ptr<GameLogic> gameLogic = std::make_shared<TicTacToeLogic>();
+            TestTicTacToeTrainer cachedTrainer(gameLogic);
+            cachedTrainer.setPolicyCacheSize(100);
+            Math::Random::setMasterSeed(seed);
+            Assert::AreEqual(true, cachedTrainer.setupGeneticAlgorithm(numParamSets, 2));
+            const int copyId = addCopyOfFirstSet(cachedTrainer.getParameterManager());
+
+            // the random sets pick different moves, only the copy is found in the cache
+            cachedTrainer.handleTrainingIteration(0);
+            Assert::AreEqual(1, cachedTrainer.getNumPolicyCacheHits());
+            Assert::AreEqual(cachedTrainer.getParameterManager().getScore(0), cachedTrainer.getParameterManager().getScore(copyId));
+
+            // the same sets scored without the policy cache
+            TestTicTacToeTrainer freshTrainer(gameLogic);
+            Math::Random::setMasterSeed(seed);
+            Assert::AreEqual(true, freshTrainer.setupGeneticAlgorithm(numParamSets, 2));
+            addCopyOfFirstSet(freshTrainer.getParameterManager());
+
+            freshTrainer.handleTrainingIteration(0);
+            Assert::AreEqual(0, freshTrainer.getNumPolicyCacheHits());
+            for (int id = 0; id <= copyId; id++)
+            {
+                Assert::AreEqual(freshTrainer.getParameterManager().getScore(id), cachedTrainer.getParameterManager().getScore(id));
+            }
+        }
+
+        TEST_METHOD(TicTacToeTrainer_getMatchOpponentSeed)
+        {
+            const uint64_t opponentSeed = 1234;
+            const std::vector<CellState> gameCells(9, CellState::CS_EMPTY);
+
+            // the opponents of two sets: the first match against the first set is shorter than the one against the second set
+            RandomPlayer opponent1(-1, CellState::CS_PLAYER2);
+            RandomPlayer opponent2(-1, CellState::CS_PLAYER2);
+            opponent1.setSeed(TicTacToeTrainer::getMatchOpponentSeed(opponentSeed, 0, 0));
+            opponent2.setSeed(TicTacToeTrainer::getMatchOpponentSeed(opponentSeed, 0, 0));
+            for (int k = 0; k < 2; k++)
+            {
+                opponent1.decideMove(gameCells);
+            }
+            for (int k = 0; k < 4; k++)
+            {
+                opponent2.decideMove(gameCells);
+            }
+
+            // both sets still face the same moves in the next match
+            opponent1.setSeed(TicTacToeTrainer::getMatchOpponentSeed(opponentSeed, 1, 0));
+            opponent2.setSeed(TicTacToeTrainer::getMatchOpponentSeed(opponentSeed, 1, 0));
+            for (int k = 0; k < 20; k++)
+            {
+                Assert::AreEqual(opponent1.decideMove(gameCells), opponent2.decideMove(gameCells));
+            }
+
+            // every match and side gets its own seed
+            std::set<uint64_t> seeds;
+            for (int match = 0; match < 10; match++)
+            {
+                for (int side = 0; side < 2; side++)
+                {
+                    seeds.insert(TicTacToeTrainer::getMatchOpponentSeed(opponentSeed, match, side));
+                }
+            }
+            seeds.insert(TicTacToeTrainer::getMatchOpponentSeed(opponentSeed + 1, 0, 0));
+            Assert::AreEqual(21, static_cast<int>(seeds.size()));
+        }
+
+        TEST_METHOD(TicTacToeTrainer_getAverageScore_matchWeight)
+        {
+            // valid moves on all boards, followed by matches that are all lost with the same score
+            const auto createScoreSet = [](int numMatches, double matchScore)
+            {
+                ScoreSet scoreSet;
+                scoreSet.scores.assign(222, 10.0);
+                scoreSet.tiedCount = 222;
+
+                scoreSet.scores.insert(scoreSet.scores.end(), numMatches, matchScore);
+                scoreSet.lostCount = numMatches;
+                scoreSet.numMatches = numMatches;
+                scoreSet.matchScoreSum = numMatches * matchScore;
+                scoreSet.matchScoreSquareSum = numMatches * matchScore * matchScore;
+                scoreSet.matchLostCount = numMatches;
+                return scoreSet;
+            };
+
+            // stopped early with bad match results vs. all matches played with better results
+            const ScoreSet stoppedEarly = createScoreSet(20, 1);
+            const ScoreSet playedAll = createScoreSet(200, 5);
+
+            Assert::AreEqual(11.0, TicTacToeTrainer::getAverageScore(stoppedEarly), 0.0001);
+            Assert::AreEqual(15.0, TicTacToeTrainer::getAverageScore(playedAll), 0.0001);
+
+            // the same outcomes give the same outcome score, no matter how many matches were played
+            Assert::AreEqual(TicTacToeTrainer::getOutcomeRatioScore(stoppedEarly), TicTacToeTrainer::getOutcomeRatioScore(playedAll), 0.0001);
+
+            Assert::AreEqual(true, TicTacToeTrainer::getAverageScore(stoppedEarly) + TicTacToeTrainer::getOutcomeRatioScore(stoppedEarly)
+                < TicTacToeTrainer::getAverageScore(playedAll) + TicTacToeTrainer::getOutcomeRatioScore(playedAll));
+        }
     };
 }
@@ -0,0 +1,69 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Training/TrainingMethodHandler.h"
+
+#include <vector>
+
+namespace TrainingMethodHandlerTest
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+    using namespace Training;
+
+    TEST_CLASS(TrainingMethodHandler_Test)
+    {
+    public:
+        //------------------------------------
+        // TrainingMethodHandler
+        //------------------------------------
+        TEST_METHOD(TrainingMethodHandler_parseTrainingMethod)
+        {
+            TrainingMethod trainingMethod = TM_BACKPROPAGATION;
+            Assert::AreEqual(true, TrainingMethodHandler::parseTrainingMethod("evolution_strategies", trainingMethod));
+            Assert::AreEqual(static_cast<int>(TM_EVOLUTION_STRATEGIES), static_cast<int>(trainingMethod));
+
+            Assert::AreEqual(true, TrainingMethodHandler::parseTrainingMethod("cma_es", trainingMethod));
+            Assert::AreEqual(static_cast<int>(TM_CMA_ES), static_cast<int>(trainingMethod));
+
+            Assert::AreEqual(true, TrainingMethodHandler::parseTrainingMethod("lbfgs", trainingMethod));
+            Assert::AreEqual(static_cast<int>(TM_LBFGS), static_cast<int>(trainingMethod));
+
+            Assert::AreEqual(true, TrainingMethodHandler::parseTrainingMethod("genetic_algorithm", trainingMethod));
+            Assert::AreEqual(static_cast<int>(TM_GENETIC_ALGORITHM), static_cast<int>(trainingMethod));
+
+            // unknown names keep the previous value
+            Assert::AreEqual(false, TrainingMethodHandler::parseTrainingMethod("simulated_annealing", trainingMethod));
+            Assert::AreEqual(static_cast<int>(TM_GENETIC_ALGORITHM), static_cast<int>(trainingMethod));
+        }
+
+        //------------------------------------
+        // EvolutionStrategiesHandler
+        //------------------------------------
+        TEST_METHOD(EvolutionStrategiesHandler_computeCenteredRanks)
+        {
+            std::vector<double> ranks;
+            EvolutionStrategiesHandler::computeCenteredRanks(std::vector<double>({ 10, -3, 200, 7, 0 }), ranks);
+
+            Assert::AreEqual(5, static_cast<int>(ranks.size()));
+            Assert::AreEqual(0.25, ranks[0], 0.000001);
+            Assert::AreEqual(-0.5, ranks[1], 0.000001);
+            Assert::AreEqual(0.5, ranks[2], 0.000001);
+            Assert::AreEqual(0.0, ranks[3], 0.000001);
+            Assert::AreEqual(-0.25, ranks[4], 0.000001);
+        }
+
+        TEST_METHOD(EvolutionStrategiesHandler_computeCenteredRanks_ties)
+        {
+            std::vector<double> ranks;
+            EvolutionStrategiesHandler::computeCenteredRanks(std::vector<double>({ 1, 5, 1, 5 }), ranks);
+
+            // tied scores get the same weight, so tied mirrored candidates cancel out
+            Assert::AreEqual(ranks[0], ranks[2], 0.000001);
+            Assert::AreEqual(ranks[1], ranks[3], 0.000001);
+            Assert::AreEqual(-1.0 / 3, ranks[0], 0.000001);
+            Assert::AreEqual(1.0 / 3, ranks[1], 0.000001);
+
+            EvolutionStrategiesHandler::computeCenteredRanks(std::vector<double>({ 3 }), ranks);
+            Assert::AreEqual(0.0, ranks[0], 0.000001);
+        }
+    };
+}
@@ -12,6 +12,8 @@ namespace FileIO
     const int MAX_NESTED_PATH_LOOKUP_ATTEMPTS = 3;
     const std::string DATA_PATH = "data/";
     const std::string LOGFILE_NAME = "logfile.txt";
+
+    std::string s_fileNamePrefix;
     
     void FileManager::clearLogFile()
     {
@@ -118,7 +120,12 @@ namespace FileIO
         return false;
     }
 
-    bool FileManager::getRelativeDataFilePath(const std::string& fileName, std::string& relativePath)
+    void FileManager::setFileNamePrefix(const std::string& prefix)
+    {
+        s_fileNamePrefix = prefix;
+    }
+
+    bool FileManager::getRelativeDataFilePath(const std::string& fileName, std::string& relativePath, bool shared)
     {
         if (!getRelativeFilePath(DATA_PATH, relativePath))
         {
@@ -126,14 +133,14 @@ namespace FileIO
             return false;
         }
 
-        relativePath += fileName;
+        relativePath += shared ? fileName : s_fileNamePrefix + fileName;
         return true;
     }
 
-    bool FileManager::readJsonFromFile(const std::string& fileName, nlohmann::json& jsonObject)
+    bool FileManager::readJsonFromFile(const std::string& fileName, nlohmann::json& jsonObject, bool shared)
     {
         std::string relativePath;
-        if (!getRelativeDataFilePath(fileName, relativePath))
+        if (!getRelativeDataFilePath(fileName, relativePath, shared))
         {
             return false;
         }
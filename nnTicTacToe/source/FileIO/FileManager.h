@@ -19,11 +19,16 @@ namespace FileIO
         static void printErrorMessage(const std::string& msg);
         static void printErrorMessage(const std::ostringstream& stream);
 
-        static bool readJsonFromFile(const std::string& fileName, nlohmann::json& jsonObject);
+        /// shared: the file is used by all processes working in the data directory, so the file name prefix isn't applied
+        static bool readJsonFromFile(const std::string& fileName, nlohmann::json& jsonObject, bool shared = false);
         static bool writeJsonToFile(const std::string& fileName, const nlohmann::json& jsonObject);
 
+        /// prepended to the names of all data files that aren't shared (including the log file),
+        /// so several processes can use the same data directory without overwriting each other's files
+        static void setFileNamePrefix(const std::string& prefix);
+
     public:
-        static bool getRelativeDataFilePath(const std::string& fileName, std::string& relativePath);
+        static bool getRelativeDataFilePath(const std::string& fileName, std::string& relativePath, bool shared = false);
         static bool openOutFileStream(const std::string& filePath, std::ofstream& ofs, int mode = std::ofstream::out);
 
     private:
@@ -4,6 +4,7 @@
 #include <assert.h>
 
 #include "GameLogic.h"
+#include "InputEncoder.h"
 
 namespace Game
 {
@@ -86,7 +87,7 @@ namespace Game
     void TicTacToeLogic::getRequiredNetworkSize(NetworkSizeData& sizeData) const
     {
         sizeData.numOutputNodes = getBoardSize();
-        sizeData.numInputNodes = 2 * sizeData.numOutputNodes;
+        sizeData.numInputNodes = InputEncoder::getNumInputValues(m_inputEncoding, getBoardSize());
     }
 
     bool TicTacToeLogic::isValidMove(int playerId, int actionIndex) const
@@ -117,26 +118,8 @@ namespace Game
 
     void TicTacToeLogic::getNodeNetworkInputValues(std::vector<double>& inputValues) const
     {
-        inputValues.clear();
-
-        for (const auto& cell : m_gameCells)
-        {
-            switch (cell)
-            {
-            case CellState::CS_EMPTY:
-                inputValues.push_back(-1.0);
-                inputValues.push_back(-1.0);
-                break;
-            case CellState::CS_PLAYER1:
-                inputValues.push_back(1.0);
-                inputValues.push_back(-1.0);
-                break;
-            case CellState::CS_PLAYER2:
-                inputValues.push_back(-1.0);
-                inputValues.push_back(1.0);
-                break;
-            }
-        }
+        // as seen by the first player
+        InputEncoder::encode(m_inputEncoding, m_gameCells, CellState::CS_PLAYER1, inputValues);
     }
 
     void TicTacToeLogic::getExpectedOutput(int playerId, std::vector<double>& expectedOutput) const
@@ -32,9 +32,12 @@ namespace Game
         CellState getCellValue(int row, int col) const;
         virtual void setGameCells(const std::vector<CellState>& gameCells);
         virtual void getGameCells(std::vector<CellState>& gameCells) const;
+        void setInputEncoding(InputEncoding encoding) { m_inputEncoding = encoding; }
+        InputEncoding getInputEncoding() const { return m_inputEncoding; }
 
     protected:
         std::vector<CellState> m_gameCells;
+        InputEncoding m_inputEncoding = IE_TWO_PLANES;
         int m_numRows = 0;
         int m_numCols = 0;
     };
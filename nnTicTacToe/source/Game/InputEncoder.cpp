@@ -0,0 +1,177 @@
+#include "stdafx.h"
+
+#include <assert.h>
+
+#include "InputEncoder.h"
+
+namespace Game
+{
+    // the packed bitplanes store each plane in 32 bits
+    const int MAX_BITPLANE_CELLS = 32;
+
+    bool InputEncoder::parseInputEncoding(const std::string& name, InputEncoding& encoding)
+    {
+        if (name == "two_planes")
+        {
+            encoding = IE_TWO_PLANES;
+        }
+        else if (name == "ternary")
+        {
+            encoding = IE_TERNARY;
+        }
+        else if (name == "one_hot")
+        {
+            encoding = IE_ONE_HOT;
+        }
+        else if (name == "bitplanes")
+        {
+            encoding = IE_BITPLANES;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string InputEncoder::getInputEncodingDescription(InputEncoding encoding)
+    {
+        switch (encoding)
+        {
+        case IE_TWO_PLANES: return "two planes (+-1)";
+        case IE_TERNARY:    return "ternary (one value per cell)";
+        case IE_ONE_HOT:    return "one-hot (three planes)";
+        case IE_BITPLANES:  return "bitplanes";
+        default:            return "";
+        }
+    }
+
+    int InputEncoder::getNumInputValues(InputEncoding encoding, int numCells)
+    {
+        switch (encoding)
+        {
+        case IE_TERNARY:    return numCells;
+        case IE_ONE_HOT:    return 3 * numCells;
+        case IE_TWO_PLANES:
+        case IE_BITPLANES:
+        default:            return 2 * numCells;
+        }
+    }
+
+    void InputEncoder::encode(InputEncoding encoding, const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues)
+    {
+        assert(ownPlayer != CS_EMPTY);
+
+        inputValues.clear();
+        inputValues.reserve(getNumInputValues(encoding, static_cast<int>(gameCells.size())));
+
+        switch (encoding)
+        {
+        case IE_TERNARY:
+            encodeTernary(gameCells, ownPlayer, inputValues);
+            break;
+        case IE_ONE_HOT:
+            encodeOneHot(gameCells, ownPlayer, inputValues);
+            break;
+        case IE_BITPLANES:
+            encodeBitplanes(gameCells, ownPlayer, inputValues);
+            break;
+        case IE_TWO_PLANES:
+        default:
+            encodeTwoPlanes(gameCells, ownPlayer, inputValues);
+            break;
+        }
+    }
+
+    uint64_t InputEncoder::packBitplanes(const std::vector<CellState>& gameCells, CellState ownPlayer)
+    {
+        assert(gameCells.size() <= MAX_BITPLANE_CELLS);
+
+        uint64_t ownBits = 0;
+        uint64_t otherBits = 0;
+        for (unsigned int k = 0; k < gameCells.size(); k++)
+        {
+            if (gameCells[k] == CS_EMPTY)
+            {
+                continue;
+            }
+
+            if (gameCells[k] == ownPlayer)
+            {
+                ownBits |= (uint64_t(1) << k);
+            }
+            else
+            {
+                otherBits |= (uint64_t(1) << k);
+            }
+        }
+
+        return ownBits | (otherBits << MAX_BITPLANE_CELLS);
+    }
+
+    void InputEncoder::encodeTwoPlanes(const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues)
+    {
+        for (const auto& cell : gameCells)
+        {
+            if (cell == CellState::CS_EMPTY)
+            {
+                inputValues.push_back(-1.0);
+                inputValues.push_back(-1.0);
+            }
+            else if (cell == ownPlayer)
+            {
+                inputValues.push_back(1.0);
+                inputValues.push_back(-1.0);
+            }
+            else
+            {
+                inputValues.push_back(-1.0);
+                inputValues.push_back(1.0);
+            }
+        }
+    }
+
+    void InputEncoder::encodeTernary(const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues)
+    {
+        for (const auto& cell : gameCells)
+        {
+            if (cell == CellState::CS_EMPTY)
+            {
+                inputValues.push_back(0.0);
+            }
+            else
+            {
+                inputValues.push_back(cell == ownPlayer ? 1.0 : -1.0);
+            }
+        }
+    }
+
+    void InputEncoder::encodeOneHot(const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues)
+    {
+        for (const auto& cell : gameCells)
+        {
+            const bool isEmpty = (cell == CellState::CS_EMPTY);
+            const bool isOwn = !isEmpty && (cell == ownPlayer);
+
+            inputValues.push_back(isEmpty ? 1.0 : 0.0);
+            inputValues.push_back(isOwn ? 1.0 : 0.0);
+            inputValues.push_back(!isEmpty && !isOwn ? 1.0 : 0.0);
+        }
+    }
+
+    void InputEncoder::encodeBitplanes(const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues)
+    {
+        const uint64_t bits = packBitplanes(gameCells, ownPlayer);
+        const int numCells = static_cast<int>(gameCells.size());
+
+        for (int plane = 0; plane < 2; plane++)
+        {
+            const uint64_t planeBits = bits >> (plane * MAX_BITPLANE_CELLS);
+            for (int k = 0; k < numCells; k++)
+            {
+                inputValues.push_back(static_cast<double>((planeBits >> k) & 1));
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "General/Globals.h"
+
+namespace Game
+{
+    /// converts game cells into network input values
+    /// all encodings are relative to a player: "own" cells belong to that player, "other" cells to the opponent
+    class InputEncoder
+    {
+    public:
+        /// known names: "two_planes", "ternary", "one_hot", "bitplanes"
+        /// returns false (and leaves encoding untouched) for unknown names
+        static bool parseInputEncoding(const std::string& name, InputEncoding& encoding);
+        static std::string getInputEncodingDescription(InputEncoding encoding);
+
+        /// number of network input values needed for a board with numCells cells
+        static int getNumInputValues(InputEncoding encoding, int numCells);
+
+        static void encode(InputEncoding encoding, const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues);
+
+        /// packs the board into two bit masks: bit k of the lower 32 bits is set if cell k is an own cell,
+        /// bit k of the upper 32 bits is set if cell k is an other player's cell (supports up to 32 cells)
+        static uint64_t packBitplanes(const std::vector<CellState>& gameCells, CellState ownPlayer);
+
+    private:
+        /// per cell: (1, -1) for own cells, (-1, 1) for other cells and (-1, -1) for empty cells
+        static void encodeTwoPlanes(const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues);
+
+        /// per cell: 1 for own cells, -1 for other cells and 0 for empty cells
+        static void encodeTernary(const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues);
+
+        /// per cell: (empty, own, other), exactly one of which is 1 and the others 0
+        static void encodeOneHot(const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues);
+
+        /// the unpacked bits of packBitplanes: first the own plane, then the other plane (0 or 1 each)
+        static void encodeBitplanes(const std::vector<CellState>& gameCells, CellState ownPlayer, std::vector<double>& inputValues);
+    };
+}
@@ -5,6 +5,8 @@
 
 #include "FileIO/FileManager.h"
 #include "GameLogic.h"
+#include "InputEncoder.h"
+#include "Math/Random.h"
 #include "Player.h"
 
 namespace Game
@@ -18,6 +20,39 @@ namespace Game
     {
     }
 
+    bool BasePlayer::parseMatchOpponent(const std::string& name, MatchOpponent& opponent)
+    {
+        if (name == "none")
+        {
+            opponent = MO_NONE;
+        }
+        else if (name == "random")
+        {
+            opponent = MO_RANDOM;
+        }
+        else if (name == "semi_random")
+        {
+            opponent = MO_SEMI_RANDOM;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string BasePlayer::getMatchOpponentDescription(MatchOpponent opponent)
+    {
+        switch (opponent)
+        {
+        case MO_NONE:        return "none";
+        case MO_RANDOM:      return "random player";
+        case MO_SEMI_RANDOM: return "semi-random player";
+        default:             return "";
+        }
+    }
+
     int BasePlayer::decideMove(const std::vector<CellState>& gameCells)
     {
         std::vector<double> outputCells;
@@ -29,8 +64,7 @@ namespace Game
     RandomPlayer::RandomPlayer(int id, CellState player)
         : BasePlayer(id, player)
     {
-        std::random_device rd;
-        m_mt = std::mt19937(rd());
+        m_mt = std::mt19937(static_cast<unsigned int>(Math::Random::getGenerator()()));
     }
 
     int RandomPlayer::decideMove(const std::vector<CellState>& gameCells)
@@ -62,6 +96,12 @@ namespace Game
         return candidates[randomIndex];
     }
 
+    void RandomPlayer::setSeed(uint64_t seed)
+    {
+        std::seed_seq seedSequence{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) };
+        m_mt.seed(seedSequence);
+    }
+
     // SemiRandomPlayer:
     // tries to close any open triples, otherwise randomly picks an empty cell
     SemiRandomPlayer::SemiRandomPlayer(int id, CellState player)
@@ -91,7 +131,8 @@ namespace Game
             if (candidates.empty())
             {
                 // if no triple is possible, choose randomly
-                return RandomPlayer::decideMove(gameCells);
+                // (RandomPlayer::decideMove(gameCells) would end up back here through the virtual overload)
+                return RandomPlayer::decideMove(gameCells, outputValues);
             }
         }
 
@@ -102,9 +143,10 @@ namespace Game
 
     // AI player:
     // uses neural networks to find a solution
-    AiPlayer::AiPlayer(int id, CellState player, std::shared_ptr<NodeNetwork>& network)
+    AiPlayer::AiPlayer(int id, CellState player, std::shared_ptr<NodeNetwork>& network, InputEncoding inputEncoding)
         : BasePlayer(id, player)
         , m_nodeNetwork(network)
+        , m_inputEncoding(inputEncoding)
     {
     }
 
@@ -138,27 +180,6 @@ namespace Game
 
     void AiPlayer::getNodeNetworkInputValues(const std::vector<CellState>& gameCells, std::vector<double>& inputValues) const
     {
-        inputValues.clear();
-
-        for (const auto& cell : gameCells)
-        {
-            if (cell == CellState::CS_EMPTY)
-            {
-                inputValues.push_back(-1.0);
-                inputValues.push_back(-1.0);
-            }
-            else if (cell == m_player)
-            {
-                // own cells
-                inputValues.push_back(1.0);
-                inputValues.push_back(-1.0);
-            }
-            else
-            {
-                // other player cells
-                inputValues.push_back(-1.0);
-                inputValues.push_back(1.0);
-            }
-        }
+        InputEncoder::encode(m_inputEncoding, gameCells, m_player, inputValues);
     }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
 #include <vector>
 
@@ -13,6 +14,10 @@ namespace Game
     public:
         BasePlayer(int id, CellState player);
 
+    public:
+        static bool parseMatchOpponent(const std::string& name, MatchOpponent& opponent);
+        static std::string getMatchOpponentDescription(MatchOpponent opponent);
+
     public:
         int getId() const { return m_id; }
         CellState getPlayerId() const { return m_player; }
@@ -40,7 +45,10 @@ namespace Game
         int decideMove(const std::vector<CellState>& gameCells) override;
         int decideMove(const std::vector<CellState>& gameCells, std::vector<double>& outputValues) override;
 
-    private:
+        /// restarts the random moves; players with the same seed make the same moves on the same boards
+        void setSeed(uint64_t seed);
+
+    protected:
         std::mt19937 m_mt;
     };
 
@@ -56,9 +64,6 @@ namespace Game
         /// pick a random non-occupied cell
         int decideMove(const std::vector<CellState>& gameCells) override;
         int decideMove(const std::vector<CellState>& gameCells, std::vector<double>& outputValues) override;
-
-    private:
-        std::mt19937 m_mt;
     };
 
     class AiPlayer
@@ -66,7 +71,7 @@ namespace Game
     {
     public:
         AiPlayer() = delete;
-        AiPlayer(int id, CellState player, std::shared_ptr<NeuralNetwork::NodeNetwork>& network);
+        AiPlayer(int id, CellState player, std::shared_ptr<NeuralNetwork::NodeNetwork>& network, InputEncoding inputEncoding = IE_TWO_PLANES);
 
     public:
         std::string getPlayerType() const override { return "AiPlayer"; }
@@ -76,5 +81,6 @@ namespace Game
 
     private:
         std::shared_ptr<NeuralNetwork::NodeNetwork>& m_nodeNetwork;
+        InputEncoding m_inputEncoding;
     };
 }
@@ -18,6 +18,56 @@ enum CellState
     CS_PLAYER2 = -1
 };
 
+/// how the game cells are converted into network input values (see Game::InputEncoder)
+enum InputEncoding
+{
+    IE_TWO_PLANES,
+    IE_TERNARY,
+    IE_ONE_HOT,
+    IE_BITPLANES
+};
+
+/// error measure minimized by backpropagation (see Math::LossFunctions)
+enum LossFunction
+{
+    LF_SQUARED_ERROR,
+    LF_SOFTMAX_CROSS_ENTROPY
+};
+
+/// how parents are picked for crossover during evolution (see NeuralNetwork::ParentSampler)
+enum SelectionMethod
+{
+    SM_FITNESS_PROPORTIONAL,
+    SM_TOURNAMENT,
+    SM_RANK
+};
+
+/// how the parameter sets are improved between iterations (see Training::TrainingMethodHandler)
+enum TrainingMethod
+{
+    TM_BACKPROPAGATION,
+    TM_GENETIC_ALGORITHM,
+    TM_EVOLUTION_STRATEGIES,
+    TM_CMA_ES,
+    TM_LBFGS
+};
+
+/// how the parameter values are kept in memory (see NeuralNetwork::ParameterStore)
+enum ParameterPrecision
+{
+    PP_DOUBLE,
+    PP_FLOAT16,
+    PP_BFLOAT16
+};
+
+/// opponent the ai plays full matches against while being scored (see Game::BasePlayer)
+enum MatchOpponent
+{
+    MO_NONE,
+    MO_RANDOM,
+    MO_SEMI_RANDOM
+};
+
 struct NetworkSizeData
 {
     int numInputNodes = 1;
@@ -56,4 +106,44 @@ struct ParameterManagerData
     int numBestSetsKeptDuringEvolution = 1; /// number of the top parameter sets (sorted by score) copied over from the previous iteration
     int numBestSetsMutatedDuringEvolution = 1; /// number of sets newly created by mutating the best sets from the previous iteration
     int numAddedRandomSetsDuringEvolution = 1; /// number of random sets newly added at each evolution step
+
+    SelectionMethod selectionMethod = SM_FITNESS_PROPORTIONAL; /// how parents are picked for crossover
+    int tournamentSize = 2; /// number of candidates competing per pick, only used for tournament selection
+
+    ParameterPrecision precision = PP_DOUBLE; /// 16-bit formats take a quarter of the memory, but round the stored values
+
+    /// number of the best inactive sets kept in memory (hall of fame); the other inactive sets are removed after each iteration
+    /// -1 keeps all sets, so memory grows with the number of iterations
+    int hallOfFameSize = -1;
+    bool archiveRetiredSets = false; /// if true, removed inactive sets are appended to an archive file instead of being dropped
+};
+
+struct EvolutionStrategiesData
+{
+    double noiseStandardDeviation = 0.1; /// scale of the perturbations applied to the current parameters
+    double learningRate = 0.01; /// step size along the estimated gradient
+    int noiseTableSize = 1 << 20; /// number of values in the shared noise table, needs to be at least the number of parameters
+};
+
+/// island model: several processes each evolve their own population and pass their best sets around in a ring
+struct IslandModelData
+{
+    int numIslands = 1; /// number of processes, 1 disables the island model
+    int islandIndex = 0; /// this process' position in the ring, in [0, numIslands)
+    int migrationInterval = 5; /// number of generations between migrations
+    int numMigrants = 2; /// number of the best sets sent to the next island
+};
+
+/// successive halving: new sets are first scored on a few training boards, and only the best part of them goes on
+/// to be scored on more boards; rung k (of numRungs) uses 1 / reductionFactor^(numRungs - 1 - k) of the boards
+struct SuccessiveHalvingData
+{
+    int numRungs = 1; /// 1 scores every set on all boards
+    int reductionFactor = 2; /// only 1 / reductionFactor of the sets of a rung move on to the next one
+};
+
+struct CmaEsData
+{
+    double initialStepSize = 1; /// standard deviation of the first candidates around the starting parameters
+    bool separable = false; /// if true, only the diagonal of the covariance matrix is adapted (linear instead of quadratic memory and time)
 };
\ No newline at end of file
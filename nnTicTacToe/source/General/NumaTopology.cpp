@@ -0,0 +1,52 @@
+#include "stdafx.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#include "NumaTopology.h"
+
+namespace General
+{
+    int NumaTopology::getNumNodes()
+    {
+#ifdef _WIN32
+        ULONG highestNode = 0;
+        if (GetNumaHighestNodeNumber(&highestNode))
+        {
+            return static_cast<int>(highestNode) + 1;
+        }
+#endif
+
+        return 1;
+    }
+
+    int NumaTopology::getNodeForThread(int threadIndex, int numThreads)
+    {
+        if (numThreads <= 0)
+        {
+            return 0;
+        }
+
+        return static_cast<int>(static_cast<long long>(threadIndex) * getNumNodes() / numThreads);
+    }
+
+    bool NumaTopology::pinCurrentThreadToNode(int node)
+    {
+#ifdef _WIN32
+        GROUP_AFFINITY affinity = {};
+        if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity) || affinity.Mask == 0)
+        {
+            // nodes without processors (memory only)
+            return false;
+        }
+
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#else
+        (void)node;
+        return false;
+#endif
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace General
+{
+    /// NUMA nodes of the machine and thread placement on them
+    /// Only implemented for Windows; other platforms (and machines without NUMA) report a single node and don't pin threads.
+    class NumaTopology
+    {
+    public:
+        static int getNumNodes();
+
+        /// node of the thread with the given index if numThreads threads are spread over all nodes in contiguous blocks
+        static int getNodeForThread(int threadIndex, int numThreads);
+
+        /// restricts the calling thread to the processors of the given node, so memory it touches first is allocated on that node
+        /// returns false if that isn't supported
+        static bool pinCurrentThreadToNode(int node);
+    };
+}
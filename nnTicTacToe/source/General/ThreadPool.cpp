@@ -0,0 +1,174 @@
+#include "stdafx.h"
+
+#include <algorithm>
+
+#include "ThreadPool.h"
+#include "NumaTopology.h"
+
+namespace General
+{
+    // true while the current thread is working on a parallelFor chunk,
+    // so nested calls don't wait for workers that are busy with the outer call
+    thread_local bool t_insideParallelFor = false;
+
+    ThreadPool::ThreadPool(int numThreads, bool pinToNumaNodes)
+        : m_pinToNumaNodes(pinToNumaNodes)
+        , m_nextChunk(0)
+    {
+        if (numThreads <= 0)
+        {
+            numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+
+        if (m_pinToNumaNodes)
+        {
+            NumaTopology::pinCurrentThreadToNode(0);
+        }
+
+        // the calling thread counts as one of the threads
+        for (int k = 1; k < numThreads; k++)
+        {
+            const int node = m_pinToNumaNodes ? NumaTopology::getNodeForThread(k, numThreads) : -1;
+            m_workers.push_back(std::thread(&ThreadPool::workerLoop, this, k, node));
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wakeUp.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::parallelFor(int begin, int end, int minChunkSize, const std::function<void(int, int)>& func)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        const int range = end - begin;
+        minChunkSize = std::max(1, minChunkSize);
+        const int numChunks = std::min(getNumThreads(), (range + minChunkSize - 1) / minChunkSize);
+
+        if (numChunks <= 1 || t_insideParallelFor)
+        {
+            func(begin, end);
+            return;
+        }
+
+        std::unique_lock<std::mutex> submitLock(m_submitMutex, std::try_to_lock);
+        if (!submitLock.owns_lock())
+        {
+            // another thread is using the workers right now
+            func(begin, end);
+            return;
+        }
+
+        Job job;
+        job.func = &func;
+        job.begin = begin;
+        job.end = end;
+        job.chunkSize = (range + numChunks - 1) / numChunks;
+        job.numChunks = (range + job.chunkSize - 1) / job.chunkSize;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = job;
+            m_nextChunk = 0;
+            m_pendingChunks = job.numChunks;
+            m_generation++;
+        }
+
+        m_wakeUp.notify_all();
+
+        processChunks(job, 0);
+
+        // wait until all chunks are done and no worker still looks at this job
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_pendingChunks == 0 && m_activeWorkers == 0; });
+        m_job = Job();
+    }
+
+    void ThreadPool::workerLoop(int threadIndex, int node)
+    {
+        if (node >= 0)
+        {
+            NumaTopology::pinCurrentThreadToNode(node);
+        }
+
+        unsigned int lastGeneration = 0;
+
+        while (true)
+        {
+            Job job;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeUp.wait(lock, [this, lastGeneration]() { return m_stop || m_generation != lastGeneration; });
+
+                if (m_stop)
+                {
+                    return;
+                }
+
+                lastGeneration = m_generation;
+                if (m_job.numChunks == 0)
+                {
+                    // woke up too late, the job is already finished
+                    continue;
+                }
+
+                job = m_job;
+                m_activeWorkers++;
+            }
+
+            processChunks(job, threadIndex);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_activeWorkers--;
+            }
+
+            m_done.notify_all();
+        }
+    }
+
+    void ThreadPool::processChunks(const Job& job, int threadIndex)
+    {
+        t_insideParallelFor = true;
+
+        int numProcessed = 0;
+        while (true)
+        {
+            // pinned threads have a fixed chunk, so each index range always runs on the same node
+            // (every thread takes part in every job, so no chunk is left over)
+            const int chunk = m_pinToNumaNodes ? (numProcessed == 0 ? threadIndex : job.numChunks) : m_nextChunk++;
+            if (chunk >= job.numChunks)
+            {
+                break;
+            }
+
+            const int chunkBegin = job.begin + chunk * job.chunkSize;
+            const int chunkEnd = std::min(chunkBegin + job.chunkSize, job.end);
+            (*job.func)(chunkBegin, chunkEnd);
+            numProcessed++;
+        }
+
+        t_insideParallelFor = false;
+
+        if (numProcessed > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pendingChunks -= numProcessed;
+        }
+    }
+}
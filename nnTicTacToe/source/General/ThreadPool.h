@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace General
+{
+    /// persistent set of worker threads, so parallel work doesn't have to pay for thread creation on every call
+    class ThreadPool
+    {
+    public:
+        /// numThreads: total number of threads used by parallelFor, including the calling thread
+        /// 0 uses the number of hardware threads
+        /// pinToNumaNodes: spreads the threads over the NUMA nodes in contiguous blocks and pins them there (the calling thread
+        /// goes to the first node); parallelFor then always hands the same chunk to the same thread, so each index range stays
+        /// on one node across calls and the memory touched for it is allocated there
+        explicit ThreadPool(int numThreads = 0, bool pinToNumaNodes = false);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+    public:
+        int getNumThreads() const { return static_cast<int>(m_workers.size()) + 1; }
+        bool isPinnedToNumaNodes() const { return m_pinToNumaNodes; }
+
+        /// splits [begin, end) into chunks of at least minChunkSize indices and calls func(chunkBegin, chunkEnd) for each of them.
+        /// The calling thread takes part in the work and the call only returns once all chunks are done.
+        /// Nested calls (or calls while the pool is busy with another caller) are run on the calling thread only.
+        void parallelFor(int begin, int end, int minChunkSize, const std::function<void(int, int)>& func);
+
+    private:
+        struct Job
+        {
+            const std::function<void(int, int)>* func = nullptr;
+            int begin = 0;
+            int end = 0;
+            int chunkSize = 1;
+            int numChunks = 0;
+        };
+
+        /// node: NUMA node the thread is pinned to, -1 to leave it unpinned
+        void workerLoop(int threadIndex, int node);
+
+        /// grabs and processes chunks of the job until none are left
+        /// with pinned threads, only the chunk matching threadIndex (0 for the calling thread) is processed
+        void processChunks(const Job& job, int threadIndex);
+
+    private:
+        std::vector<std::thread> m_workers;
+        bool m_pinToNumaNodes = false;
+
+        std::mutex m_submitMutex; /// held by the thread currently running a parallelFor
+        std::mutex m_mutex;
+        std::condition_variable m_wakeUp;
+        std::condition_variable m_done;
+
+        // job state, guarded by m_mutex (except for the chunk counter)
+        Job m_job;
+        std::atomic<int> m_nextChunk;
+        int m_pendingChunks = 0;
+        int m_activeWorkers = 0;
+        unsigned int m_generation = 0;
+        bool m_stop = false;
+    };
+}
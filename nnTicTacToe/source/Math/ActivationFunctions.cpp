@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include <algorithm>
+#include <cmath>
+#include <vector>
 
 #include "ActivationFunctions.h"
 
@@ -7,6 +9,29 @@ namespace Math
 {
     const double LEAKY_RELU_MULTIPLIER = 0.01;
 
+    // sigmoid lookup table: the interpolation error is bounded by (step width)^2 / 8 * max|sigmoid''| (about 0.0962),
+    // the error of clamping outside the table range by 1 - sigmoid(16) (about 1.1e-7)
+    const double SIGMOID_TABLE_RANGE = 16;
+    const int SIGMOID_TABLE_STEPS_PER_UNIT = 64;
+
+    std::vector<double> createSigmoidTable()
+    {
+        const int numEntries = static_cast<int>(2 * SIGMOID_TABLE_RANGE) * SIGMOID_TABLE_STEPS_PER_UNIT + 1;
+
+        std::vector<double> table;
+        table.reserve(numEntries);
+        for (int k = 0; k < numEntries; k++)
+        {
+            const double val = -SIGMOID_TABLE_RANGE + static_cast<double>(k) / SIGMOID_TABLE_STEPS_PER_UNIT;
+            table.push_back(ActivationFunctions::sigmoid(val));
+        }
+
+        return table;
+    }
+
+    // 2049 entries (16 KB), small enough to stay in the L1 cache
+    const std::vector<double> SIGMOID_TABLE = createSigmoidTable();
+
     double ActivationFunctions::identity(double val, bool derivative)
     {
         if (derivative)
@@ -93,4 +118,47 @@ namespace Math
 
         return val;
     }
+
+    double ActivationFunctions::approximateSigmoid(double val, bool derivative)
+    {
+        if (derivative)
+        {
+            const double result = approximateSigmoid(val, false);
+            return result * (1 - result);
+        }
+
+        if (val <= -SIGMOID_TABLE_RANGE)
+        {
+            return 0;
+        }
+
+        if (val >= SIGMOID_TABLE_RANGE)
+        {
+            return 1;
+        }
+
+        if (std::isnan(val))
+        {
+            return val;
+        }
+
+        // rounding can push values just below the upper limit onto the last entry
+        const double position = (val + SIGMOID_TABLE_RANGE) * SIGMOID_TABLE_STEPS_PER_UNIT;
+        const int index = std::min(static_cast<int>(position), static_cast<int>(SIGMOID_TABLE.size()) - 2);
+        const double fraction = position - index;
+
+        return SIGMOID_TABLE[index] + fraction * (SIGMOID_TABLE[index + 1] - SIGMOID_TABLE[index]);
+    }
+
+    double ActivationFunctions::approximateHyperbolicTan(double val, bool derivative)
+    {
+        if (derivative)
+        {
+            const double result = approximateHyperbolicTan(val, false);
+            return 1 - result * result;
+        }
+
+        // same identity as for the exact version, which doubles the error bound of the sigmoid table
+        return 2 * approximateSigmoid(2 * val) - 1;
+    }
 }
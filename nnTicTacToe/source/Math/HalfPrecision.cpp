@@ -0,0 +1,112 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "HalfPrecision.h"
+
+namespace Math
+{
+    // float bit patterns used by the float16 conversions
+    const uint32_t FLOAT_INFINITY = 0x7f800000;
+    const uint32_t FLOAT16_MAX = 0x477fe000; // 65504
+    const uint32_t FLOAT16_MIN_NORMAL = 113u << 23; // 2^-14
+    const uint32_t FLOAT16_SUBNORMAL_MAGIC = 126u << 23; // 0.5, aligns the subnormal mantissa with the lowest float bits
+    const uint32_t FLOAT16_EXPONENT = 0x7c00u << 13;
+
+    const uint16_t FLOAT16_NAN = 0x7e00;
+    const uint16_t BFLOAT16_QUIET_BIT = 0x0040;
+
+    inline uint32_t toBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline float fromBits(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    uint16_t HalfPrecision::floatToFloat16(float value)
+    {
+        const uint32_t bits = toBits(value);
+        const uint32_t sign = (bits >> 16) & 0x8000;
+        const bool isNan = (bits & 0x7fffffff) > FLOAT_INFINITY;
+        const uint32_t magnitude = std::min(bits & 0x7fffffff, FLOAT16_MAX);
+
+        // normal: rebias the exponent and round the mantissa to 10 bits, ties to even
+        const uint32_t mantissaOdd = (magnitude >> 13) & 1;
+        const uint32_t normal = (magnitude + ((15u - 127u) << 23) + 0xfff + mantissaOdd) >> 13;
+
+        // subnormal: the float addition does the shifting and rounding
+        const uint32_t subnormal = toBits(fromBits(magnitude) + fromBits(FLOAT16_SUBNORMAL_MAGIC)) - FLOAT16_SUBNORMAL_MAGIC;
+
+        const uint32_t result = magnitude < FLOAT16_MIN_NORMAL ? subnormal : normal;
+        return static_cast<uint16_t>(sign | (isNan ? FLOAT16_NAN : result));
+    }
+
+    float HalfPrecision::float16ToFloat(uint16_t value)
+    {
+        const uint32_t shifted = static_cast<uint32_t>(value & 0x7fff) << 13;
+        const uint32_t exponent = shifted & FLOAT16_EXPONENT;
+        const uint32_t rebiased = shifted + ((127u - 15u) << 23);
+
+        // infinity and NaN keep the maximal exponent
+        const uint32_t normal = rebiased + (exponent == FLOAT16_EXPONENT ? (128u - 16u) << 23 : 0);
+
+        // subnormal: let the float subtraction normalize the mantissa
+        const uint32_t subnormal = toBits(fromBits(rebiased + (1u << 23)) - fromBits(FLOAT16_MIN_NORMAL));
+
+        const uint32_t result = exponent == 0 ? subnormal : normal;
+        return fromBits(result | (static_cast<uint32_t>(value & 0x8000) << 16));
+    }
+
+    uint16_t HalfPrecision::floatToBFloat16(float value)
+    {
+        const uint32_t bits = toBits(value);
+        const bool isNan = (bits & 0x7fffffff) > FLOAT_INFINITY;
+        const uint32_t rounded = (bits + 0x7fff + ((bits >> 16) & 1)) >> 16;
+        return static_cast<uint16_t>(isNan ? (bits >> 16) | BFLOAT16_QUIET_BIT : rounded);
+    }
+
+    float HalfPrecision::bFloat16ToFloat(uint16_t value)
+    {
+        return fromBits(static_cast<uint32_t>(value) << 16);
+    }
+
+    void HalfPrecision::toFloat16(const double* values, int numValues, uint16_t* result)
+    {
+        for (int k = 0; k < numValues; k++)
+        {
+            result[k] = floatToFloat16(static_cast<float>(values[k]));
+        }
+    }
+
+    void HalfPrecision::fromFloat16(const uint16_t* values, int numValues, double* result)
+    {
+        for (int k = 0; k < numValues; k++)
+        {
+            result[k] = float16ToFloat(values[k]);
+        }
+    }
+
+    void HalfPrecision::toBFloat16(const double* values, int numValues, uint16_t* result)
+    {
+        for (int k = 0; k < numValues; k++)
+        {
+            result[k] = floatToBFloat16(static_cast<float>(values[k]));
+        }
+    }
+
+    void HalfPrecision::fromBFloat16(const uint16_t* values, int numValues, double* result)
+    {
+        for (int k = 0; k < numValues; k++)
+        {
+            result[k] = bFloat16ToFloat(values[k]);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Math
+{
+    /// conversions between doubles and 16-bit floating point formats
+    /// float16: IEEE 754 half precision (5 exponent bits, 10 mantissa bits), exact up to about 3 decimal digits, range +-65504
+    /// bfloat16: the upper half of a float (8 exponent bits, 7 mantissa bits), the same range as float but only 2-3 decimal digits
+    /// Both round to the nearest representable value (ties to even). The conversions don't branch on the values,
+    /// so the loops over arrays can be vectorized by the compiler.
+    class HalfPrecision
+    {
+    public:
+        /// values beyond the float16 range are clamped to the largest finite value
+        static uint16_t floatToFloat16(float value);
+        static float float16ToFloat(uint16_t value);
+
+        static uint16_t floatToBFloat16(float value);
+        static float bFloat16ToFloat(uint16_t value);
+
+        static void toFloat16(const double* values, int numValues, uint16_t* result);
+        static void fromFloat16(const uint16_t* values, int numValues, double* result);
+
+        static void toBFloat16(const double* values, int numValues, uint16_t* result);
+        static void fromBFloat16(const uint16_t* values, int numValues, double* result);
+    };
+}
@@ -0,0 +1,166 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <numeric>
+
+#include "Lbfgs.h"
+
+namespace Math
+{
+    // sufficient decrease: the value has to drop by at least this fraction of the decrease predicted by the gradient
+    const double SUFFICIENT_DECREASE = 1e-4;
+
+    // the step length is multiplied by this factor after each rejected trial
+    const double BACKTRACKING_FACTOR = 0.5;
+
+    const int MAX_LINE_SEARCH_TRIALS = 30;
+
+    // pairs with (almost) no positive curvature would make the Hessian approximation indefinite
+    const double MIN_RELATIVE_CURVATURE = 1e-10;
+
+    Lbfgs::Lbfgs(int maxHistorySize)
+        : m_maxHistorySize(std::max(1, maxHistorySize))
+    {
+    }
+
+    void Lbfgs::reset()
+    {
+        m_steps.clear();
+        m_gradientChanges.clear();
+        m_curvatures.clear();
+    }
+
+    bool Lbfgs::step(const Objective& objective, std::vector<double>& x, double& value, std::vector<double>& gradient)
+    {
+        assert(x.size() == gradient.size());
+
+        m_numEvaluations = 0;
+        const int numParams = static_cast<int>(x.size());
+
+        std::vector<double> direction;
+        computeDirection(gradient, direction);
+
+        double slope = std::inner_product(gradient.begin(), gradient.end(), direction.begin(), 0.0);
+        if (!(slope < 0))
+        {
+            // the approximation went bad, start over with steepest descent
+            reset();
+            computeDirection(gradient, direction);
+            slope = std::inner_product(gradient.begin(), gradient.end(), direction.begin(), 0.0);
+            if (!(slope < 0))
+            {
+                // zero gradient
+                return false;
+            }
+        }
+
+        // without history, the direction is the plain gradient, whose length says nothing about a good step length
+        double stepLength = 1;
+        if (m_steps.empty())
+        {
+            stepLength = 1 / std::sqrt(-slope);
+        }
+
+        std::vector<double> trialX(numParams);
+        std::vector<double> trialGradient(numParams);
+        for (int trial = 0; trial < MAX_LINE_SEARCH_TRIALS; trial++)
+        {
+            for (int k = 0; k < numParams; k++)
+            {
+                trialX[k] = x[k] + stepLength * direction[k];
+            }
+
+            const double trialValue = objective(trialX, trialGradient);
+            m_numEvaluations++;
+
+            if (trialValue <= value + SUFFICIENT_DECREASE * stepLength * slope)
+            {
+                std::vector<double> step(numParams);
+                std::vector<double> gradientChange(numParams);
+                for (int k = 0; k < numParams; k++)
+                {
+                    step[k] = trialX[k] - x[k];
+                    gradientChange[k] = trialGradient[k] - gradient[k];
+                }
+
+                const double curvature = std::inner_product(step.begin(), step.end(), gradientChange.begin(), 0.0);
+                const double stepNorm = std::sqrt(std::inner_product(step.begin(), step.end(), step.begin(), 0.0));
+                const double changeNorm = std::sqrt(std::inner_product(gradientChange.begin(), gradientChange.end(), gradientChange.begin(), 0.0));
+                if (curvature > MIN_RELATIVE_CURVATURE * stepNorm * changeNorm)
+                {
+                    if (static_cast<int>(m_steps.size()) >= m_maxHistorySize)
+                    {
+                        m_steps.pop_front();
+                        m_gradientChanges.pop_front();
+                        m_curvatures.pop_front();
+                    }
+
+                    m_steps.push_back(std::move(step));
+                    m_gradientChanges.push_back(std::move(gradientChange));
+                    m_curvatures.push_back(1 / curvature);
+                }
+
+                x.swap(trialX);
+                gradient.swap(trialGradient);
+                value = trialValue;
+                return true;
+            }
+
+            stepLength *= BACKTRACKING_FACTOR;
+        }
+
+        return false;
+    }
+
+    void Lbfgs::computeDirection(const std::vector<double>& gradient, std::vector<double>& direction) const
+    {
+        const int numParams = static_cast<int>(gradient.size());
+        const int historySize = getHistorySize();
+
+        direction.resize(numParams);
+        for (int k = 0; k < numParams; k++)
+        {
+            direction[k] = -gradient[k];
+        }
+
+        // newest to oldest
+        std::vector<double> alphas(historySize);
+        for (int h = historySize - 1; h >= 0; h--)
+        {
+            const std::vector<double>& s = m_steps[h];
+            const std::vector<double>& y = m_gradientChanges[h];
+
+            alphas[h] = m_curvatures[h] * std::inner_product(s.begin(), s.end(), direction.begin(), 0.0);
+            for (int k = 0; k < numParams; k++)
+            {
+                direction[k] -= alphas[h] * y[k];
+            }
+        }
+
+        // initial Hessian approximation: scaled identity, matching the curvature of the newest pair
+        if (historySize > 0)
+        {
+            const std::vector<double>& y = m_gradientChanges.back();
+            const double scale = 1 / (m_curvatures.back() * std::inner_product(y.begin(), y.end(), y.begin(), 0.0));
+            for (auto& value : direction)
+            {
+                value *= scale;
+            }
+        }
+
+        // oldest to newest
+        for (int h = 0; h < historySize; h++)
+        {
+            const std::vector<double>& s = m_steps[h];
+            const std::vector<double>& y = m_gradientChanges[h];
+
+            const double beta = m_curvatures[h] * std::inner_product(y.begin(), y.end(), direction.begin(), 0.0);
+            for (int k = 0; k < numParams; k++)
+            {
+                direction[k] += (alphas[h] - beta) * s[k];
+            }
+        }
+    }
+}
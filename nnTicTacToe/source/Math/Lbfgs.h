@@ -0,0 +1,47 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace Math
+{
+    /// limited-memory BFGS minimizer (Nocedal and Wright: "Numerical Optimization", algorithms 7.4 and 7.5)
+    /// The inverse Hessian is approximated from the last few steps and gradient changes, so each step costs
+    /// O(historySize * numParams) on top of the objective evaluations of the line search.
+    class Lbfgs
+    {
+    public:
+        /// returns the value of the objective at x and writes its gradient
+        typedef std::function<double(const std::vector<double>& x, std::vector<double>& gradient)> Objective;
+
+        explicit Lbfgs(int maxHistorySize = 10);
+
+    public:
+        /// one iteration with a backtracking line search (sufficient decrease condition)
+        /// value and gradient need to belong to x; all three are replaced by the accepted point
+        /// returns false (leaving everything unchanged) if no decrease was found along the search direction
+        bool step(const Objective& objective, std::vector<double>& x, double& value, std::vector<double>& gradient);
+
+        /// forgets the curvature history, so the next step is a steepest descent step
+        void reset();
+
+        int getHistorySize() const { return static_cast<int>(m_steps.size()); }
+
+        /// number of objective evaluations of the last call to step
+        int getNumEvaluations() const { return m_numEvaluations; }
+
+    private:
+        /// two-loop recursion: direction = -H * gradient
+        void computeDirection(const std::vector<double>& gradient, std::vector<double>& direction) const;
+
+    private:
+        int m_maxHistorySize;
+        int m_numEvaluations = 0;
+
+        // oldest first
+        std::deque<std::vector<double>> m_steps; /// s = x_new - x_old
+        std::deque<std::vector<double>> m_gradientChanges; /// y = gradient_new - gradient_old
+        std::deque<double> m_curvatures; /// 1 / (y^T s)
+    };
+}
@@ -0,0 +1,105 @@
+#include "stdafx.h"
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+#include "LossFunctions.h"
+
+namespace Math
+{
+    bool LossFunctions::parseLossFunction(const std::string& name, LossFunction& lossFunction)
+    {
+        if (name == "squared_error")
+        {
+            lossFunction = LF_SQUARED_ERROR;
+        }
+        else if (name == "softmax_cross_entropy")
+        {
+            lossFunction = LF_SOFTMAX_CROSS_ENTROPY;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string LossFunctions::getLossFunctionDescription(LossFunction lossFunction)
+    {
+        switch (lossFunction)
+        {
+        case LF_SQUARED_ERROR:         return "squared error";
+        case LF_SOFTMAX_CROSS_ENTROPY: return "softmax cross entropy";
+        default:                       return "";
+        }
+    }
+
+    void LossFunctions::softMax(const double* values, int numValues, int stride, double* result)
+    {
+        assert(numValues > 0);
+
+        double maxValue = values[0];
+        for (int k = 1; k < numValues; k++)
+        {
+            maxValue = std::max(maxValue, values[k * stride]);
+        }
+
+        double sum = 0;
+        for (int k = 0; k < numValues; k++)
+        {
+            const double e = std::exp(values[k * stride] - maxValue);
+            result[k * stride] = e;
+            sum += e;
+        }
+
+        // sum >= 1, since the largest value contributes exp(0)
+        for (int k = 0; k < numValues; k++)
+        {
+            result[k * stride] /= sum;
+        }
+    }
+
+    double LossFunctions::softMaxCrossEntropy(const double* logits, const double* targets, int numValues, int stride, double* gradient)
+    {
+        assert(numValues > 0);
+
+        // online logsumexp: whenever a new maximum shows up, rescale the sum collected so far
+        double maxValue = logits[0];
+        double expSum = 0;
+        double targetSum = 0;
+        double weightedLogitSum = 0;
+
+        for (int k = 0; k < numValues; k++)
+        {
+            const double logit = logits[k * stride];
+            const double target = targets[k * stride];
+
+            if (logit > maxValue)
+            {
+                expSum = expSum * std::exp(maxValue - logit) + 1;
+                maxValue = logit;
+            }
+            else
+            {
+                expSum += std::exp(logit - maxValue);
+            }
+
+            targetSum += target;
+            weightedLogitSum += target * logit;
+        }
+
+        const double logSumExp = maxValue + std::log(expSum);
+
+        if (gradient != nullptr)
+        {
+            for (int k = 0; k < numValues; k++)
+            {
+                const double probability = std::exp(logits[k * stride] - logSumExp);
+                gradient[k * stride] = probability * targetSum - targets[k * stride];
+            }
+        }
+
+        return targetSum * logSumExp - weightedLogitSum;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+#include "General/Globals.h"
+
+namespace Math
+{
+    class LossFunctions
+    {
+    public:
+        /// known names: "squared_error", "softmax_cross_entropy"
+        /// returns false (and leaves lossFunction untouched) for unknown names
+        static bool parseLossFunction(const std::string& name, LossFunction& lossFunction);
+        static std::string getLossFunctionDescription(LossFunction lossFunction);
+
+        /// numerically stable softmax: the largest value is subtracted before exponentiating, so exp can't overflow
+        /// values and result are read and written with the given stride (e.g. one column of a (numValues x batchSize) matrix)
+        static void softMax(const double* values, int numValues, int stride, double* result);
+
+        /// computes the cross entropy of softmax(logits) against the target distribution and its derivative with respect to the logits:
+        /// loss = -sum(t_k * log(p_k)) = sum(t) * logsumexp(logits) - sum(t_k * logit_k)
+        /// gradient_k = p_k * sum(t) - t_k (simplifies to p_k - t_k for normalized targets)
+        /// The loss is computed in a single pass with a running maximum, so it stays finite even if some p_k underflow.
+        /// Writing the gradient takes one more pass; gradient may be nullptr if only the loss is needed.
+        static double softMaxCrossEntropy(const double* logits, const double* targets, int numValues, int stride, double* gradient);
+    };
+}
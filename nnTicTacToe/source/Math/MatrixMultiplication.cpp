@@ -0,0 +1,246 @@
+#include "stdafx.h"
+#include <algorithm>
+#include <vector>
+
+#include "MatrixMultiplication.h"
+
+namespace Math
+{
+    // register block: size of the block of C that is kept in registers by the micro kernel
+    const int MR = 4;
+    const int NR = 8;
+
+    // cache blocks: a packed (MC x KC) panel of A should stay in L2,
+    // a packed (KC x NR) sliver of B should stay in L1
+    const int MC = 128;
+    const int KC = 256;
+    const int NC = 2048;
+
+    // below this number of multiply-adds, packing costs more than it saves
+    const long long MIN_BLOCKED_OPERATIONS = 32 * 32 * 32;
+
+    void MatrixMultiplication::gemm(bool transposeA, bool transposeB, int m, int n, int k,
+                                    double alpha, const double* a, int lda, const double* b, int ldb,
+                                    double beta, double* c, int ldc)
+    {
+        if (m <= 0 || n <= 0)
+        {
+            return;
+        }
+
+        // scale (or clear) C first, so the kernels only ever have to accumulate
+        if (beta != 1)
+        {
+            for (int i = 0; i < m; i++)
+            {
+                double* row = c + i * ldc;
+                if (beta == 0)
+                {
+                    std::fill(row, row + n, 0.0);
+                }
+                else
+                {
+                    for (int j = 0; j < n; j++)
+                    {
+                        row[j] *= beta;
+                    }
+                }
+            }
+        }
+
+        if (k <= 0 || alpha == 0)
+        {
+            return;
+        }
+
+        // a single row or column of C is a matrix-vector product,
+        // which is bound by memory bandwidth and doesn't profit from blocking
+        const long long numOperations = static_cast<long long>(m) * n * k;
+        if (m < MR || n < NR || numOperations < MIN_BLOCKED_OPERATIONS)
+        {
+            gemmUnblocked(transposeA, transposeB, m, n, k, alpha, a, lda, b, ldb, c, ldc);
+            return;
+        }
+
+        gemmBlocked(transposeA, transposeB, m, n, k, alpha, a, lda, b, ldb, c, ldc);
+    }
+
+    void MatrixMultiplication::gemmUnblocked(bool transposeA, bool transposeB, int m, int n, int k,
+                                             double alpha, const double* a, int lda, const double* b, int ldb,
+                                             double* c, int ldc)
+    {
+        for (int i = 0; i < m; i++)
+        {
+            double* cRow = c + i * ldc;
+
+            if (transposeB)
+            {
+                // each entry is a dot product of two contiguous rows (if A is not transposed)
+                for (int j = 0; j < n; j++)
+                {
+                    const double* bRow = b + j * ldb;
+                    double sum = 0;
+
+                    if (transposeA)
+                    {
+                        for (int p = 0; p < k; p++)
+                        {
+                            sum += a[p * lda + i] * bRow[p];
+                        }
+                    }
+                    else
+                    {
+                        const double* aRow = a + i * lda;
+                        for (int p = 0; p < k; p++)
+                        {
+                            sum += aRow[p] * bRow[p];
+                        }
+                    }
+
+                    cRow[j] += alpha * sum;
+                }
+            }
+            else
+            {
+                // accumulate scaled rows of B, so the innermost loop runs over contiguous memory
+                for (int p = 0; p < k; p++)
+                {
+                    const double aip = alpha * (transposeA ? a[p * lda + i] : a[i * lda + p]);
+                    if (aip == 0)
+                    {
+                        continue;
+                    }
+
+                    const double* bRow = b + p * ldb;
+                    for (int j = 0; j < n; j++)
+                    {
+                        cRow[j] += aip * bRow[j];
+                    }
+                }
+            }
+        }
+    }
+
+    void MatrixMultiplication::gemmBlocked(bool transposeA, bool transposeB, int m, int n, int k,
+                                           double alpha, const double* a, int lda, const double* b, int ldb,
+                                           double* c, int ldc)
+    {
+        // packing buffers are reused between calls (one set per thread)
+        thread_local std::vector<double> packedA;
+        thread_local std::vector<double> packedB;
+
+        packedA.resize(MC * KC);
+        packedB.resize(KC * NC);
+
+        for (int jc = 0; jc < n; jc += NC)
+        {
+            const int nc = std::min(NC, n - jc);
+
+            for (int pc = 0; pc < k; pc += KC)
+            {
+                const int kc = std::min(KC, k - pc);
+
+                const double* bBlock = transposeB ? (b + jc * ldb + pc) : (b + pc * ldb + jc);
+                packB(transposeB, kc, nc, bBlock, ldb, packedB.data());
+
+                for (int ic = 0; ic < m; ic += MC)
+                {
+                    const int mc = std::min(MC, m - ic);
+
+                    const double* aBlock = transposeA ? (a + pc * lda + ic) : (a + ic * lda + pc);
+                    packA(transposeA, mc, kc, alpha, aBlock, lda, packedA.data());
+
+                    for (int jr = 0; jr < nc; jr += NR)
+                    {
+                        const int nr = std::min(NR, nc - jr);
+                        const double* bPanel = packedB.data() + jr * kc;
+
+                        for (int ir = 0; ir < mc; ir += MR)
+                        {
+                            const int mr = std::min(MR, mc - ir);
+                            const double* aPanel = packedA.data() + ir * kc;
+
+                            microKernel(kc, aPanel, bPanel, c + (ic + ir) * ldc + (jc + jr), ldc, mr, nr);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void MatrixMultiplication::packA(bool transposeA, int mc, int kc, double alpha, const double* a, int lda, double* packed)
+    {
+        // store A in panels of MR rows, column by column within each panel
+        // rows beyond mc are padded with zeros so the micro kernel doesn't need to special-case them
+        for (int ir = 0; ir < mc; ir += MR)
+        {
+            const int mr = std::min(MR, mc - ir);
+
+            for (int p = 0; p < kc; p++)
+            {
+                for (int i = 0; i < MR; i++)
+                {
+                    double value = 0;
+                    if (i < mr)
+                    {
+                        value = alpha * (transposeA ? a[p * lda + ir + i] : a[(ir + i) * lda + p]);
+                    }
+
+                    *packed++ = value;
+                }
+            }
+        }
+    }
+
+    void MatrixMultiplication::packB(bool transposeB, int kc, int nc, const double* b, int ldb, double* packed)
+    {
+        // store B in panels of NR columns, row by row within each panel
+        for (int jr = 0; jr < nc; jr += NR)
+        {
+            const int nr = std::min(NR, nc - jr);
+
+            for (int p = 0; p < kc; p++)
+            {
+                for (int j = 0; j < NR; j++)
+                {
+                    double value = 0;
+                    if (j < nr)
+                    {
+                        value = transposeB ? b[(jr + j) * ldb + p] : b[p * ldb + jr + j];
+                    }
+
+                    *packed++ = value;
+                }
+            }
+        }
+    }
+
+    void MatrixMultiplication::microKernel(int kc, const double* packedA, const double* packedB, double* c, int ldc, int mr, int nr)
+    {
+        double acc[MR][NR] = {};
+
+        for (int p = 0; p < kc; p++)
+        {
+            for (int i = 0; i < MR; i++)
+            {
+                const double aip = packedA[i];
+                for (int j = 0; j < NR; j++)
+                {
+                    acc[i][j] += aip * packedB[j];
+                }
+            }
+
+            packedA += MR;
+            packedB += NR;
+        }
+
+        for (int i = 0; i < mr; i++)
+        {
+            double* cRow = c + i * ldc;
+            for (int j = 0; j < nr; j++)
+            {
+                cRow[j] += acc[i][j];
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+namespace Math
+{
+    class MatrixMultiplication
+    {
+    public:
+        /// general matrix multiplication for row-major matrices:
+        /// C = alpha * op(A) * op(B) + beta * C
+        /// where op(A) is an (m x k) matrix, op(B) is an (k x n) matrix and C is an (m x n) matrix.
+        /// If transposeA (transposeB) is true, A (B) is stored transposed, i.e. as a (k x m) ((n x k)) matrix.
+        /// lda, ldb and ldc are the row strides of the matrices as they are stored.
+        static void gemm(bool transposeA, bool transposeB, int m, int n, int k,
+                         double alpha, const double* a, int lda, const double* b, int ldb,
+                         double beta, double* c, int ldc);
+
+    private:
+        /// straightforward loops for small or vector-shaped problems, where packing doesn't pay off
+        static void gemmUnblocked(bool transposeA, bool transposeB, int m, int n, int k,
+                                  double alpha, const double* a, int lda, const double* b, int ldb,
+                                  double* c, int ldc);
+
+        /// cache-blocked multiplication with packed panels of A and B
+        static void gemmBlocked(bool transposeA, bool transposeB, int m, int n, int k,
+                                double alpha, const double* a, int lda, const double* b, int ldb,
+                                double* c, int ldc);
+
+        static void packA(bool transposeA, int mc, int kc, double alpha, const double* a, int lda, double* packed);
+        static void packB(bool transposeB, int kc, int nc, const double* b, int ldb, double* packed);
+
+        /// computes an (MR x NR) block of C from a packed A panel and a packed B panel
+        /// only the top-left (mr x nr) entries are written back to C
+        static void microKernel(int kc, const double* packedA, const double* packedB, double* c, int ldc, int mr, int nr);
+    };
+}
@@ -0,0 +1,63 @@
+#include "stdafx.h"
+
+#include <assert.h>
+
+#include "NoiseTable.h"
+
+namespace Math
+{
+    // number of slices added per pass over the result
+    const int SLICES_PER_PASS = 4;
+
+    void NoiseTable::create(RandomGenerator& generator, int size)
+    {
+        m_values.resize(size);
+        Random::fillNormal(generator, m_values.data(), size, 0, 1);
+    }
+
+    int NoiseTable::sampleOffset(RandomGenerator& generator, int sliceLength) const
+    {
+        assert(sliceLength <= size());
+
+        const int numOffsets = size() - sliceLength + 1;
+        return static_cast<int>(generator() % static_cast<uint64_t>(numOffsets));
+    }
+
+    void NoiseTable::addWeightedSum(const std::vector<int>& offsets, const std::vector<double>& weights, int sliceLength, double* result) const
+    {
+        assert(offsets.size() == weights.size());
+
+        const int numSlices = static_cast<int>(offsets.size());
+
+        // several slices per pass, so the result is loaded and stored less often;
+        // the inner loops don't depend on previous iterations, so the compiler turns them into vector instructions
+        int i = 0;
+        for (; i + SLICES_PER_PASS <= numSlices; i += SLICES_PER_PASS)
+        {
+            const double* slice0 = getSlice(offsets[i]);
+            const double* slice1 = getSlice(offsets[i + 1]);
+            const double* slice2 = getSlice(offsets[i + 2]);
+            const double* slice3 = getSlice(offsets[i + 3]);
+            const double weight0 = weights[i];
+            const double weight1 = weights[i + 1];
+            const double weight2 = weights[i + 2];
+            const double weight3 = weights[i + 3];
+
+            for (int k = 0; k < sliceLength; k++)
+            {
+                result[k] += weight0 * slice0[k] + weight1 * slice1[k] + weight2 * slice2[k] + weight3 * slice3[k];
+            }
+        }
+
+        for (; i < numSlices; i++)
+        {
+            const double* slice = getSlice(offsets[i]);
+            const double weight = weights[i];
+
+            for (int k = 0; k < sliceLength; k++)
+            {
+                result[k] += weight * slice[k];
+            }
+        }
+    }
+}
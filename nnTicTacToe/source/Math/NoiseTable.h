@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include "Random.h"
+
+namespace Math
+{
+    /// large block of normally distributed values shared by all perturbations
+    /// A perturbation is a slice of the table, so it is fully described by its offset
+    /// and doesn't have to be stored (or generated) as a vector of its own.
+    class NoiseTable
+    {
+    public:
+        NoiseTable() = default;
+
+    public:
+        /// fills the table with size values drawn from the standard normal distribution
+        void create(RandomGenerator& generator, int size);
+
+        int size() const { return static_cast<int>(m_values.size()); }
+
+        /// sliceLength values starting at offset
+        const double* getSlice(int offset) const { return m_values.data() + offset; }
+
+        /// random offset such that a slice of sliceLength values stays within the table
+        int sampleOffset(RandomGenerator& generator, int sliceLength) const;
+
+        /// result[k] += sum over i of weights[i] * getSlice(offsets[i])[k], for k in [0, sliceLength)
+        void addWeightedSum(const std::vector<int>& offsets, const std::vector<double>& weights, int sliceLength, double* result) const;
+
+    private:
+        std::vector<double> m_values;
+    };
+}
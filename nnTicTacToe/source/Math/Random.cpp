@@ -0,0 +1,182 @@
+#include "stdafx.h"
+
+#include <assert.h>
+#include <atomic>
+#include <cmath>
+#include <random>
+
+#include "Random.h"
+
+namespace Math
+{
+    // 0 means that no master seed has been picked yet
+    std::atomic<uint64_t> s_masterSeed(0);
+
+    // incremented whenever the master seed changes, so thread generators know they're outdated
+    std::atomic<int> s_seedGeneration(0);
+    std::atomic<int> s_nextThreadStream(0);
+
+    struct ThreadGenerator
+    {
+        RandomGenerator generator;
+        int seedGeneration = -1;
+    };
+
+    thread_local ThreadGenerator t_generator;
+
+    const double TWO_PI = 6.283185307179586;
+
+    uint64_t splitMix64(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t rotateLeft(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    RandomGenerator::RandomGenerator(uint64_t seed)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            m_state[k] = splitMix64(seed);
+        }
+    }
+
+    RandomGenerator::result_type RandomGenerator::operator()()
+    {
+        const uint64_t result = rotateLeft(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotateLeft(m_state[3], 45);
+
+        return result;
+    }
+
+    void RandomGenerator::jump()
+    {
+        static const uint64_t JUMP[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+        uint64_t s0 = 0;
+        uint64_t s1 = 0;
+        uint64_t s2 = 0;
+        uint64_t s3 = 0;
+
+        for (int i = 0; i < 4; i++)
+        {
+            for (int b = 0; b < 64; b++)
+            {
+                if (JUMP[i] & (1ull << b))
+                {
+                    s0 ^= m_state[0];
+                    s1 ^= m_state[1];
+                    s2 ^= m_state[2];
+                    s3 ^= m_state[3];
+                }
+
+                (*this)();
+            }
+        }
+
+        m_state[0] = s0;
+        m_state[1] = s1;
+        m_state[2] = s2;
+        m_state[3] = s3;
+    }
+
+    void Random::setMasterSeed(uint64_t seed)
+    {
+        while (seed == 0)
+        {
+            std::random_device rd;
+            seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+        }
+
+        s_masterSeed = seed;
+        s_nextThreadStream = 0;
+        s_seedGeneration++;
+    }
+
+    uint64_t Random::getMasterSeed()
+    {
+        if (s_masterSeed == 0)
+        {
+            uint64_t seed = 0;
+            while (seed == 0)
+            {
+                std::random_device rd;
+                seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+            }
+
+            // another thread may have been faster, in which case its seed is kept
+            uint64_t expected = 0;
+            s_masterSeed.compare_exchange_strong(expected, seed);
+        }
+
+        return s_masterSeed;
+    }
+
+    RandomGenerator& Random::getGenerator()
+    {
+        const int seedGeneration = s_seedGeneration;
+        if (t_generator.seedGeneration != seedGeneration)
+        {
+            // stream k of the master seed, streams are 2^128 values apart
+            RandomGenerator generator(getMasterSeed());
+            const int streamIndex = s_nextThreadStream++;
+            for (int k = 0; k < streamIndex; k++)
+            {
+                generator.jump();
+            }
+
+            t_generator.generator = generator;
+            t_generator.seedGeneration = seedGeneration;
+        }
+
+        return t_generator.generator;
+    }
+
+    RandomGenerator Random::createStream(uint64_t streamIndex)
+    {
+        // mix the stream index into the seed, so streams of the same master seed are unrelated
+        // (but never identical to the thread streams, which use the master seed as is)
+        uint64_t state = streamIndex;
+        return RandomGenerator(getMasterSeed() ^ (splitMix64(state) | 1));
+    }
+
+    void Random::fillUniform(RandomGenerator& generator, double* values, int numValues, double min, double max)
+    {
+        assert(min <= max);
+
+        const double range = max - min;
+        for (int k = 0; k < numValues; k++)
+        {
+            values[k] = min + generator.nextDouble() * range;
+        }
+    }
+
+    void Random::fillNormal(RandomGenerator& generator, double* values, int numValues, double mean, double standardDeviation)
+    {
+        for (int k = 0; k < numValues; k += 2)
+        {
+            // 1 - u is in (0, 1], so the log is finite
+            const double radius = std::sqrt(-2 * std::log(1 - generator.nextDouble())) * standardDeviation;
+            const double angle = TWO_PI * generator.nextDouble();
+
+            values[k] = mean + radius * std::cos(angle);
+            if (k + 1 < numValues)
+            {
+                values[k + 1] = mean + radius * std::sin(angle);
+            }
+        }
+    }
+}
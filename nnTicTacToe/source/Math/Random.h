@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace Math
+{
+    /// xoshiro256** generator: 32 bytes of state, a few cycles per 64-bit value
+    /// satisfies the UniformRandomBitGenerator requirements, so it works with the std distributions
+    class RandomGenerator
+    {
+    public:
+        typedef uint64_t result_type;
+
+        /// the state is expanded from the seed with splitmix64, so similar seeds still give unrelated sequences
+        explicit RandomGenerator(uint64_t seed = 0);
+
+    public:
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()();
+
+        /// uniform in [0, 1)
+        double nextDouble() { return ((*this)() >> 11) * (1.0 / 9007199254740992.0); }
+
+        /// advances the state by 2^128 values, i.e. switches to the next of 2^128 non-overlapping streams
+        void jump();
+
+    private:
+        uint64_t m_state[4];
+    };
+
+    /// central source of random numbers
+    /// All generators derive from one master seed, so runs with the same (non-zero) seed are reproducible.
+    class Random
+    {
+    public:
+        /// a seed of 0 picks a random master seed
+        /// resets the generators of all threads the next time they are used
+        static void setMasterSeed(uint64_t seed);
+        static uint64_t getMasterSeed();
+
+        /// the calling thread's generator
+        /// threads get consecutive streams in the order in which they first ask for one;
+        /// use createStream for draws that need to be reproducible no matter which thread executes them
+        static RandomGenerator& getGenerator();
+
+        /// generator for stream streamIndex of the master seed (e.g. one stream per child in a parallel loop)
+        static RandomGenerator createStream(uint64_t streamIndex);
+
+        /// uniform values in [min, max)
+        static void fillUniform(RandomGenerator& generator, double* values, int numValues, double min, double max);
+        static void fillUniform(double* values, int numValues, double min, double max) { fillUniform(getGenerator(), values, numValues, min, max); }
+
+        /// normally distributed values (Box-Muller, two values per pair of uniform values)
+        static void fillNormal(RandomGenerator& generator, double* values, int numValues, double mean, double standardDeviation);
+        static void fillNormal(double* values, int numValues, double mean, double standardDeviation) { fillNormal(getGenerator(), values, numValues, mean, standardDeviation); }
+    };
+}
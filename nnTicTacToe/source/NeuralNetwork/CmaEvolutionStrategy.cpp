@@ -0,0 +1,324 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <numeric>
+
+#include "CmaEvolutionStrategy.h"
+#include "Math/MatrixMultiplication.h"
+#include "Math/Random.h"
+
+namespace NeuralNetwork
+{
+    using namespace Math;
+
+    void CmaEvolutionStrategy::setup(const std::vector<double>& mean, double stepSize, int populationSize, bool separable)
+    {
+        assert(populationSize >= 2);
+
+        const int n = static_cast<int>(mean.size());
+        m_numParams = n;
+        m_populationSize = populationSize;
+        m_numParents = populationSize / 2;
+        m_separable = separable;
+
+        // log-linearly decreasing weights for the better half of the candidates
+        m_weights.resize(m_numParents);
+        for (int i = 0; i < m_numParents; i++)
+        {
+            m_weights[i] = std::log((populationSize + 1) * 0.5) - std::log(i + 1.0);
+        }
+
+        const double weightSum = std::accumulate(m_weights.begin(), m_weights.end(), 0.0);
+        double squaredWeightSum = 0;
+        for (auto& weight : m_weights)
+        {
+            weight /= weightSum;
+            squaredWeightSum += weight * weight;
+        }
+
+        // default strategy parameters from the tutorial
+        const double mueff = 1 / squaredWeightSum;
+        m_effectiveNumParents = mueff;
+        m_pathDecayC = (4 + mueff / n) / (n + 4 + 2 * mueff / n);
+        m_pathDecaySigma = (mueff + 2) / (n + mueff + 5);
+        m_rankOneRate = 2 / ((n + 1.3) * (n + 1.3) + mueff);
+        m_rankMuRate = 2 * (mueff - 2 + 1 / mueff) / ((n + 2.0) * (n + 2.0) + mueff);
+        if (m_separable)
+        {
+            // the diagonal has far fewer degrees of freedom, so it can be learned much faster
+            m_rankOneRate *= (n + 2) / 3.0;
+            m_rankMuRate *= (n + 2) / 3.0;
+        }
+
+        m_rankOneRate = std::min(1.0, m_rankOneRate);
+        m_rankMuRate = std::min(1 - m_rankOneRate, m_rankMuRate);
+        m_damping = 1 + 2 * std::max(0.0, std::sqrt((mueff - 1) / (n + 1)) - 1) + m_pathDecaySigma;
+        m_expectedNormalNorm = std::sqrt(n) * (1 - 1.0 / (4 * n) + 1.0 / (21.0 * n * n));
+
+        m_mean = mean;
+        m_stepSize = stepSize;
+        m_pathC.assign(n, 0.0);
+        m_pathSigma.assign(n, 0.0);
+        m_generation = 0;
+
+        if (m_separable)
+        {
+            m_covariance.assign(n, 1.0);
+        }
+        else
+        {
+            m_covariance.assign(static_cast<size_t>(n) * n, 0.0);
+            for (int i = 0; i < n; i++)
+            {
+                m_covariance[static_cast<size_t>(i) * n + i] = 1;
+            }
+        }
+
+        m_transform = m_covariance;
+
+        const size_t populationValues = static_cast<size_t>(populationSize) * n;
+        m_normalSamples.assign(populationValues, 0.0);
+        m_steps.assign(populationValues, 0.0);
+        m_candidates.assign(populationValues, 0.0);
+    }
+
+    void CmaEvolutionStrategy::samplePopulation()
+    {
+        const uint64_t firstStreamIndex = m_nextStreamIndex;
+        m_nextStreamIndex += m_populationSize;
+
+        auto sample = [this, firstStreamIndex](int begin, int end)
+        {
+            sampleCandidates(begin, end, firstStreamIndex);
+        };
+
+        if (m_threadPool)
+        {
+            m_threadPool->parallelFor(0, m_populationSize, 1, sample);
+        }
+        else
+        {
+            sample(0, m_populationSize);
+        }
+    }
+
+    void CmaEvolutionStrategy::sampleCandidates(int begin, int end, uint64_t firstStreamIndex)
+    {
+        const int n = m_numParams;
+
+        // one stream per candidate, so the result doesn't depend on how the candidates are split between threads
+        for (int k = begin; k < end; k++)
+        {
+            RandomGenerator generator = Random::createStream(firstStreamIndex + k);
+            Random::fillNormal(generator, m_normalSamples.data() + static_cast<size_t>(k) * n, n, 0, 1);
+        }
+
+        const double* samples = m_normalSamples.data() + static_cast<size_t>(begin) * n;
+        double* steps = m_steps.data() + static_cast<size_t>(begin) * n;
+        const int numRows = end - begin;
+
+        if (m_separable)
+        {
+            for (int k = 0; k < numRows; k++)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    steps[k * n + i] = m_transform[i] * samples[k * n + i];
+                }
+            }
+        }
+        else
+        {
+            // every row of the steps is the lower triangular factor times a row of the samples
+            MatrixMultiplication::gemm(false, true, numRows, n, n, 1.0, samples, n, m_transform.data(), n, 0.0, steps, n);
+        }
+
+        double* candidates = m_candidates.data() + static_cast<size_t>(begin) * n;
+        for (int k = 0; k < numRows; k++)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                candidates[k * n + i] = m_mean[i] + m_stepSize * steps[k * n + i];
+            }
+        }
+    }
+
+    void CmaEvolutionStrategy::update(const std::vector<double>& scores)
+    {
+        assert(static_cast<int>(scores.size()) == m_populationSize);
+
+        const int n = m_numParams;
+
+        // best candidates first, ties are broken by index so the order is reproducible
+        std::vector<int> order(m_populationSize);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&scores](int a, int b) { return scores[a] > scores[b]; });
+
+        // weighted means of the best steps and of the samples they were created from
+        std::vector<double> meanStep(n, 0.0);
+        std::vector<double> meanSample(n, 0.0);
+        for (int p = 0; p < m_numParents; p++)
+        {
+            const double* step = m_steps.data() + static_cast<size_t>(order[p]) * n;
+            const double* sample = m_normalSamples.data() + static_cast<size_t>(order[p]) * n;
+            const double weight = m_weights[p];
+
+            for (int i = 0; i < n; i++)
+            {
+                meanStep[i] += weight * step[i];
+                meanSample[i] += weight * sample[i];
+            }
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            m_mean[i] += m_stepSize * meanStep[i];
+        }
+
+        // evolution paths
+        const double mueff = m_effectiveNumParents;
+        const double sigmaPathFactor = std::sqrt(m_pathDecaySigma * (2 - m_pathDecaySigma) * mueff);
+        double sigmaPathNorm = 0;
+        for (int i = 0; i < n; i++)
+        {
+            m_pathSigma[i] = (1 - m_pathDecaySigma) * m_pathSigma[i] + sigmaPathFactor * meanSample[i];
+            sigmaPathNorm += m_pathSigma[i] * m_pathSigma[i];
+        }
+
+        sigmaPathNorm = std::sqrt(sigmaPathNorm);
+        m_generation++;
+
+        // stall the covariance path while the step size grows quickly, so the covariance matrix doesn't expand too fast
+        const double pathCorrection = std::sqrt(1 - std::pow(1 - m_pathDecaySigma, 2 * m_generation));
+        const bool useCovariancePath = sigmaPathNorm / pathCorrection / m_expectedNormalNorm < 1.4 + 2.0 / (n + 1);
+
+        const double covariancePathFactor = useCovariancePath ? std::sqrt(m_pathDecayC * (2 - m_pathDecayC) * mueff) : 0;
+        for (int i = 0; i < n; i++)
+        {
+            m_pathC[i] = (1 - m_pathDecayC) * m_pathC[i] + covariancePathFactor * meanStep[i];
+        }
+
+        // covariance matrix: rank-one update from the path, rank-mu update from the best steps
+        double oldFactor = 1 - m_rankOneRate - m_rankMuRate;
+        if (!useCovariancePath)
+        {
+            oldFactor += m_rankOneRate * m_pathDecayC * (2 - m_pathDecayC);
+        }
+
+        if (m_separable)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                double rankMu = 0;
+                for (int p = 0; p < m_numParents; p++)
+                {
+                    const double step = m_steps[static_cast<size_t>(order[p]) * n + i];
+                    rankMu += m_weights[p] * step * step;
+                }
+
+                m_covariance[i] = oldFactor * m_covariance[i] + m_rankOneRate * m_pathC[i] * m_pathC[i] + m_rankMuRate * rankMu;
+            }
+        }
+        else
+        {
+            // sum of w_p * y_p * y_p^T as a single product of the (sqrt(w_p)-scaled) steps with themselves
+            std::vector<double> scaledSteps(static_cast<size_t>(m_numParents) * n);
+            for (int p = 0; p < m_numParents; p++)
+            {
+                const double* step = m_steps.data() + static_cast<size_t>(order[p]) * n;
+                const double scale = std::sqrt(m_weights[p]);
+                for (int i = 0; i < n; i++)
+                {
+                    scaledSteps[static_cast<size_t>(p) * n + i] = scale * step[i];
+                }
+            }
+
+            MatrixMultiplication::gemm(true, false, n, n, m_numParents, m_rankMuRate, scaledSteps.data(), n, scaledSteps.data(), n, oldFactor, m_covariance.data(), n);
+
+            for (int i = 0; i < n; i++)
+            {
+                const double scaledPath = m_rankOneRate * m_pathC[i];
+                double* row = m_covariance.data() + static_cast<size_t>(i) * n;
+                for (int j = 0; j < n; j++)
+                {
+                    row[j] += scaledPath * m_pathC[j];
+                }
+            }
+        }
+
+        // longer paths than expected for random selection mean consecutive steps point the same way, so larger steps are better
+        m_stepSize *= std::exp((m_pathDecaySigma / m_damping) * (sigmaPathNorm / m_expectedNormalNorm - 1));
+
+        updateTransform();
+    }
+
+    void CmaEvolutionStrategy::updateTransform()
+    {
+        const int n = m_numParams;
+
+        if (m_separable)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                m_transform[i] = std::sqrt(m_covariance[i]);
+            }
+
+            return;
+        }
+
+        std::vector<double> factor(m_covariance);
+        if (choleskyDecomposition(factor, n))
+        {
+            m_transform.swap(factor);
+            return;
+        }
+
+        // rounding errors made the matrix indefinite: keep the previous factor and the covariance matrix belonging to it
+        MatrixMultiplication::gemm(false, true, n, n, n, 1.0, m_transform.data(), n, m_transform.data(), n, 0.0, m_covariance.data(), n);
+    }
+
+    bool CmaEvolutionStrategy::choleskyDecomposition(std::vector<double>& matrix, int numRows)
+    {
+        assert(static_cast<int>(matrix.size()) == numRows * numRows);
+
+        const int n = numRows;
+        for (int j = 0; j < n; j++)
+        {
+            double* rowJ = matrix.data() + static_cast<size_t>(j) * n;
+
+            double diagonal = rowJ[j];
+            for (int k = 0; k < j; k++)
+            {
+                diagonal -= rowJ[k] * rowJ[k];
+            }
+
+            if (!(diagonal > 0))
+            {
+                return false;
+            }
+
+            diagonal = std::sqrt(diagonal);
+            rowJ[j] = diagonal;
+
+            for (int i = j + 1; i < n; i++)
+            {
+                double* rowI = matrix.data() + static_cast<size_t>(i) * n;
+
+                double value = rowI[j];
+                for (int k = 0; k < j; k++)
+                {
+                    value -= rowI[k] * rowJ[k];
+                }
+
+                rowI[j] = value / diagonal;
+            }
+
+            // clear the upper triangle
+            std::fill(rowJ + j + 1, rowJ + n, 0.0);
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "General/ThreadPool.h"
+
+namespace NeuralNetwork
+{
+    /// covariance matrix adaptation evolution strategy (CMA-ES, see Hansen: "The CMA Evolution Strategy: A Tutorial")
+    /// Candidates are drawn from a normal distribution around the mean. After each generation, the mean, the step size
+    /// and the covariance matrix are adapted so that candidates similar to the best ones become more likely. Scores are maximized.
+    /// The full covariance matrix takes numParams^2 values and is factorized once per generation; the separable variant
+    /// (sep-CMA-ES, Ros and Hansen 2008) only adapts the diagonal, so memory and time per candidate stay linear.
+    class CmaEvolutionStrategy
+    {
+    public:
+        CmaEvolutionStrategy() = default;
+
+    public:
+        /// candidates are sampled in parallel on this pool (nullptr: on the calling thread)
+        void setThreadPool(const std::shared_ptr<General::ThreadPool>& threadPool) { m_threadPool = threadPool; }
+
+        /// resets the distribution to mean and stepSize^2 * identity
+        /// populationSize is the number of candidates per generation (at least 2), the better half of them is used for the updates
+        void setup(const std::vector<double>& mean, double stepSize, int populationSize, bool separable);
+
+        /// draws a new generation of candidates from the current distribution
+        void samplePopulation();
+
+        /// scores[k] belongs to candidate k of the last sampled generation
+        void update(const std::vector<double>& scores);
+
+        int getNumParams() const { return m_numParams; }
+        int getPopulationSize() const { return m_populationSize; }
+        bool isSeparable() const { return m_separable; }
+        const std::vector<double>& getMean() const { return m_mean; }
+        double getStepSize() const { return m_stepSize; }
+
+        /// getNumParams() values of candidate k of the last sampled generation
+        const double* getCandidate(int k) const { return m_candidates.data() + static_cast<size_t>(k) * m_numParams; }
+
+        /// replaces the (row-major, symmetric) numRows x numRows matrix by its lower triangular Cholesky factor L (with L * L^T = matrix)
+        /// returns false (leaving the matrix partially overwritten) if it isn't positive definite
+        static bool choleskyDecomposition(std::vector<double>& matrix, int numRows);
+
+    private:
+        /// draws candidates [begin, end), each from its own random stream
+        void sampleCandidates(int begin, int end, uint64_t firstStreamIndex);
+
+        /// recomputes m_transform from m_covariance
+        void updateTransform();
+
+    private:
+        int m_numParams = 0;
+        int m_populationSize = 0;
+        int m_numParents = 0; /// number of best candidates used for the updates
+        bool m_separable = false;
+
+        // strategy parameters, derived from the number of parameters and the population size
+        std::vector<double> m_weights; /// recombination weights of the best candidates (best first, summing up to 1)
+        double m_effectiveNumParents = 1; /// variance effective selection mass
+        double m_pathDecayC = 0; /// learning rate of the evolution path for the covariance matrix
+        double m_pathDecaySigma = 0; /// learning rate of the evolution path for the step size
+        double m_rankOneRate = 0;
+        double m_rankMuRate = 0;
+        double m_damping = 1; /// damping of the step size updates
+        double m_expectedNormalNorm = 1; /// expected length of a standard normally distributed vector
+
+        // state
+        std::vector<double> m_mean;
+        double m_stepSize = 1;
+        std::vector<double> m_pathC;
+        std::vector<double> m_pathSigma;
+        std::vector<double> m_covariance; /// numParams x numParams, or only its diagonal if separable
+        std::vector<double> m_transform; /// Cholesky factor of the covariance matrix, or square roots of the diagonal if separable
+        int m_generation = 0;
+        uint64_t m_nextStreamIndex = 0;
+
+        // last sampled generation (populationSize x numParams each)
+        std::vector<double> m_normalSamples; /// z: standard normally distributed
+        std::vector<double> m_steps; /// y = transform * z, distributed according to the covariance matrix
+        std::vector<double> m_candidates; /// mean + stepSize * y
+
+        std::shared_ptr<General::ThreadPool> m_threadPool;
+    };
+}
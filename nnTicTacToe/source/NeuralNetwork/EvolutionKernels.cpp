@@ -0,0 +1,78 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "EvolutionKernels.h"
+
+namespace NeuralNetwork
+{
+    using namespace Math;
+
+    // one random 64-bit value decides the parents of this many parameters
+    const int CROSSOVER_BLOCK_SIZE = 64;
+
+    void EvolutionKernels::mutate(RandomGenerator& generator, const double* parent, int numParams, const MutationSettings& settings, double* child)
+    {
+        std::copy(parent, parent + numParams, child);
+        applyMutations(generator, child, numParams, settings);
+    }
+
+    void EvolutionKernels::crossover(RandomGenerator& generator, const double* parent1, const double* parent2, int numParams, const MutationSettings& settings, double* child)
+    {
+        for (int blockStart = 0; blockStart < numParams; blockStart += CROSSOVER_BLOCK_SIZE)
+        {
+            const uint64_t bits = generator();
+            const int blockSize = std::min(CROSSOVER_BLOCK_SIZE, numParams - blockStart);
+
+            // branch-free select, so the compiler can vectorize the loop
+            for (int k = 0; k < blockSize; k++)
+            {
+                const bool useSecond = ((bits >> k) & 1) != 0;
+                child[blockStart + k] = useSecond ? parent2[blockStart + k] : parent1[blockStart + k];
+            }
+        }
+
+        applyMutations(generator, child, numParams, settings);
+    }
+
+    void EvolutionKernels::applyMutations(RandomGenerator& generator, double* params, int numParams, const MutationSettings& settings)
+    {
+        const double range = settings.maxValue - settings.minValue;
+
+        // getMutatedValue checks for a replacement first and only adds a bonus to values that weren't replaced.
+        // Adding the bonuses first and letting replacements overwrite them results in the same distribution.
+        if (settings.bonusChance > 0 && settings.bonusScale != 0)
+        {
+            const double logMissChance = std::log1p(-std::min(settings.bonusChance, 1.0));
+            for (int k = getNumSkipped(generator, logMissChance); k < numParams; k += 1 + getNumSkipped(generator, logMissChance))
+            {
+                const double bonus = (settings.minValue + generator.nextDouble() * range) * settings.bonusScale;
+                params[k] = std::min(settings.maxValue, std::max(settings.minValue, params[k] + bonus));
+            }
+        }
+
+        if (settings.replacementChance > 0)
+        {
+            const double logMissChance = std::log1p(-std::min(settings.replacementChance, 1.0));
+            for (int k = getNumSkipped(generator, logMissChance); k < numParams; k += 1 + getNumSkipped(generator, logMissChance))
+            {
+                params[k] = settings.minValue + generator.nextDouble() * range;
+            }
+        }
+    }
+
+    int EvolutionKernels::getNumSkipped(RandomGenerator& generator, double logMissChance)
+    {
+        // a chance of 1 never skips anything
+        if (logMissChance == -HUGE_VAL)
+        {
+            return 0;
+        }
+
+        // 1 - u is in (0, 1], so the log is finite
+        const double numSkipped = std::floor(std::log(1 - generator.nextDouble()) / logMissChance);
+        return numSkipped < INT_MAX / 2 ? static_cast<int>(numSkipped) : INT_MAX / 2;
+    }
+}
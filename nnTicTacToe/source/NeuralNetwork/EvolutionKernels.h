@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Math/Random.h"
+
+namespace NeuralNetwork
+{
+    struct MutationSettings
+    {
+        double minValue = -1; /// replacement values are picked within [minValue, maxValue)
+        double maxValue = 1;
+        double replacementChance = 0; /// per parameter
+        double bonusChance = 0; /// per parameter
+        double bonusScale = 1; /// a bonus is a random value within [minValue, maxValue) times this scale
+    };
+
+    /// create whole child parameter sets in one pass each, with the same result distribution as
+    /// ParameterManager::getMutatedValue applied to each parameter
+    class EvolutionKernels
+    {
+    public:
+        /// child = parent, then mutated
+        static void mutate(Math::RandomGenerator& generator, const double* parent, int numParams, const MutationSettings& settings, double* child);
+
+        /// uniform crossover (each value picked from either parent with the same chance), then mutated
+        static void crossover(Math::RandomGenerator& generator, const double* parent1, const double* parent2, int numParams, const MutationSettings& settings, double* child);
+
+        /// mutations are rare, so instead of drawing a chance for every parameter,
+        /// the distance to the next mutated parameter is drawn from the geometric distribution.
+        /// Bonus values are clamped to [minValue, maxValue].
+        static void applyMutations(Math::RandomGenerator& generator, double* params, int numParams, const MutationSettings& settings);
+
+    private:
+        /// number of parameters skipped before the next one that gets mutated with the given chance (in (0, 1))
+        static int getNumSkipped(Math::RandomGenerator& generator, double logMissChance);
+    };
+}
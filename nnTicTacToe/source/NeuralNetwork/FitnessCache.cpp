@@ -0,0 +1,93 @@
+#include "stdafx.h"
+
+#include <cstring>
+
+#include "FitnessCache.h"
+
+namespace NeuralNetwork
+{
+    // splitmix64 finalizer: every input bit affects every output bit
+    uint64_t mixBits(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    uint64_t FitnessCache::computeHash(const std::vector<double>& params)
+    {
+        // chained, so the order of the values matters as well
+        uint64_t hash = mixBits(params.size());
+        for (auto value : params)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            hash = mixBits(hash ^ bits) + 0x9E3779B97F4A7C15ull;
+        }
+
+        return hash;
+    }
+
+    uint64_t FitnessCache::computeHash(const std::vector<int>& values)
+    {
+        uint64_t hash = mixBits(values.size());
+        for (auto value : values)
+        {
+            hash = mixBits(hash ^ static_cast<uint32_t>(value)) + 0x9E3779B97F4A7C15ull;
+        }
+
+        return hash;
+    }
+
+    void FitnessCache::setCapacity(int capacity)
+    {
+        m_capacity = capacity > 0 ? capacity : 0;
+        dropOldestEntries();
+    }
+
+    void FitnessCache::insert(uint64_t hash, const Entry& entry)
+    {
+        if (!isEnabled())
+        {
+            return;
+        }
+
+        auto found = m_entries.find(hash);
+        if (found != m_entries.end())
+        {
+            found->second = entry;
+            return;
+        }
+
+        m_entries.emplace(hash, entry);
+        m_insertionOrder.push_back(hash);
+        dropOldestEntries();
+    }
+
+    bool FitnessCache::find(uint64_t hash, Entry& entry) const
+    {
+        const auto found = m_entries.find(hash);
+        if (found == m_entries.end())
+        {
+            return false;
+        }
+
+        entry = found->second;
+        return true;
+    }
+
+    void FitnessCache::clear()
+    {
+        m_entries.clear();
+        m_insertionOrder.clear();
+    }
+
+    void FitnessCache::dropOldestEntries()
+    {
+        while (static_cast<int>(m_insertionOrder.size()) > m_capacity)
+        {
+            m_entries.erase(m_insertionOrder.front());
+            m_insertionOrder.pop_front();
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace NeuralNetwork
+{
+    /// scores of parameter vectors that have already been evaluated, so identical vectors (e.g. crossover children
+    /// that equal one of their parents) don't need to be evaluated again.
+    /// The vectors are identified by a 64-bit hash of their exact bit patterns instead of being stored;
+    /// once the capacity is reached, the oldest entries are dropped first.
+    class FitnessCache
+    {
+    public:
+        struct Entry
+        {
+            int id = -1; /// the set the score was computed for (which may have been removed since)
+            double score = 0;
+            double error = -1;
+        };
+
+    public:
+        FitnessCache() = default;
+
+    public:
+        /// the same values (bit by bit) always give the same hash, but 0.0 and -0.0 differ
+        static uint64_t computeHash(const std::vector<double>& params);
+
+        /// same for integer sequences, e.g. the moves a network picks (its policy fingerprint)
+        static uint64_t computeHash(const std::vector<int>& values);
+
+        /// a capacity of 0 disables the cache; lowering it drops the oldest entries
+        void setCapacity(int capacity);
+        int getCapacity() const { return m_capacity; }
+        bool isEnabled() const { return m_capacity > 0; }
+
+        /// replaces the entry of an already known hash (without making it any younger)
+        void insert(uint64_t hash, const Entry& entry);
+
+        /// returns false if nothing is stored for the hash
+        bool find(uint64_t hash, Entry& entry) const;
+
+        int size() const { return static_cast<int>(m_entries.size()); }
+        void clear();
+
+    private:
+        void dropOldestEntries();
+
+    private:
+        int m_capacity = 0;
+        std::unordered_map<uint64_t, Entry> m_entries;
+        std::deque<uint64_t> m_insertionOrder; /// oldest first
+    };
+}
@@ -1,7 +1,10 @@
 #include "stdafx.h"
 
 #include "FileIO/FileManager.h"
+#include "General/ThreadPool.h"
 #include "Math/ActivationFunctions.h"
+#include "Math/LossFunctions.h"
+#include "Math/MatrixMultiplication.h"
 #include "NodeNetwork.h"
 
 #include <assert.h> 
@@ -10,8 +13,12 @@
 namespace NeuralNetwork
 {
     using namespace FileIO;
+    using namespace General;
     using namespace Math;
 
+    // lower bound for the number of nodes handled by one thread, so the threads don't fight over the same cache lines
+    const int MIN_PARALLEL_NODES_PER_THREAD = 16;
+
     // --------------------------
     // NodeNetwork
     // --------------------------
@@ -31,6 +38,11 @@ namespace NeuralNetwork
         }
 
         m_hiddenLayers.clear();
+
+        m_denseLayers.clear();
+        m_layerValues.clear();
+        m_layerBaseValues.clear();
+        m_batchSize = 0;
     }
 
     bool NodeNetwork::createNetwork(const NetworkSizeData& sizeData, const std::string& activationFunctionType)
@@ -69,12 +81,16 @@ namespace NeuralNetwork
 
         m_outputLayer = createInnerLayer(sizeData.numOutputNodes, prevLayer);
 
+        updateDenseLayers();
+
         describeNetwork();
         return true;
     }
 
     void NodeNetwork::assignActivationFunction(const std::string &activationFunctionType)
     {
+        m_activationFunctionName = activationFunctionType;
+
         if (activationFunctionType.find("relu") != std::string::npos)
         {
             if (activationFunctionType.find("leak") != std::string::npos)
@@ -91,13 +107,29 @@ namespace NeuralNetwork
         }
         else if (activationFunctionType.find("tan") != std::string::npos)
         {
-            m_activationFunction = ActivationFunctions::hyperbolicTan;
-            m_activationFunctionType = "hyperbolic tan (tanh)";
+            if (m_useApproximateActivation)
+            {
+                m_activationFunction = ActivationFunctions::approximateHyperbolicTan;
+                m_activationFunctionType = "hyperbolic tan (tanh), approximated";
+            }
+            else
+            {
+                m_activationFunction = ActivationFunctions::hyperbolicTan;
+                m_activationFunctionType = "hyperbolic tan (tanh)";
+            }
         }
         else if (activationFunctionType.find("sigm") != std::string::npos)
         {
-            m_activationFunction = ActivationFunctions::sigmoid;
-            m_activationFunctionType = "sigmoid";
+            if (m_useApproximateActivation)
+            {
+                m_activationFunction = ActivationFunctions::approximateSigmoid;
+                m_activationFunctionType = "sigmoid, approximated";
+            }
+            else
+            {
+                m_activationFunction = ActivationFunctions::sigmoid;
+                m_activationFunctionType = "sigmoid";
+            }
         }
         else
         {
@@ -106,6 +138,30 @@ namespace NeuralNetwork
         }
     }
 
+    void NodeNetwork::setUseApproximateActivation(bool useApproximation)
+    {
+        m_useApproximateActivation = useApproximation;
+        assignActivationFunction(m_activationFunctionName);
+    }
+
+    void NodeNetwork::setThreadPool(const std::shared_ptr<ThreadPool>& threadPool, int minParallelLayerWidth)
+    {
+        m_threadPool = threadPool;
+        m_minParallelLayerWidth = minParallelLayerWidth;
+    }
+
+    void NodeNetwork::forEachNodeBlock(int numNodes, const std::function<void(int, int)>& func) const
+    {
+        // small layers are faster on a single thread than with the synchronization overhead
+        if (!m_threadPool || m_minParallelLayerWidth <= 0 || numNodes < m_minParallelLayerWidth)
+        {
+            func(0, numNodes);
+            return;
+        }
+
+        m_threadPool->parallelFor(0, numNodes, MIN_PARALLEL_NODES_PER_THREAD, func);
+    }
+
     Layer NodeNetwork::createInnerLayer(int numNodes, const Layer& previousLayer)
     {
         assert(numNodes > 0);
@@ -169,6 +225,15 @@ namespace NeuralNetwork
         return true;
     }
 
+    void NodeNetwork::getInputValues(std::vector<double>& inputValues) const
+    {
+        inputValues.resize(m_inputLayer.size());
+        for (unsigned int k = 0; k < m_inputLayer.size(); k++)
+        {
+            inputValues[k] = m_inputLayer[k]->getValue();
+        }
+    }
+
     bool NodeNetwork::assignParameters(const std::vector<double>& params)
     {
         std::queue<double> qParams;
@@ -210,9 +275,71 @@ namespace NeuralNetwork
             }
         }
 
+        updateDenseLayers();
         return true;
     }
 
+    void NodeNetwork::updateDenseLayers()
+    {
+        std::vector<double> params;
+        getParameters(params);
+
+        m_denseLayers.clear();
+
+        int numInputs = static_cast<int>(m_inputLayer.size());
+        std::vector<int> layerSizes;
+        for (const auto& layer : m_hiddenLayers)
+        {
+            layerSizes.push_back(static_cast<int>(layer.size()));
+        }
+        layerSizes.push_back(static_cast<int>(m_outputLayer.size()));
+
+        // parameters are ordered by node: first the weights of all input edges, then the bias
+        int offset = 0;
+        for (auto numNodes : layerSizes)
+        {
+            DenseLayer dense;
+            dense.numInputs = numInputs;
+            dense.numNodes = numNodes;
+            dense.weights.reserve(numNodes * numInputs);
+            dense.biases.reserve(numNodes);
+
+            for (int n = 0; n < numNodes; n++)
+            {
+                dense.weights.insert(dense.weights.end(), params.begin() + offset, params.begin() + offset + numInputs);
+                offset += numInputs;
+                dense.biases.push_back(params[offset++]);
+            }
+
+            m_denseLayers.push_back(dense);
+            numInputs = numNodes;
+        }
+
+        assert(offset == params.size());
+
+        // force the value buffers to be rebuilt for the new layout
+        m_batchSize = 0;
+    }
+
+    void NodeNetwork::resizeLayerValues(int batchSize)
+    {
+        if (batchSize == m_batchSize && m_layerValues.size() == m_denseLayers.size() + 1)
+        {
+            return;
+        }
+
+        m_batchSize = batchSize;
+        m_layerValues.resize(m_denseLayers.size() + 1);
+        m_layerBaseValues.resize(m_denseLayers.size() + 1);
+
+        m_layerValues[0].assign(m_inputLayer.size() * batchSize, 0.0);
+        for (unsigned int k = 0; k < m_denseLayers.size(); k++)
+        {
+            m_layerValues[k + 1].assign(m_denseLayers[k].numNodes * batchSize, 0.0);
+            m_layerBaseValues[k + 1].assign(m_denseLayers[k].numNodes * batchSize, 0.0);
+        }
+    }
+
     void NodeNetwork::getParameters(std::vector<double>& params) const
     {
         params.clear();
@@ -233,24 +360,122 @@ namespace NeuralNetwork
 
     bool NodeNetwork::computeValues()
     {
-        // starting at the input layer and moving towards the output layer, update each node
-        for (auto& layer : m_hiddenLayers)
+        resizeLayerValues(1);
+
+        for (unsigned int k = 0; k < m_inputLayer.size(); k++)
         {
-            for (auto& node : layer)
+            m_layerValues[0][k] = m_inputLayer[k]->getValue();
+        }
+
+        computeDenseValues();
+
+        // write the results back into the nodes
+        for (unsigned int k = 0; k < m_hiddenLayers.size(); k++)
+        {
+            for (unsigned int n = 0; n < m_hiddenLayers[k].size(); n++)
             {
-                (*node).updateValue(m_activationFunction);
+                m_hiddenLayers[k][n]->setValue(m_layerValues[k + 1][n]);
             }
         }
 
-        // don't apply activation function to output layer
-        for (auto& node : m_outputLayer)
+        if (!m_outputLayer.empty())
         {
-            (*node).updateValue(ActivationFunctions::identity);
+            const auto& outputValues = m_layerValues.back();
+            for (unsigned int n = 0; n < m_outputLayer.size(); n++)
+            {
+                m_outputLayer[n]->setValue(outputValues[n]);
+            }
         }
 
         return true;
     }
 
+    bool NodeNetwork::computeValues(const std::vector<std::vector<double>>& inputValues, std::vector<std::vector<double>>& outputValues)
+    {
+        assert(!m_inputLayer.empty());
+
+        outputValues.clear();
+        if (inputValues.empty())
+        {
+            return true;
+        }
+
+        const int batchSize = static_cast<int>(inputValues.size());
+        resizeLayerValues(batchSize);
+
+        // transpose the samples into the (numInputs x batchSize) input matrix
+        auto& inputMatrix = m_layerValues[0];
+        for (int s = 0; s < batchSize; s++)
+        {
+            if (inputValues[s].size() != m_inputLayer.size())
+            {
+                std::ostringstream buffer;
+                buffer << "Mismatch between number of input values (" << inputValues[s].size() << ") and input nodes (" << m_inputLayer.size() << ") for sample " << s << "!";
+                PRINT_ERROR(buffer);
+                return false;
+            }
+
+            for (unsigned int k = 0; k < m_inputLayer.size(); k++)
+            {
+                inputMatrix[k * batchSize + s] = inputValues[s][k];
+            }
+        }
+
+        computeDenseValues();
+
+        const auto& outputMatrix = m_layerValues.back();
+        const int numOutputs = static_cast<int>(m_outputLayer.size());
+
+        outputValues.resize(batchSize);
+        for (int s = 0; s < batchSize; s++)
+        {
+            outputValues[s].resize(numOutputs);
+            for (int n = 0; n < numOutputs; n++)
+            {
+                outputValues[s][n] = outputMatrix[n * batchSize + s];
+            }
+        }
+
+        return true;
+    }
+
+    void NodeNetwork::computeDenseValues()
+    {
+        const int numLayers = static_cast<int>(m_denseLayers.size());
+        for (int k = 0; k < numLayers; k++)
+        {
+            const DenseLayer& layer = m_denseLayers[k];
+            const auto& inputs = m_layerValues[k];
+            auto& baseValues = m_layerBaseValues[k + 1];
+            auto& values = m_layerValues[k + 1];
+
+            // don't apply activation function to output layer
+            const auto& activationFunction = (k == numLayers - 1) ? ActivationFunctions::identity : m_activationFunction;
+
+            // each node only depends on its own row of the weight matrix, so wide layers are split by nodes
+            forEachNodeBlock(layer.numNodes, [&](int firstNode, int lastNode)
+            {
+                const int firstValue = firstNode * m_batchSize;
+                const int lastValue = lastNode * m_batchSize;
+
+                // start with the biases, then add the weighted input values for all samples at once
+                for (int n = firstNode; n < lastNode; n++)
+                {
+                    std::fill(baseValues.begin() + n * m_batchSize, baseValues.begin() + (n + 1) * m_batchSize, layer.biases[n]);
+                }
+
+                MatrixMultiplication::gemm(false, false, lastNode - firstNode, m_batchSize, layer.numInputs,
+                                           1.0, layer.weights.data() + firstNode * layer.numInputs, layer.numInputs, inputs.data(), m_batchSize,
+                                           1.0, baseValues.data() + firstValue, m_batchSize);
+
+                for (int v = firstValue; v < lastValue; v++)
+                {
+                    values[v] = activationFunction(baseValues[v], false);
+                }
+            });
+        }
+    }
+
     int NodeNetwork::getOutputValues(std::vector<double>& outputValues, bool applySoftMax) const
     {
         assert(!m_inputLayer.empty());
@@ -259,30 +484,20 @@ namespace NeuralNetwork
         outputValues.clear();
 
         int bestIndex = 0;
-        double softMaxSum = 0;
         for (int k = 0; k < m_outputLayer.size(); k++)
         {
-            double value = m_outputLayer[k]->getValue();
+            const double value = m_outputLayer[k]->getValue();
             if (value > m_outputLayer[bestIndex]->getValue())
             {
                 bestIndex = k;
             }
 
-            if (applySoftMax)
-            {
-                value = std::exp(value);
-                softMaxSum += value;
-            }
-
             outputValues.push_back(value);
         }
 
         if (applySoftMax)
         {
-            for (auto& val : outputValues)
-            {
-                val /= softMaxSum;
-            }
+            LossFunctions::softMax(outputValues.data(), static_cast<int>(outputValues.size()), 1, outputValues.data());
         }
 
         return bestIndex;
@@ -303,55 +518,190 @@ namespace NeuralNetwork
 
     void NodeNetwork::handleBackpropagation(const std::vector<double>& targetValues, std::vector<double>& parameterAdjustments)
     {
-        // during the backpropagation, all parameters get overwritten with their adjustment values, so
-        // we need to backup the real parameters
-        std::vector<double> initialParameters;
-        getParameters(initialParameters);
+        assert(m_outputLayer.size() == targetValues.size());
 
-        // do backpropagation for output layer
-        std::vector<double> inputAdjustments;
-        handleBackpropagation(m_outputLayer, targetValues, ActivationFunctions::identity, inputAdjustments);
+        // make sure the stored values match the current input values and parameters
+        computeValues();
 
-        // compute average input adjustment
-        for (auto& val : inputAdjustments)
+        // derivative of the squared error (see Node::getError)
+        const auto& outputValues = m_layerValues.back();
+        std::vector<double> errorDerivatives(targetValues.size());
+        for (unsigned int k = 0; k < targetValues.size(); k++)
         {
-            val /= m_outputLayer.size();
+            errorDerivatives[k] = 2 * (outputValues[k] - targetValues[k]);
         }
 
-        // do backpropagation for hidden layers
-        for (int k = static_cast<int>(m_hiddenLayers.size()) - 1; k >= 0; k--)
+        handleDenseBackpropagation(errorDerivatives, parameterAdjustments);
+    }
+
+    void NodeNetwork::handleBackpropagation(const std::vector<std::vector<double>>& targetValues, std::vector<double>& parameterAdjustments)
+    {
+        assert(static_cast<int>(targetValues.size()) == m_batchSize);
+
+        const auto& outputValues = m_layerValues.back();
+        const int numOutputs = static_cast<int>(m_outputLayer.size());
+
+        std::vector<double> errorDerivatives(numOutputs * m_batchSize);
+        for (int s = 0; s < m_batchSize; s++)
         {
-            std::vector<double> innerNodeTargetValues;
-            for (unsigned int n = 0; n < m_hiddenLayers[k].size(); n++)
+            assert(targetValues[s].size() == numOutputs);
+            for (int n = 0; n < numOutputs; n++)
             {
-                const auto& node = m_hiddenLayers[k][n];
-                innerNodeTargetValues.push_back(node->getValue() + inputAdjustments[n]);
+                const int index = n * m_batchSize + s;
+                errorDerivatives[index] = 2 * (outputValues[index] - targetValues[s][n]);
             }
+        }
+
+        handleDenseBackpropagation(errorDerivatives, parameterAdjustments);
+    }
+
+    double NodeNetwork::getSoftMaxCrossEntropyError(const std::vector<double>& targetValues) const
+    {
+        assert(m_outputLayer.size() == targetValues.size());
+
+        std::vector<double> outputValues;
+        getOutputValues(outputValues);
 
-            handleBackpropagation(m_hiddenLayers[k], innerNodeTargetValues, m_activationFunction, inputAdjustments);
+        return LossFunctions::softMaxCrossEntropy(outputValues.data(), targetValues.data(), static_cast<int>(outputValues.size()), 1, nullptr);
+    }
+
+    double NodeNetwork::handleSoftMaxCrossEntropyBackpropagation(const std::vector<double>& targetValues, std::vector<double>& parameterAdjustments)
+    {
+        assert(m_outputLayer.size() == targetValues.size());
+
+        // make sure the stored values match the current input values and parameters
+        computeValues();
+
+        const auto& outputValues = m_layerValues.back();
+        std::vector<double> errorDerivatives(targetValues.size());
+        const double loss = LossFunctions::softMaxCrossEntropy(outputValues.data(), targetValues.data(), static_cast<int>(targetValues.size()), 1, errorDerivatives.data());
+
+        handleDenseBackpropagation(errorDerivatives, parameterAdjustments);
+        return loss;
+    }
+
+    double NodeNetwork::handleSoftMaxCrossEntropyBackpropagation(const std::vector<std::vector<double>>& targetValues, std::vector<double>& parameterAdjustments)
+    {
+        assert(static_cast<int>(targetValues.size()) == m_batchSize);
+
+        const auto& outputValues = m_layerValues.back();
+        const int numOutputs = static_cast<int>(m_outputLayer.size());
 
-            // compute average input adjustment
-            for (auto& val : inputAdjustments)
+        // targets in the same (numOutputs x batchSize) layout as the output values
+        std::vector<double> targetMatrix(numOutputs * m_batchSize);
+        for (int s = 0; s < m_batchSize; s++)
+        {
+            assert(targetValues[s].size() == numOutputs);
+            for (int n = 0; n < numOutputs; n++)
             {
-                val /= m_hiddenLayers[k].size();
+                targetMatrix[n * m_batchSize + s] = targetValues[s][n];
             }
         }
 
-        getParameters(parameterAdjustments);
+        // each sample is one column of the output matrix
+        double loss = 0;
+        std::vector<double> errorDerivatives(numOutputs * m_batchSize);
+        for (int s = 0; s < m_batchSize; s++)
+        {
+            loss += LossFunctions::softMaxCrossEntropy(outputValues.data() + s, targetMatrix.data() + s, numOutputs, m_batchSize, errorDerivatives.data() + s);
+        }
 
-        // write back the real parameters
-        assignParameters(initialParameters);
+        handleDenseBackpropagation(errorDerivatives, parameterAdjustments);
+        return loss;
     }
 
-    void NodeNetwork::handleBackpropagation(Layer& layer, const std::vector<double>& targetValues, std::function<double(double, bool)> activationFunction, std::vector<double>& inputAdjustments)
+    void NodeNetwork::handleDenseBackpropagation(std::vector<double>& outputErrorDerivatives, std::vector<double>& parameterAdjustments)
     {
-        assert(targetValues.size() == layer.size());
+        int numParameters = 0;
+        for (const auto& layer : m_denseLayers)
+        {
+            numParameters += layer.numNodes * (layer.numInputs + 1);
+        }
+
+        parameterAdjustments.assign(numParameters, 0.0);
 
-        inputAdjustments.clear();
-        for (unsigned int k = 0; k < layer.size(); k++)
+        std::vector<double> errorDerivatives;
+        errorDerivatives.swap(outputErrorDerivatives);
+
+        std::vector<double> multipliers;
+        std::vector<double> inputAdjustments;
+
+        // parameters are ordered from the first hidden layer to the output layer,
+        // so fill in the adjustment values from the back
+        int offset = numParameters;
+        const int numLayers = static_cast<int>(m_denseLayers.size());
+        for (int k = numLayers - 1; k >= 0; k--)
         {
-            layer[k]->handleBackpropagation(targetValues[k], activationFunction, inputAdjustments);
+            const DenseLayer& layer = m_denseLayers[k];
+            const auto& baseValues = m_layerBaseValues[k + 1];
+            const auto& inputValues = m_layerValues[k];
+
+            // no activation function on the output layer
+            const auto& activationFunction = (k == numLayers - 1) ? ActivationFunctions::identity : m_activationFunction;
+
+            multipliers.resize(baseValues.size());
+            for (unsigned int v = 0; v < baseValues.size(); v++)
+            {
+                multipliers[v] = activationFunction(baseValues[v], true) * errorDerivatives[v];
+            }
+
+            const int stride = layer.numInputs + 1;
+            offset -= layer.numNodes * stride;
+            double* adjustments = parameterAdjustments.data() + offset;
+
+            forEachNodeBlock(layer.numNodes, [&](int firstNode, int lastNode)
+            {
+                // edge weight adjustments: multipliers * (input values)^T, summed over all samples
+                MatrixMultiplication::gemm(false, true, lastNode - firstNode, layer.numInputs, m_batchSize,
+                                           1.0, multipliers.data() + firstNode * m_batchSize, m_batchSize, inputValues.data(), m_batchSize,
+                                           0.0, adjustments + firstNode * stride, stride);
+
+                // bias adjustments
+                for (int n = firstNode; n < lastNode; n++)
+                {
+                    double sum = 0;
+                    for (int s = 0; s < m_batchSize; s++)
+                    {
+                        sum += multipliers[n * m_batchSize + s];
+                    }
+
+                    adjustments[n * stride + layer.numInputs] = sum;
+                }
+            });
+
+            if (k == 0)
+            {
+                break;
+            }
+
+            // average input adjustment: weights^T * multipliers / #nodes
+            // (split by the nodes of the previous layer, each of them only needs one column of the weight matrix)
+            // for the exact gradient, the sum weights^T * multipliers already is the derivative with respect to the inputs
+            const double inputAdjustmentScale = m_useExactGradient ? 1.0 : 1.0 / layer.numNodes;
+            inputAdjustments.resize(layer.numInputs * m_batchSize);
+            forEachNodeBlock(layer.numInputs, [&](int firstInput, int lastInput)
+            {
+                MatrixMultiplication::gemm(true, false, lastInput - firstInput, m_batchSize, layer.numNodes,
+                                           inputAdjustmentScale, layer.weights.data() + firstInput, layer.numInputs, multipliers.data(), m_batchSize,
+                                           0.0, inputAdjustments.data() + firstInput * m_batchSize, m_batchSize);
+            });
+
+            if (m_useExactGradient)
+            {
+                errorDerivatives.swap(inputAdjustments);
+                continue;
+            }
+
+            // the target value of a hidden node is its current value plus the input adjustment,
+            // so the derived error 2 * (value - target) simplifies to -2 * adjustment
+            errorDerivatives.resize(inputAdjustments.size());
+            for (unsigned int v = 0; v < inputAdjustments.size(); v++)
+            {
+                errorDerivatives[v] = -2 * inputAdjustments[v];
+            }
         }
+
+        assert(offset == 0);
     }
 
     void NodeNetwork::describeNetwork() const
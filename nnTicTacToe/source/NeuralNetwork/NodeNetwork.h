@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <queue>
 #include <vector>
@@ -7,12 +8,26 @@
 #include "General/Globals.h"
 #include "Node.h"
 
+namespace General
+{
+    class ThreadPool;
+}
+
 namespace NeuralNetwork
 {
     class Node;
 
     typedef std::vector<std::shared_ptr<Node>> Layer;
 
+    /// dense copy of the parameters of one inner layer, so it can be evaluated with matrix multiplications
+    struct DenseLayer
+    {
+        int numInputs = 0;
+        int numNodes = 0;
+        std::vector<double> weights; /// (numNodes x numInputs), row-major
+        std::vector<double> biases; /// one per node
+    };
+
     class NodeNetworkInterface
     {
     public:
@@ -46,6 +61,17 @@ namespace NeuralNetwork
         bool createNetwork(const NetworkSizeData& sizeData, const std::string& activationFunctionType = "none") override;
         void assignActivationFunction(const std::string &activationFunctionType);
 
+        /// if true, sigmoid and tanh use the table-based approximations (see ActivationFunctions::approximateSigmoid)
+        /// only meant for inference, since backpropagation is based on the values of the forward pass
+        void setUseApproximateActivation(bool useApproximation);
+
+        /// if true, backpropagation returns the exact gradient of the loss (as needed by gradient based optimizers like L-BFGS);
+        /// by default, the errors passed on to the hidden layers are averaged over the nodes of the following layer instead
+        void setUseExactGradient(bool useExactGradient) { m_useExactGradient = useExactGradient; }
+
+        /// values of the input nodes (as assigned by assignInputValues)
+        void getInputValues(std::vector<double>& inputValues) const;
+
         void destroyNetwork() override;
 
         bool assignInputValues(const std::vector<double>& inputValues) override;
@@ -56,20 +82,68 @@ namespace NeuralNetwork
         int getOutputValues(std::vector<double>& outputValues, bool applySoftMax = false) const override;
         double getTotalError(const std::vector<double>& targetValues) const override;
         void handleBackpropagation(const std::vector<double>& targetValues, std::vector<double>& parameterAdjustments) override;
-        void handleBackpropagation(Layer& layer, const std::vector<double>& targetValues, std::function<double(double, bool)> activationFunction, std::vector<double>& inputAdjustments);
+
+        /// batched versions: each entry of the outer vector is one sample
+        bool computeValues(const std::vector<std::vector<double>>& inputValues, std::vector<std::vector<double>>& outputValues);
+
+        /// uses the samples of the last batched computeValues call
+        /// the adjustment values are summed up over all samples
+        void handleBackpropagation(const std::vector<std::vector<double>>& targetValues, std::vector<double>& parameterAdjustments);
+
+        /// softmax cross entropy of the output values against a target distribution (see LossFunctions::softMaxCrossEntropy)
+        double getSoftMaxCrossEntropyError(const std::vector<double>& targetValues) const;
+
+        /// backpropagation of the softmax cross entropy loss; the loss and its output layer gradient are computed in one go
+        /// returns the loss
+        double handleSoftMaxCrossEntropyBackpropagation(const std::vector<double>& targetValues, std::vector<double>& parameterAdjustments);
+
+        /// batched version, uses the samples of the last batched computeValues call
+        /// returns the loss summed up over all samples (like the adjustment values)
+        double handleSoftMaxCrossEntropyBackpropagation(const std::vector<std::vector<double>>& targetValues, std::vector<double>& parameterAdjustments);
 
     public:
         int getNumParameters() const;
         void describeNetwork() const override;
 
+        /// layers with at least minParallelLayerWidth nodes split their nodes across the threads of the pool
+        /// (0 disables splitting layers)
+        void setThreadPool(const std::shared_ptr<General::ThreadPool>& threadPool, int minParallelLayerWidth);
+
     private:
         Layer createInnerLayer(int numNodes, const Layer& previousLayer);
+        void updateDenseLayers();
+        void resizeLayerValues(int batchSize);
+
+        /// calls func(firstNode, lastNode) for blocks of nodes, in parallel if the layer is wide enough
+        void forEachNodeBlock(int numNodes, const std::function<void(int, int)>& func) const;
+
+        /// forward pass over all samples in m_layerValues[0]
+        void computeDenseValues();
+
+        /// backward pass for the errors in the output layer; expects m_layerValues to be up-to-date
+        /// outputErrorDerivatives: derivative of the error for each output value ((numOutputs x batchSize), row-major)
+        void handleDenseBackpropagation(std::vector<double>& outputErrorDerivatives, std::vector<double>& parameterAdjustments);
 
     private:
+        std::string m_activationFunctionName; /// as passed to assignActivationFunction
         std::string m_activationFunctionType;
         std::function<double(double, bool)> m_activationFunction;
+        bool m_useApproximateActivation = false;
+        bool m_useExactGradient = false;
         Layer m_inputLayer;
         std::vector<Layer> m_hiddenLayers;
         Layer m_outputLayer;
+
+        /// hidden layers followed by the output layer
+        std::vector<DenseLayer> m_denseLayers;
+
+        /// per layer (input layer first) and for each sample: node values and non-activated values
+        /// each is stored as a (numNodes x batchSize) matrix, so a layer can be computed with a single matrix multiplication
+        int m_batchSize = 0;
+        std::vector<std::vector<double>> m_layerValues;
+        std::vector<std::vector<double>> m_layerBaseValues;
+
+        std::shared_ptr<General::ThreadPool> m_threadPool;
+        int m_minParallelLayerWidth = 0;
     };
 }
@@ -1,19 +1,24 @@
 #include "stdafx.h"
 
 #include "ParameterManager.h"
+#include "EvolutionKernels.h"
 #include "FileIO/FileManager.h"
+#include "Math/Random.h"
 
 #include "3rdparty/json/json.hpp"
 
+#include <algorithm>
 #include <iostream>
-#include <random>
 
 namespace NeuralNetwork
 {
     using namespace FileIO;
+    using namespace Math;
     using json = nlohmann::json;
 
     const std::string DATA_FILE_NAME = "params.json";
+    const std::string ARCHIVE_FILE_NAME = "params_archive.json";
+    const int MAX_PARENT_SAMPLING_ATTEMPTS = 100;
 
     ParameterManager::ParameterManager(const ParameterManagerData pmData)
         : m_paramData(pmData)
@@ -24,6 +29,8 @@ namespace NeuralNetwork
         // skip this step if there's no chance of actually tweaking any parameters
         m_executeMutationStep = (m_paramData.mutationReplacementChance > 0) || (m_paramData.mutationBonusChance > 0 && m_paramData.mutationBonusScale != 0);
 
+        m_paramSets.setPrecision(m_paramData.precision);
+
         // initialize mutation rates
         updateEffectiveMutationRates(-1);
     }
@@ -46,6 +53,19 @@ namespace NeuralNetwork
         buffer << std::endl << "  number of best sets kept during evolution: " << m_paramData.numBestSetsKeptDuringEvolution;
         buffer << std::endl << "  number of best sets mutated during evolution: " << m_paramData.numBestSetsMutatedDuringEvolution;
         buffer << std::endl << "  number of random sets added during evolution: " << m_paramData.numAddedRandomSetsDuringEvolution;
+        buffer << std::endl << "  crossover parent selection: " << ParentSampler::getSelectionMethodDescription(m_paramData.selectionMethod);
+        if (m_paramData.selectionMethod == SM_TOURNAMENT)
+        {
+            buffer << " (tournament size: " << m_paramData.tournamentSize << ")";
+        }
+
+        buffer << std::endl << "  parameter storage precision: " << ParameterStore::getPrecisionDescription(m_paramData.precision);
+        if (m_paramData.hallOfFameSize >= 0)
+        {
+            buffer << std::endl << "  inactive sets kept in memory: " << m_paramData.hallOfFameSize;
+            buffer << std::endl << "  removed sets " << (m_paramData.archiveRetiredSets ? "archived to '" + ARCHIVE_FILE_NAME + "'" : "dropped");
+        }
+
         buffer << std::endl;
         PRINT_LOG(buffer);
     }
@@ -90,12 +110,18 @@ namespace NeuralNetwork
         json j;
         j["values"] = {};
 
-        for (const auto& pset : m_paramSets)
+        std::vector<int> ids;
+        getParameterSetIds(false, ids);
+
+        std::vector<double> params;
+        for (auto id : ids)
         {
+            copyParameters(id, params);
+
             json jps;
-            jps["id"] = pset.first;
-            jps["score"] = pset.second.score;
-            jps["params"] = pset.second.params;
+            jps["id"] = id;
+            jps["score"] = getScore(id);
+            jps["params"] = params;
 
             j["values"].push_back(jps);
         }
@@ -106,9 +132,7 @@ namespace NeuralNetwork
 
         if (!sortedIds.empty())
         {
-            ParamSet pset;
-            getParamSetForId(sortedIds[0], pset);
-            j["bestScore"] = pset.score;
+            j["bestScore"] = getScore(sortedIds[0]);
         }
 
         return FileManager::writeJsonToFile(DATA_FILE_NAME, j);
@@ -116,118 +140,333 @@ namespace NeuralNetwork
 
     void ParameterManager::fillWithRandomValues(std::vector<double>& params) const
     {
-        params.clear();
-        params.reserve(m_paramData.numParams);
+        params.resize(m_paramData.numParams);
+        Random::fillUniform(params.data(), m_paramData.numParams, m_paramData.minRandomParamValue, m_paramData.maxRandomParamValue);
+    }
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<double> rndDist(m_paramData.minRandomParamValue, std::nextafter(m_paramData.maxRandomParamValue, DBL_MAX));
+    int ParameterManager::addNewParamSet(const ParamSet& pset, int parentId)
+    {
+        if (parentId >= 0)
+        {
+            m_paramSets.addParamSet(m_nextId, pset, parentId);
+        }
+        else
+        {
+            m_paramSets.addParamSet(m_nextId, pset);
+        }
 
-        for (int k = 0; k < m_paramData.numParams; k++)
+        if (pset.active)
         {
-            params.push_back(rndDist(gen));
+            m_ranking.insert(m_nextId, pset.score);
+
+            if (isEvaluated(m_nextId))
+            {
+                m_evaluatedRanking.insert(m_nextId, pset.score);
+                m_parentSamplerOutdated = true;
+            }
         }
-    }
 
-    int ParameterManager::addNewParamSet(const ParamSet& pset)
-    {
-        m_paramSets.emplace(m_nextId, pset);
         return m_nextId++;
     }
 
     void ParameterManager::removeParameterSetForId(int id)
     {
-        m_paramSets.erase(id);
+        const int slot = m_paramSets.getSlot(id);
+        if (slot < 0)
+        {
+            return;
+        }
+
+        if (m_paramSets.isActive(slot))
+        {
+            m_ranking.remove(id, m_paramSets.getScore(slot));
+
+            if (m_paramSets.isEvaluated(slot))
+            {
+                m_evaluatedRanking.remove(id, m_paramSets.getScore(slot));
+                m_parentSamplerOutdated = true;
+            }
+        }
+
+        m_paramSets.removeParamSet(id);
     }
 
     void ParameterManager::setScore(int id, double score)
     {
-        auto& found = m_paramSets.find(id);
-        assert(found != m_paramSets.end());
+        const int slot = m_paramSets.getSlot(id);
+        assert(slot >= 0);
 
-        found->second.score = score;
+        if (m_paramSets.isActive(slot))
+        {
+            m_ranking.update(id, m_paramSets.getScore(slot), score);
+
+            if (m_paramSets.isEvaluated(slot))
+            {
+                m_evaluatedRanking.update(id, m_paramSets.getScore(slot), score);
+            }
+            else
+            {
+                m_evaluatedRanking.insert(id, score);
+            }
+            m_parentSamplerOutdated = true;
+        }
+
+        m_paramSets.setScore(slot, score);
+        m_paramSets.setEvaluated(slot, true);
     }
 
     void ParameterManager::setError(int id, double errorValue)
     {
-        auto& found = m_paramSets.find(id);
-        assert(found != m_paramSets.end());
+        const int slot = m_paramSets.getSlot(id);
+        assert(slot >= 0);
 
-        found->second.error = errorValue;
+        m_paramSets.setError(slot, errorValue);
     }
 
     void ParameterManager::setParameterSetActive(int id, bool active)
     {
-        auto& found = m_paramSets.find(id);
-        assert(found != m_paramSets.end());
+        const int slot = m_paramSets.getSlot(id);
+        assert(slot >= 0);
+
+        if (m_paramSets.isActive(slot) == active)
+        {
+            return;
+        }
 
-        found->second.active = active;
+        if (active)
+        {
+            m_ranking.insert(id, m_paramSets.getScore(slot));
+        }
+        else
+        {
+            m_ranking.remove(id, m_paramSets.getScore(slot));
+        }
+
+        if (m_paramSets.isEvaluated(slot))
+        {
+            if (active)
+            {
+                m_evaluatedRanking.insert(id, m_paramSets.getScore(slot));
+            }
+            else
+            {
+                m_evaluatedRanking.remove(id, m_paramSets.getScore(slot));
+            }
+            m_parentSamplerOutdated = true;
+        }
+
+        m_paramSets.setActive(slot, active);
     }
 
     void ParameterManager::setParameters(int id, const std::vector<double>& params)
     {
-        auto& found = m_paramSets.find(id);
-        assert(found != m_paramSets.end());
+        const int slot = m_paramSets.getSlot(id);
+        assert(slot >= 0);
 
-        found->second.params = params;
+        m_paramSets.setParameters(slot, params);
     }
 
     bool ParameterManager::getParamSetForId(int id, ParamSet& pset) const
     {
-        const auto& found = m_paramSets.find(id);
-        if (found == m_paramSets.end())
+        const int slot = m_paramSets.getSlot(id);
+        if (slot < 0)
         {
             return false;
         }
 
-        pset = found->second;
+        pset.score = m_paramSets.getScore(slot);
+        pset.error = m_paramSets.getError(slot);
+        pset.active = m_paramSets.isActive(slot);
+        pset.evaluated = m_paramSets.isEvaluated(slot);
+        pset.params.resize(m_paramSets.getNumParams(slot));
+        m_paramSets.copyParameters(slot, pset.params.data());
         return true;
     }
 
-    void ParameterManager::getActiveParameterSetIds(std::vector<int>& ids) const
+    ParameterView ParameterManager::getParameters(int id) const
+    {
+        const int slot = m_paramSets.getSlot(id);
+        if (slot < 0)
+        {
+            return ParameterView();
+        }
+
+        return m_paramSets.getParameters(slot);
+    }
+
+    bool ParameterManager::copyParameters(int id, std::vector<double>& params) const
+    {
+        const int slot = m_paramSets.getSlot(id);
+        if (slot < 0)
+        {
+            params.clear();
+            return false;
+        }
+
+        params.resize(m_paramSets.getNumParams(slot));
+        m_paramSets.copyParameters(slot, params.data());
+        return true;
+    }
+
+    double ParameterManager::getScore(int id) const
+    {
+        const int slot = m_paramSets.getSlot(id);
+        if (slot < 0)
+        {
+            return 0.0;
+        }
+
+        return m_paramSets.getScore(slot);
+    }
+
+    double ParameterManager::getError(int id) const
+    {
+        const int slot = m_paramSets.getSlot(id);
+        if (slot < 0)
+        {
+            return -1;
+        }
+
+        return m_paramSets.getError(slot);
+    }
+
+    bool ParameterManager::isEvaluated(int id) const
+    {
+        const int slot = m_paramSets.getSlot(id);
+        return slot >= 0 && m_paramSets.isEvaluated(slot);
+    }
+
+    void ParameterManager::getParameterSetIds(bool activeOnly, std::vector<int>& ids) const
     {
         ids.clear();
 
-        for (const auto& pset : m_paramSets)
+        const int numParamSets = m_paramSets.getNumParamSets();
+        const int* slotIds = m_paramSets.getIds();
+        const uint8_t* activeFlags = m_paramSets.getActiveFlags();
+
+        for (int slot = 0; slot < numParamSets; slot++)
         {
-            if (pset.second.active)
+            if (activeFlags[slot] || !activeOnly)
             {
-                ids.push_back(pset.first);
+                ids.push_back(slotIds[slot]);
             }
         }
+
+        // slots get reordered on removal, but callers expect the ids in the order they were added
+        std::sort(ids.begin(), ids.end());
+    }
+
+    void ParameterManager::getActiveParameterSetIds(std::vector<int>& ids) const
+    {
+        getParameterSetIds(true, ids);
     }
 
     void ParameterManager::getParameterSetIdsSortedByScore(std::vector<int>& idsSortedByScore) const
     {
-        // create another map with score as the key, auto-sorted in descending order
-        std::map<double, std::vector<int>, std::greater<double>> scoreMap;
+        m_ranking.getAllIds(idsSortedByScore);
+    }
+
+    void ParameterManager::getBestParameterSetIds(int maxNumIds, std::vector<int>& bestIds) const
+    {
+        m_ranking.getBestIds(maxNumIds, bestIds);
+    }
+
+    int ParameterManager::getBestParameterSetId() const
+    {
+        return m_ranking.getBestId();
+    }
 
-        for (const auto& pset : m_paramSets)
+    int ParameterManager::evictRetiredParameterSets()
+    {
+        if (m_paramData.hallOfFameSize < 0)
         {
-            if (!pset.second.active)
-            {
-                continue;
-            }
+            return 0;
+        }
 
-            const auto& foundScore = scoreMap.find(pset.second.score);
-            if (foundScore == scoreMap.end())
-            {
-                scoreMap.emplace(pset.second.score, std::vector<int>({ pset.first }));
-            }
-            else
+        const int numParamSets = m_paramSets.getNumParamSets();
+        const int* slotIds = m_paramSets.getIds();
+        const double* scores = m_paramSets.getScores();
+        const uint8_t* activeFlags = m_paramSets.getActiveFlags();
+
+        std::vector<std::pair<double, int>> retiredSets;
+        for (int slot = 0; slot < numParamSets; slot++)
+        {
+            if (!activeFlags[slot])
             {
-                foundScore->second.push_back(pset.first);
+                retiredSets.push_back(std::make_pair(scores[slot], slotIds[slot]));
             }
         }
 
-        idsSortedByScore.clear();
-        for (const auto& score : scoreMap)
+        const int numRetiredSets = static_cast<int>(retiredSets.size());
+        if (numRetiredSets <= m_paramData.hallOfFameSize)
         {
-            for (auto id : score.second)
-            {
-                idsSortedByScore.push_back(id);
-            }
+            return 0;
         }
+
+        // best score first, the older set wins ties
+        const auto isBetter = [](const std::pair<double, int>& a, const std::pair<double, int>& b)
+        {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        };
+
+        std::nth_element(retiredSets.begin(), retiredSets.begin() + m_paramData.hallOfFameSize, retiredSets.end(), isBetter);
+
+        std::vector<int> evictedIds;
+        for (int k = m_paramData.hallOfFameSize; k < numRetiredSets; k++)
+        {
+            evictedIds.push_back(retiredSets[k].second);
+        }
+
+        std::sort(evictedIds.begin(), evictedIds.end());
+
+        if (m_paramData.archiveRetiredSets)
+        {
+            archiveParameterSets(evictedIds);
+        }
+
+        for (auto id : evictedIds)
+        {
+            removeParameterSetForId(id);
+        }
+
+        return static_cast<int>(evictedIds.size());
+    }
+
+    bool ParameterManager::archiveParameterSets(const std::vector<int>& ids)
+    {
+        std::string relativePath;
+        if (!FileManager::getRelativeDataFilePath(ARCHIVE_FILE_NAME, relativePath))
+        {
+            return false;
+        }
+
+        std::ofstream ofs;
+        const int mode = m_archiveStarted ? (std::ofstream::out | std::ofstream::app) : std::ofstream::out;
+        if (!FileManager::openOutFileStream(relativePath, ofs, mode))
+        {
+            std::ostringstream buffer;
+            buffer << "Failed to open file '" << relativePath.c_str() << "' for writing";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        m_archiveStarted = true;
+
+        std::vector<double> params;
+        for (auto id : ids)
+        {
+            copyParameters(id, params);
+
+            json jps;
+            jps["id"] = id;
+            jps["score"] = getScore(id);
+            jps["error"] = getError(id);
+            jps["params"] = params;
+
+            ofs << jps << std::endl;
+        }
+
+        return true;
     }
 
     bool ParameterManager::evolveParameterSets(std::vector<int>& newParameterSetIds)
@@ -235,8 +474,11 @@ namespace NeuralNetwork
         std::ostringstream buffer;
         buffer << std::endl << "Evolving parameter sets...";
 
+        // only the best sets that are kept or mutated are needed
+        const int numBestIds = std::max(2, std::max(m_paramData.numBestSetsKeptDuringEvolution, m_paramData.numBestSetsMutatedDuringEvolution));
+
         std::vector<int> bestParameterSetIds;
-        getParameterSetIdsSortedByScore(bestParameterSetIds);
+        getBestParameterSetIds(numBestIds, bestParameterSetIds);
         assert(bestParameterSetIds.size() > 1);
 
         updateEffectiveMutationRates(bestParameterSetIds[0]);
@@ -248,9 +490,20 @@ namespace NeuralNetwork
             buffer << std::endl << " - effective mutation bonus chance: " << m_effectiveMutationBonusChance;
         }
 
-        std::map<double, int> probabilityMap;
-        fillParameterSetProbabilityMap(probabilityMap);
-        assert(probabilityMap.size() > 1);
+        // pick crossover parents among the sets of the previous generation, not the new ones added below
+        std::vector<int> candidateIds;
+        getParameterSetIdsSortedByScore(candidateIds);
+
+        std::vector<double> candidateScores;
+        candidateScores.reserve(candidateIds.size());
+        for (auto id : candidateIds)
+        {
+            candidateScores.push_back(getScore(id));
+        }
+
+        m_parentSampler.setup(m_paramData.selectionMethod, candidateIds, candidateScores, m_paramData.tournamentSize);
+        m_parentSamplerOutdated = true;
+        assert(m_parentSampler.getNumCandidates() > 1);
 
         assert(m_paramData.numBestSetsKeptDuringEvolution + m_paramData.numBestSetsKeptDuringEvolution + m_paramData.numAddedRandomSetsDuringEvolution < m_paramData.numParamSets);
 
@@ -264,6 +517,7 @@ namespace NeuralNetwork
         if (m_executeMutationStep)
         {
             // create heavily mutated version of the best parameter sets
+            std::vector<double> oldParams;
             for (int k = 0; k < m_paramData.numBestSetsMutatedDuringEvolution; k++)
             {
                 const int bestId = bestParameterSetIds[k];
@@ -275,16 +529,14 @@ namespace NeuralNetwork
                 }
 
                 // in the unlikely case that this new set is identical to the previous one, don't bother adding it
-                ParamSet oldSet;
-                if (getParamSetForId(bestId, oldSet))
+                copyParameters(bestId, oldParams);
+                if (oldParams == pset.params)
                 {
-                    if (oldSet.params == pset.params)
-                    {
-                        continue;
-                    }
+                    continue;
                 }
 
-                const int newSetId = addNewParamSet(pset);
+                // only a few values are mutated, so the new set is stored as differences to the original if possible
+                const int newSetId = addNewParamSet(pset, bestId);
                 buffer << std::endl << "Mutating best set " << bestId << " resulted in new param set " << newSetId;
                 newParameterSetIds.push_back(newSetId);
             }
@@ -304,10 +556,12 @@ namespace NeuralNetwork
         PRINT_LOG(buffer);
 
         // fill the remaining slots by combining previous sets
-        while (newParameterSetIds.size() < m_paramData.numParamSets)
+        // pick all parent pairs first, so the children can be created in parallel
+        std::vector<std::pair<int, int>> parentIds;
+        while (static_cast<int>(newParameterSetIds.size() + parentIds.size()) < m_paramData.numParamSets)
         {
-            const int id1 = getIdByProbability(probabilityMap);
-            const int id2 = getIdByProbability(probabilityMap);
+            const int id1 = m_parentSampler.sample();
+            const int id2 = m_parentSampler.sample();
             assert(id1 >= 0);
             assert(id2 >= 0);
 
@@ -316,25 +570,191 @@ namespace NeuralNetwork
                 continue;
             }
 
-            ParamSet pset;
-            if (!createCrossoverParameterSet(id1, id2, pset))
+            if (!m_paramSets.contains(id1) || !m_paramSets.contains(id2))
             {
+                std::ostringstream errorBuffer;
+                errorBuffer << "Unable to create crossover set: one or more of the parent ids (" << id1 << ", " << id2 << ") is invalid";
+                PRINT_ERROR(errorBuffer);
                 return false;
             }
 
+            parentIds.push_back(std::make_pair(id1, id2));
+        }
+
+        const int numChildren = static_cast<int>(parentIds.size());
+        const int numParams = m_paramData.numParams;
+        const MutationSettings settings = getMutationSettings();
+        const uint64_t firstStreamIndex = m_nextStreamIndex;
+        m_nextStreamIndex += numChildren;
+
+        std::vector<double> children(static_cast<size_t>(numChildren) * numParams);
+
+        // each child has its own random stream, so the result doesn't depend on which thread creates it
+        auto createChildren = [&](int begin, int end)
+        {
+            // the parents are put together (or widened from 16 bits) into buffers of this thread instead of being cached
+            // in the store, so at most two of them are held as doubles per thread
+            std::vector<double> p1;
+            std::vector<double> p2;
+            for (int c = begin; c < end; c++)
+            {
+                RandomGenerator generator = Random::createStream(firstStreamIndex + c);
+                copyParameters(parentIds[c].first, p1);
+                copyParameters(parentIds[c].second, p2);
+                assert(static_cast<int>(p1.size()) >= numParams && static_cast<int>(p2.size()) >= numParams);
+
+                EvolutionKernels::crossover(generator, p1.data(), p2.data(), numParams, settings, children.data() + static_cast<size_t>(c) * numParams);
+            }
+        };
+
+        if (m_threadPool)
+        {
+            m_threadPool->parallelFor(0, numChildren, 1, createChildren);
+        }
+        else
+        {
+            createChildren(0, numChildren);
+        }
+
+        for (int c = 0; c < numChildren; c++)
+        {
+            ParamSet pset;
+            pset.params.assign(children.begin() + static_cast<size_t>(c) * numParams, children.begin() + static_cast<size_t>(c + 1) * numParams);
+
             const int newSetId = addNewParamSet(pset);
 
             buffer.clear();
             buffer.str("");
-            buffer << "Crossover between " << id1 << " and " << id2 << " resulted in new param set " << newSetId;
+            buffer << "Crossover between " << parentIds[c].first << " and " << parentIds[c].second << " resulted in new param set " << newSetId;
             PRINT_LOG(buffer);
 
             newParameterSetIds.push_back(newSetId);
         }
 
+        // frees the sets cached by getParameters calls since the last evolution step
+        m_paramSets.releaseMaterializedSets();
         return true;
     }
 
+    int ParameterManager::retireWorstParameterSet(int evaluatedId)
+    {
+        const int slot = m_paramSets.getSlot(evaluatedId);
+        if (slot < 0 || !m_paramSets.isActive(slot) || !m_paramSets.isEvaluated(slot) || m_evaluatedRanking.size() <= m_paramData.numParamSets)
+        {
+            return -1;
+        }
+
+        // the worst member of the population other than the evaluated set
+        std::vector<int> worstIds;
+        m_evaluatedRanking.getWorstIds(2, worstIds);
+        const int worstOtherId = (worstIds[0] != evaluatedId) ? worstIds[0] : worstIds[1];
+
+        // on a tie, the population is kept as it is
+        const int retiredId = (getScore(evaluatedId) > getScore(worstOtherId)) ? worstOtherId : evaluatedId;
+        setParameterSetActive(retiredId, false);
+
+        std::ostringstream buffer;
+        if (retiredId == evaluatedId)
+        {
+            buffer << "Set " << evaluatedId << " doesn't beat the worst set " << worstOtherId << " and is disabled";
+        }
+        else
+        {
+            buffer << "Set " << evaluatedId << " replaces the worst set " << worstOtherId;
+        }
+        PRINT_LOG(buffer);
+
+        return retiredId;
+    }
+
+    int ParameterManager::addOffspringParameterSet()
+    {
+        // sets that haven't been evaluated yet are neither parents nor mutated
+        if (m_evaluatedRanking.size() < 2)
+        {
+            return -1;
+        }
+
+        // the same shares as in evolveParameterSets, where the kept sets correspond to the surviving population members
+        const int numMutated = m_executeMutationStep ? std::max(0, m_paramData.numBestSetsMutatedDuringEvolution) : 0;
+        const int numRandom = std::max(0, m_paramData.numAddedRandomSetsDuringEvolution);
+        const int numCrossover = std::max(0, m_paramData.numParamSets - m_paramData.numBestSetsKeptDuringEvolution - numMutated - numRandom);
+        const int numTotal = numMutated + numRandom + numCrossover;
+
+        const int pick = (numTotal > 0) ? static_cast<int>(Random::getGenerator().nextDouble() * numTotal) : numTotal;
+
+        std::ostringstream buffer;
+        ParamSet pset;
+        int newSetId = -1;
+        if (pick < numMutated)
+        {
+            // one of the best sets, as each of them is mutated once per evolution step
+            std::vector<int> bestIds;
+            m_evaluatedRanking.getBestIds(pick + 1, bestIds);
+            const int bestId = bestIds.back();
+            if (!createMutatedParameterSet(bestId, pset))
+            {
+                return -1;
+            }
+
+            // only a few values are mutated, so the new set is stored as differences to the original if possible
+            newSetId = addNewParamSet(pset, bestId);
+            buffer << "Mutating set " << bestId << " resulted in new param set " << newSetId;
+        }
+        else if (pick < numMutated + numRandom)
+        {
+            fillWithRandomValues(pset.params);
+
+            newSetId = addNewParamSet(pset);
+            buffer << "Adding new random set " << newSetId;
+        }
+        else
+        {
+            // rebuilt only after a set has been scored, replaced or retired, not for each child
+            if (m_parentSamplerOutdated)
+            {
+                std::vector<int> candidateIds;
+                m_evaluatedRanking.getAllIds(candidateIds);
+
+                std::vector<double> candidateScores;
+                candidateScores.reserve(candidateIds.size());
+                for (auto id : candidateIds)
+                {
+                    candidateScores.push_back(getScore(id));
+                }
+
+                m_parentSampler.setup(m_paramData.selectionMethod, candidateIds, candidateScores, m_paramData.tournamentSize);
+                m_parentSamplerOutdated = false;
+            }
+
+            const int id1 = m_parentSampler.sample();
+            int id2 = m_parentSampler.sample();
+            for (int attempt = 0; id1 == id2 && attempt < MAX_PARENT_SAMPLING_ATTEMPTS; attempt++)
+            {
+                id2 = m_parentSampler.sample();
+            }
+
+            if (id1 == id2)
+            {
+                // the selection weights can be concentrated on a single set
+                std::vector<int> bestIds;
+                m_evaluatedRanking.getBestIds(2, bestIds);
+                id2 = (bestIds[0] != id1) ? bestIds[0] : bestIds[1];
+            }
+
+            if (!createCrossoverParameterSet(id1, id2, pset))
+            {
+                return -1;
+            }
+
+            newSetId = addNewParamSet(pset);
+            buffer << "Crossover between " << id1 << " and " << id2 << " resulted in new param set " << newSetId;
+        }
+
+        PRINT_LOG(buffer);
+        return newSetId;
+    }
+
     void ParameterManager::updateEffectiveMutationRates(int newBestSetId)
     {
         m_effectiveMutationReplacementChance = m_paramData.mutationReplacementChance;
@@ -376,23 +796,18 @@ namespace NeuralNetwork
 
     void ParameterManager::fillParameterSetProbabilityMap(std::map<double, int> &probabilityMap)
     {
-        std::vector<int> bestIds;
-        getParameterSetIdsSortedByScore(bestIds);
-        assert(!bestIds.empty());
+        assert(!m_ranking.empty());
+        const double lowestScore = m_ranking.getLowestScore();
 
-        ParamSet worstScore;
-        getParamSetForId(bestIds[bestIds.size() - 1], worstScore);
-        const double lowestScore = worstScore.score;
+        std::vector<int> activeIds;
+        getActiveParameterSetIds(activeIds);
 
         std::map<int, double> modifiedScores;
 
         double sum = 0;
-        for (auto id : bestIds)
+        for (auto id : activeIds)
         {
-            ParamSet pset;
-            getParamSetForId(id, pset);
-
-            const double tempScore = pset.score - lowestScore;
+            const double tempScore = getScore(id) - lowestScore;
             if (tempScore > 0)
             {
                 sum += tempScore;
@@ -414,11 +829,7 @@ namespace NeuralNetwork
     {
         assert(!probabilityMap.empty());
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<double> rndChance(0, 1);
-
-        const double chance = rndChance(gen);
+        const double chance = Random::getGenerator().nextDouble();
         for (const auto& prob : probabilityMap)
         {
             if (chance <= prob.first)
@@ -432,9 +843,7 @@ namespace NeuralNetwork
 
     bool ParameterManager::createMutatedParameterSet(int id, ParamSet& pset) const
     {
-        ParamSet pidset;
-
-        if (!getParamSetForId(id, pidset))
+        if (!m_paramSets.contains(id))
         {
             std::ostringstream buffer;
             buffer << "Unable to create mutated parameter set for invalid id " << id;
@@ -442,21 +851,18 @@ namespace NeuralNetwork
             return false;
         }
 
-        pset.params.clear();
-        for (const auto& param : pidset.params)
-        {
-            pset.params.push_back(getMutatedValue(param));
-        }
+        std::vector<double> parentParams;
+        copyParameters(id, parentParams);
+
+        pset.params.resize(parentParams.size());
+        EvolutionKernels::mutate(Random::getGenerator(), parentParams.data(), static_cast<int>(parentParams.size()), getMutationSettings(), pset.params.data());
 
         return  true;
     }
 
     bool ParameterManager::createCrossoverParameterSet(int id1, int id2, ParamSet& pset) const
     {
-        ParamSet p1;
-        ParamSet p2;
-
-        if (!getParamSetForId(id1, p1) || !getParamSetForId(id2, p2))
+        if (!m_paramSets.contains(id1) || !m_paramSets.contains(id2))
         {
             std::ostringstream buffer;
             buffer << "Unable to create crossover set: one or more of the parent ids (" << id1 << ", " << id2 << ") is invalid";
@@ -464,19 +870,32 @@ namespace NeuralNetwork
             return false;
         }
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<double> rndChance(0, 1);
+        std::vector<double> p1;
+        std::vector<double> p2;
+        copyParameters(id1, p1);
+        copyParameters(id2, p2);
+        assert(static_cast<int>(p1.size()) >= m_paramData.numParams && static_cast<int>(p2.size()) >= m_paramData.numParams);
+
+        pset.params.resize(m_paramData.numParams);
+        EvolutionKernels::crossover(Random::getGenerator(), p1.data(), p2.data(), m_paramData.numParams, getMutationSettings(), pset.params.data());
 
-        pset.params.clear();
-        for (int k = 0; k < m_paramData.numParams; k++)
+        return  true;
+    }
+
+    MutationSettings ParameterManager::getMutationSettings() const
+    {
+        MutationSettings settings;
+        settings.minValue = m_paramData.minRandomParamValue;
+        settings.maxValue = m_paramData.maxRandomParamValue;
+        settings.bonusScale = m_paramData.mutationBonusScale;
+
+        if (m_executeMutationStep)
         {
-            // use value from either of the parents
-            const double param = (rndChance(gen) < 0.5 ? p1.params[k] : p2.params[k]);
-            pset.params.push_back(getMutatedValue(param));
+            settings.replacementChance = m_effectiveMutationReplacementChance;
+            settings.bonusChance = m_effectiveMutationBonusChance;
         }
 
-        return  true;
+        return settings;
     }
 
     double ParameterManager::getMutatedValue(double param) const
@@ -486,20 +905,19 @@ namespace NeuralNetwork
             return param;
         }
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<double> rndChance(0, 1);
-        std::uniform_real_distribution<double> rndDist(m_paramData.minRandomParamValue, std::nextafter(m_paramData.maxRandomParamValue, DBL_MAX));
+        RandomGenerator& generator = Random::getGenerator();
+        const double range = m_paramData.maxRandomParamValue - m_paramData.minRandomParamValue;
 
-        if (m_effectiveMutationReplacementChance > 0 && rndChance(gen) <= m_effectiveMutationReplacementChance)
+        if (m_effectiveMutationReplacementChance > 0 && generator.nextDouble() <= m_effectiveMutationReplacementChance)
         {
-            return rndDist(gen);
+            return m_paramData.minRandomParamValue + generator.nextDouble() * range;
         }
 
-        if (m_effectiveMutationBonusChance > 0 && rndChance(gen) <= m_effectiveMutationBonusChance)
+        if (m_effectiveMutationBonusChance > 0 && generator.nextDouble() <= m_effectiveMutationBonusChance)
         {
             // randomly tweak the parameter, but ensure that it's still between [min, max]
-            const double newParam = param + rndDist(gen) * m_paramData.mutationBonusScale;
+            const double bonus = m_paramData.minRandomParamValue + generator.nextDouble() * range;
+            const double newParam = param + bonus * m_paramData.mutationBonusScale;
             return std::min(m_paramData.maxRandomParamValue, std::max(m_paramData.minRandomParamValue, newParam));
         }
 
@@ -1,20 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 
+#include "EvolutionKernels.h"
 #include "General/Globals.h"
+#include "General/ThreadPool.h"
+#include "ParameterStore.h"
+#include "ParentSampler.h"
+#include "ScoreRanking.h"
 
 namespace NeuralNetwork
 {
-    struct ParamSet
-    {
-        double score = 0.0;
-        double error = -1;
-        bool active = true;
-        std::vector<double> params;
-    };
-
     class ParameterManager
     {
     public:
@@ -23,24 +22,76 @@ namespace NeuralNetwork
 
     public:
         void describeParameterManager() const;
+
+        /// crossover children are created in parallel on this pool (nullptr: on the calling thread)
+        void setThreadPool(const std::shared_ptr<General::ThreadPool>& threadPool) { m_threadPool = threadPool; }
+
         bool readDataFromFile();
         bool dumpDataToFile() const;
         void fillWithRandomValues(std::vector<double>& params) const;
-        int addNewParamSet(const ParamSet& pset);
+        /// if parentId is a valid id and the new set only differs from it in a few values, only the differences are stored
+        int addNewParamSet(const ParamSet& pset, int parentId = -1);
         void setScore(int id, double score);
         void setError(int id, double errorValue);
         void setParameterSetActive(int id, bool active);
         void setParameters(int id, const std::vector<double>& pset);
+        /// copies the whole set, use the accessors below if only some of the values are needed
         bool getParamSetForId(int id, ParamSet& pset) const;
+
+        /// invalid ids result in an empty view and the default score and error of a ParamSet
+        /// the view is invalidated by adding or removing parameter sets
+        /// sets stored as differences or with a 16-bit precision are cached as doubles until the next evolution step,
+        /// so use copyParameters for sets that are only read once
+        ParameterView getParameters(int id) const;
+
+        /// puts together sets that are stored as differences without caching them, so this is safe to call from several threads
+        /// returns false (and clears params) for invalid ids
+        bool copyParameters(int id, std::vector<double>& params) const;
+
+        /// number of sets currently cached by getParameters
+        int getNumMaterializedSets() const { return m_paramSets.getNumMaterializedSets(); }
+
+        double getScore(int id) const;
+        double getError(int id) const;
+
+        /// true once a score has been set (or the set was added with a non-zero score), false for invalid ids
+        bool isEvaluated(int id) const;
+
         void getActiveParameterSetIds(std::vector<int>& ids) const;
         void getParameterSetIdsSortedByScore(std::vector<int>& bestIds) const;
+
+        /// the (up to) maxNumIds active sets with the highest scores, best first
+        void getBestParameterSetIds(int maxNumIds, std::vector<int>& bestIds) const;
+
+        /// returns -1 if there are no active sets
+        int getBestParameterSetId() const;
         void removeParameterSetForId(int id);
+        bool hasParameterSet(int id) const { return m_paramSets.contains(id); }
+
+        /// removes the inactive sets that aren't among the hallOfFameSize best inactive ones (ties keep the older set)
+        /// and appends them to the archive file if archiving is enabled; does nothing for a negative hall of fame size
+        /// returns the number of removed sets
+        int evictRetiredParameterSets();
 
         bool evolveParameterSets(std::vector<int>& newParameterSetIds);
+
+        /// steady-state evolution step for a set that has just been scored: once more than numParamSets active sets are evaluated,
+        /// the worse of the scored set and the worst other evaluated set is disabled, so a child only replaces a member
+        /// of the population if it beats it
+        /// returns the id of the disabled set, or -1 if the population isn't complete yet
+        int retireWorstParameterSet(int evaluatedId);
+
+        /// steady-state evolution step: adds a child that is created the same ways as in evolveParameterSets, i.e. by mutating
+        /// one of the best sets, randomly or by crossover of two sets picked among all evaluated active sets,
+        /// each way as often as in an evolution step of the whole population
+        /// returns the id of the child, or -1 if fewer than two active sets have been evaluated
+        int addOffspringParameterSet();
+
         void updateEffectiveMutationRates(int newBestSetId);
         double getEffectiveReplacementMutationChance() const { return m_effectiveMutationReplacementChance; }
         double getEffectiveBonusMutationChance() const { return m_effectiveMutationBonusChance; }
 
+        /// cumulative fitness proportional chances; evolveParameterSets uses the (faster) ParentSampler instead
         void fillParameterSetProbabilityMap(std::map<double, int> &probabilityMap);
         static int getIdByProbability(const std::map<double, int>& probabilityMap);
 
@@ -52,11 +103,28 @@ namespace NeuralNetwork
 
         double getMutatedValue(double param) const;
 
+    private:
+        /// the current (effective) mutation chances, or none at all if mutation is disabled
+        MutationSettings getMutationSettings() const;
+
+        /// ids in ascending order
+        void getParameterSetIds(bool activeOnly, std::vector<int>& ids) const;
+
+        /// one json object per line and set, the file is started over by the first call
+        bool archiveParameterSets(const std::vector<int>& ids);
+
     private:
         ParameterManagerData m_paramData;
-        std::map<int, ParamSet> m_paramSets;
+        ParameterStore m_paramSets;
+        ScoreRanking m_ranking; /// active sets only
+        ScoreRanking m_evaluatedRanking; /// active sets that have a score
+        ParentSampler m_parentSampler;
+        bool m_parentSamplerOutdated = true; /// false while m_parentSampler is set up for the sets in m_evaluatedRanking
+        std::shared_ptr<General::ThreadPool> m_threadPool;
+        uint64_t m_nextStreamIndex = 0; /// random stream for the next crossover child
         int m_nextId;
         bool m_executeMutationStep = true;
+        bool m_archiveStarted = false;
 
         int m_currentBestSetId = -1;
         int m_numIterationsBestIdUnchanged = 0;
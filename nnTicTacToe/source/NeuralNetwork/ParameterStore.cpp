@@ -0,0 +1,500 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+
+#include "ParameterStore.h"
+#include "Math/HalfPrecision.h"
+
+namespace NeuralNetwork
+{
+    // rows start at cache line boundaries
+    const int CACHE_LINE_SIZE = 64;
+
+    // initial number of rows, doubled whenever the buffer is full
+    const int MIN_CAPACITY = 16;
+
+    // a difference takes about twice the memory of a value, so only store differences if they cover at most a quarter of the values
+    const int MAX_DIFFERENCE_FRACTION_DIVISOR = 4;
+
+    // longer chains are flattened, so reading a set never has to visit too many parents
+    const int MAX_DIFFERENCE_DEPTH = 4;
+
+    using namespace Math;
+
+    bool ParameterStore::parsePrecision(const std::string& name, ParameterPrecision& precision)
+    {
+        if (name == "double")
+        {
+            precision = PP_DOUBLE;
+        }
+        else if (name == "float16")
+        {
+            precision = PP_FLOAT16;
+        }
+        else if (name == "bfloat16")
+        {
+            precision = PP_BFLOAT16;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string ParameterStore::getPrecisionDescription(ParameterPrecision precision)
+    {
+        switch (precision)
+        {
+        case PP_DOUBLE:   return "double";
+        case PP_FLOAT16:  return "float16";
+        case PP_BFLOAT16: return "bfloat16";
+        default:          return "";
+        }
+    }
+
+    void ParameterStore::setPrecision(ParameterPrecision precision)
+    {
+        assert(getNumParamSets() == 0);
+        if (getNumParamSets() > 0 || precision == m_precision)
+        {
+            return;
+        }
+
+        m_precision = precision;
+
+        // start over with an empty buffer of the new type
+        std::vector<double>().swap(m_buffer);
+        std::vector<uint16_t>().swap(m_halfBuffer);
+        m_offset = 0;
+        m_stride = 0;
+        m_capacity = 0;
+        m_numRows = 0;
+        m_freeRows.clear();
+    }
+
+    double ParameterStore::roundToPrecision(double value) const
+    {
+        switch (m_precision)
+        {
+        case PP_FLOAT16:  return HalfPrecision::float16ToFloat(HalfPrecision::floatToFloat16(static_cast<float>(value)));
+        case PP_BFLOAT16: return HalfPrecision::bFloat16ToFloat(HalfPrecision::floatToBFloat16(static_cast<float>(value)));
+        default:          return value;
+        }
+    }
+
+    void ParameterStore::addParamSet(int id, const ParamSet& pset)
+    {
+        assert(id >= 0);
+        assert(!contains(id));
+
+        const int numParams = static_cast<int>(pset.params.size());
+
+        // sets without values (e.g. placeholders whose values are computed elsewhere) don't need a row
+        const int row = numParams > 0 ? allocateRow(numParams) : -1;
+
+        const int slot = addSlot(id, pset, numParams);
+        m_slotData[slot].row = row;
+
+        if (row >= 0)
+        {
+            writeRow(row, pset.params.data(), numParams);
+        }
+    }
+
+    bool ParameterStore::addParamSet(int id, const ParamSet& pset, int parentId)
+    {
+        const int parentSlot = getSlot(parentId);
+        const int numParams = static_cast<int>(pset.params.size());
+
+        if (parentSlot < 0 || m_numParams[parentSlot] != numParams || m_slotData[parentSlot].depth >= MAX_DIFFERENCE_DEPTH)
+        {
+            addParamSet(id, pset);
+            return false;
+        }
+
+        assert(id >= 0);
+        assert(!contains(id));
+
+        const int maxNumDifferences = numParams / MAX_DIFFERENCE_FRACTION_DIVISOR;
+        std::vector<double> parentParams(numParams);
+        copyParameters(parentSlot, parentParams.data());
+
+        std::vector<std::pair<int, double>> differences;
+        for (int k = 0; k < numParams; k++)
+        {
+            // the parent values are already rounded, so values copied from it compare equal
+            const double value = roundToPrecision(pset.params[k]);
+            if (value != parentParams[k])
+            {
+                if (static_cast<int>(differences.size()) >= maxNumDifferences)
+                {
+                    addParamSet(id, pset);
+                    return false;
+                }
+
+                differences.push_back(std::make_pair(k, value));
+            }
+        }
+
+        const int slot = addSlot(id, pset, numParams);
+
+        SlotData& slotData = m_slotData[slot];
+        slotData.parentId = parentId;
+        slotData.depth = m_slotData[parentSlot].depth + 1;
+        slotData.differences.swap(differences);
+        m_slotData[parentSlot].numDependents++;
+        return true;
+    }
+
+    bool ParameterStore::removeParamSet(int id)
+    {
+        const int slot = getSlot(id);
+        if (slot < 0)
+        {
+            return false;
+        }
+
+        if (m_slotData[slot].numDependents > 0)
+        {
+            flattenDependents(id);
+        }
+
+        const int parentSlot = getSlot(m_slotData[slot].parentId);
+        if (parentSlot >= 0)
+        {
+            m_slotData[parentSlot].numDependents--;
+        }
+
+        if (m_slotData[slot].row >= 0)
+        {
+            m_freeRows.push_back(m_slotData[slot].row);
+        }
+
+        const int lastSlot = getNumParamSets() - 1;
+        if (slot != lastSlot)
+        {
+            m_ids[slot] = m_ids[lastSlot];
+            m_scores[slot] = m_scores[lastSlot];
+            m_errors[slot] = m_errors[lastSlot];
+            m_active[slot] = m_active[lastSlot];
+            m_evaluated[slot] = m_evaluated[lastSlot];
+            m_numParams[slot] = m_numParams[lastSlot];
+            m_slotData[slot] = std::move(m_slotData[lastSlot]);
+            m_slotForId[m_ids[slot]] = slot;
+        }
+
+        m_ids.pop_back();
+        m_scores.pop_back();
+        m_errors.pop_back();
+        m_active.pop_back();
+        m_evaluated.pop_back();
+        m_numParams.pop_back();
+        m_slotData.pop_back();
+        m_slotForId[id] = -1;
+        return true;
+    }
+
+    int ParameterStore::getSlot(int id) const
+    {
+        if (id < 0 || id >= static_cast<int>(m_slotForId.size()))
+        {
+            return -1;
+        }
+
+        return m_slotForId[id];
+    }
+
+    ParamSetInfo ParameterStore::getInfo(int slot) const
+    {
+        assert(slot >= 0 && slot < getNumParamSets());
+
+        const SlotData& slotData = m_slotData[slot];
+
+        ParamSetInfo info;
+        info.id = m_ids[slot];
+        info.score = m_scores[slot];
+        info.error = m_errors[slot];
+        info.active = isActive(slot);
+        info.evaluated = isEvaluated(slot);
+        info.numParams = m_numParams[slot];
+        info.parentId = slotData.parentId;
+        info.depth = slotData.depth;
+        info.numDependents = slotData.numDependents;
+        return info;
+    }
+
+    ParameterView ParameterStore::getParameters(int slot) const
+    {
+        assert(slot >= 0 && slot < getNumParamSets());
+
+        const SlotData& slotData = m_slotData[slot];
+        const int numParams = m_numParams[slot];
+
+        if (numParams == 0)
+        {
+            return ParameterView();
+        }
+
+        if (slotData.row >= 0 && m_precision == PP_DOUBLE)
+        {
+            return ParameterView(getRow(slotData.row), numParams);
+        }
+
+        if (static_cast<int>(slotData.materialized.size()) != numParams)
+        {
+            slotData.materialized.resize(numParams);
+            copyParameters(slot, slotData.materialized.data());
+        }
+
+        return ParameterView(slotData.materialized.data(), numParams);
+    }
+
+    void ParameterStore::copyParameters(int slot, double* params) const
+    {
+        assert(slot >= 0 && slot < getNumParamSets());
+
+        if (m_numParams[slot] == 0)
+        {
+            return;
+        }
+
+        const SlotData& slotData = m_slotData[slot];
+        if (slotData.row >= 0)
+        {
+            readRow(slotData.row, params, m_numParams[slot]);
+            return;
+        }
+
+        const int parentSlot = getSlot(slotData.parentId);
+        assert(parentSlot >= 0);
+        copyParameters(parentSlot, params);
+
+        for (const auto& difference : slotData.differences)
+        {
+            params[difference.first] = difference.second;
+        }
+    }
+
+    void ParameterStore::setParameters(int slot, const std::vector<double>& params)
+    {
+        assert(slot >= 0 && slot < getNumParamSets());
+
+        // sets depending on this one need to keep their current values
+        if (m_slotData[slot].numDependents > 0)
+        {
+            flattenDependents(m_ids[slot]);
+        }
+
+        const int numParams = static_cast<int>(params.size());
+        if (m_slotData[slot].row < 0)
+        {
+            if (m_slotData[slot].parentId >= 0)
+            {
+                flatten(slot);
+            }
+            else
+            {
+                m_slotData[slot].row = allocateRow(numParams);
+            }
+        }
+
+        reserve(m_numRows, numParams);
+
+        writeRow(m_slotData[slot].row, params.data(), numParams);
+        m_numParams[slot] = numParams;
+
+        // a cached copy of the rounded values would be outdated now
+        std::vector<double>().swap(m_slotData[slot].materialized);
+    }
+
+    void ParameterStore::releaseMaterializedSets()
+    {
+        for (auto& slotData : m_slotData)
+        {
+            std::vector<double>().swap(slotData.materialized);
+        }
+    }
+
+    int ParameterStore::getNumMaterializedSets() const
+    {
+        int numMaterialized = 0;
+        for (const auto& slotData : m_slotData)
+        {
+            numMaterialized += slotData.materialized.empty() ? 0 : 1;
+        }
+
+        return numMaterialized;
+    }
+
+    int ParameterStore::getNumStoredDifferences() const
+    {
+        int numDifferences = 0;
+        for (const auto& slotData : m_slotData)
+        {
+            numDifferences += static_cast<int>(slotData.differences.size());
+        }
+
+        return numDifferences;
+    }
+
+    void ParameterStore::writeRow(int row, const double* values, int numValues)
+    {
+        switch (m_precision)
+        {
+        case PP_FLOAT16:
+            HalfPrecision::toFloat16(values, numValues, getHalfRow(row));
+            break;
+        case PP_BFLOAT16:
+            HalfPrecision::toBFloat16(values, numValues, getHalfRow(row));
+            break;
+        default:
+            std::copy(values, values + numValues, getRow(row));
+            break;
+        }
+    }
+
+    void ParameterStore::readRow(int row, double* values, int numValues) const
+    {
+        switch (m_precision)
+        {
+        case PP_FLOAT16:
+            HalfPrecision::fromFloat16(getHalfRow(row), numValues, values);
+            break;
+        case PP_BFLOAT16:
+            HalfPrecision::fromBFloat16(getHalfRow(row), numValues, values);
+            break;
+        default:
+        {
+            const double* rowValues = getRow(row);
+            std::copy(rowValues, rowValues + numValues, values);
+            break;
+        }
+        }
+    }
+
+    int ParameterStore::allocateRow(int rowLength)
+    {
+        if (!m_freeRows.empty())
+        {
+            reserve(m_numRows, rowLength);
+
+            const int row = m_freeRows.back();
+            m_freeRows.pop_back();
+            return row;
+        }
+
+        reserve(m_numRows + 1, rowLength);
+        return m_numRows++;
+    }
+
+    void ParameterStore::reserve(int numRows, int rowLength)
+    {
+        const int alignment = CACHE_LINE_SIZE / static_cast<int>(m_precision == PP_DOUBLE ? sizeof(double) : sizeof(uint16_t));
+        const int paddedLength = (rowLength + alignment - 1) / alignment * alignment;
+        const int newStride = std::max(m_stride, paddedLength);
+        if (newStride == m_stride && numRows <= m_capacity)
+        {
+            return;
+        }
+
+        int newCapacity = std::max(m_capacity, MIN_CAPACITY);
+        while (newCapacity < numRows)
+        {
+            newCapacity *= 2;
+        }
+
+        if (m_precision == PP_DOUBLE)
+        {
+            reallocate(m_buffer, newCapacity, newStride);
+        }
+        else
+        {
+            reallocate(m_halfBuffer, newCapacity, newStride);
+        }
+    }
+
+    template <typename T>
+    void ParameterStore::reallocate(std::vector<T>& buffer, int newCapacity, int newStride)
+    {
+        const int alignment = CACHE_LINE_SIZE / static_cast<int>(sizeof(T));
+
+        // allocate one extra cache line, so the start can be moved to an aligned address
+        std::vector<T> newBuffer(static_cast<size_t>(newCapacity) * newStride + alignment, 0);
+        const uintptr_t address = reinterpret_cast<uintptr_t>(newBuffer.data());
+        const int misalignment = static_cast<int>((address / sizeof(T)) % alignment);
+        const int newOffset = (alignment - misalignment) % alignment;
+
+        for (int slot = 0; slot < getNumParamSets(); slot++)
+        {
+            const int row = m_slotData[slot].row;
+            if (row >= 0)
+            {
+                const T* values = buffer.data() + m_offset + row * m_stride;
+                std::copy(values, values + m_numParams[slot], newBuffer.data() + newOffset + row * newStride);
+            }
+        }
+
+        buffer.swap(newBuffer);
+        m_offset = newOffset;
+        m_stride = newStride;
+        m_capacity = newCapacity;
+    }
+
+    int ParameterStore::addSlot(int id, const ParamSet& pset, int numParams)
+    {
+        const int slot = getNumParamSets();
+
+        m_ids.push_back(id);
+        m_scores.push_back(pset.score);
+        m_errors.push_back(pset.error);
+        m_active.push_back(pset.active ? 1 : 0);
+        m_evaluated.push_back(pset.evaluated || pset.score != 0 ? 1 : 0);
+        m_numParams.push_back(numParams);
+        m_slotData.push_back(SlotData());
+
+        if (id >= static_cast<int>(m_slotForId.size()))
+        {
+            m_slotForId.resize(id + 1, -1);
+        }
+
+        m_slotForId[id] = slot;
+        return slot;
+    }
+
+    void ParameterStore::flatten(int slot)
+    {
+        assert(m_slotData[slot].row < 0);
+
+        // the row isn't assigned to the slot yet, so copyParameters still puts the values together from the parents
+        const int row = allocateRow(m_numParams[slot]);
+        std::vector<double> params(m_numParams[slot]);
+        copyParameters(slot, params.data());
+        writeRow(row, params.data(), m_numParams[slot]);
+
+        SlotData& slotData = m_slotData[slot];
+        const int parentSlot = getSlot(slotData.parentId);
+        assert(parentSlot >= 0);
+        m_slotData[parentSlot].numDependents--;
+
+        slotData.parentId = -1;
+        slotData.depth = 0;
+        slotData.row = row;
+        std::vector<std::pair<int, double>>().swap(slotData.differences);
+        std::vector<double>().swap(slotData.materialized);
+    }
+
+    void ParameterStore::flattenDependents(int id)
+    {
+        for (int slot = 0; slot < getNumParamSets(); slot++)
+        {
+            if (m_slotData[slot].parentId == id)
+            {
+                flatten(slot);
+            }
+        }
+    }
+}
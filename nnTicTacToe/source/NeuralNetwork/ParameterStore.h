@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "General/Globals.h"
+
+namespace NeuralNetwork
+{
+    struct ParamSet
+    {
+        double score = 0.0;
+        double error = -1;
+        bool active = true;
+        bool evaluated = false; /// true once the score is known (which may be 0); sets added with a non-zero score count as evaluated, too
+        std::vector<double> params;
+    };
+
+    /// read-only view on the parameters of one set, without copying them
+    /// only valid until parameter sets are added to or removed from the store it was taken from
+    class ParameterView
+    {
+    public:
+        ParameterView() = default;
+        ParameterView(const double* data, int size) : m_data(data), m_size(size) {}
+
+    public:
+        const double* data() const { return m_data; }
+        int size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        const double* begin() const { return m_data; }
+        const double* end() const { return m_data + m_size; }
+        double operator[](int index) const { return m_data[index]; }
+
+    private:
+        const double* m_data = nullptr;
+        int m_size = 0;
+    };
+
+    /// per-set values except for the parameters themselves, as returned by ParameterStore::getInfo
+    struct ParamSetInfo
+    {
+        int id = -1;
+        double score = 0.0;
+        double error = -1;
+        bool active = true;
+        bool evaluated = false;
+        int numParams = 0;
+
+        int parentId = -1; /// for sets stored as differences to another set, -1 for full copies
+        int depth = 0; /// upper limit for the number of parent sets visited to get to a full copy
+        int numDependents = 0; /// number of sets stored as differences to this one
+    };
+
+    /// slot map for parameter sets: ids stay valid until their set is removed, and looking up a set by its id is a single array access.
+    /// Sets are either stored as rows of one contiguous matrix (aligned to cache lines) or, if they only differ from another set
+    /// in a few values, as a reference to that set plus the (index, value) pairs that differ.
+    /// With a 16-bit precision, the rows hold float16 or bfloat16 values that are widened again whenever they are read.
+    /// Ids, scores, errors and the active and evaluated flags are kept in parallel arrays indexed by slot, so loops over the whole population
+    /// only touch the values they need.
+    class ParameterStore
+    {
+    public:
+        ParameterStore() = default;
+
+    public:
+        static bool parsePrecision(const std::string& name, ParameterPrecision& precision);
+        static std::string getPrecisionDescription(ParameterPrecision precision);
+
+        /// can only be changed while the store is empty
+        void setPrecision(ParameterPrecision precision);
+        ParameterPrecision getPrecision() const { return m_precision; }
+
+        /// the value that is read back after storing value with the current precision
+        double roundToPrecision(double value) const;
+
+        /// id needs to be non-negative and unused
+        /// sets without any values only take up their ParamSetInfo
+        void addParamSet(int id, const ParamSet& pset);
+
+        /// stores the set as differences to parentId if that saves enough memory and the chain of parents doesn't get too long,
+        /// otherwise as a full copy
+        /// returns true if the set was stored as differences
+        bool addParamSet(int id, const ParamSet& pset, int parentId);
+
+        /// moves the last set into the freed slot, so the sets stay dense (their order changes)
+        /// sets stored as differences to the removed one are turned into full copies first
+        bool removeParamSet(int id);
+
+        bool contains(int id) const { return getSlot(id) >= 0; }
+        int getNumParamSets() const { return static_cast<int>(m_ids.size()); }
+
+        /// returns -1 for unknown ids
+        int getSlot(int id) const;
+
+        // access by slot (in [0, getNumParamSets()))
+        /// a copy of all per-set values, use the accessors below for single values
+        ParamSetInfo getInfo(int slot) const;
+
+        int getId(int slot) const { return m_ids[slot]; }
+        int getNumParams(int slot) const { return m_numParams[slot]; }
+        double getScore(int slot) const { return m_scores[slot]; }
+        void setScore(int slot, double score) { m_scores[slot] = score; }
+        double getError(int slot) const { return m_errors[slot]; }
+        void setError(int slot, double error) { m_errors[slot] = error; }
+        bool isActive(int slot) const { return m_active[slot] != 0; }
+        void setActive(int slot, bool active) { m_active[slot] = active ? 1 : 0; }
+        bool isEvaluated(int slot) const { return m_evaluated[slot] != 0; }
+        void setEvaluated(int slot, bool evaluated) { m_evaluated[slot] = evaluated ? 1 : 0; }
+
+        // the per-set arrays, getNumParamSets() values each
+        const int* getIds() const { return m_ids.data(); }
+        const double* getScores() const { return m_scores.data(); }
+        const uint8_t* getActiveFlags() const { return m_active.data(); }
+
+        /// sets stored as differences (and all sets with a 16-bit precision) are put together on first access and cached until releaseMaterializedSets;
+        /// that first access is not thread-safe, use copyParameters when reading from several threads
+        ParameterView getParameters(int slot) const;
+
+        /// writes getNumParams(slot) values, without caching anything
+        void copyParameters(int slot, double* params) const;
+
+        /// turns sets stored as differences into full copies
+        void setParameters(int slot, const std::vector<double>& params);
+
+        /// frees the values cached by getParameters
+        void releaseMaterializedSets();
+        int getNumMaterializedSets() const;
+
+        int getNumStoredDifferences() const;
+
+    private:
+        struct SlotData
+        {
+            int row = -1; /// row in the parameter matrix, -1 for sets stored as differences and sets without values
+            int parentId = -1; /// for sets stored as differences to another set, -1 for full copies
+            int depth = 0; /// upper limit for the number of parent sets visited to get to a full copy
+            int numDependents = 0; /// number of sets stored as differences to this one
+            std::vector<std::pair<int, double>> differences; /// (index, value), sorted by index
+            mutable std::vector<double> materialized; /// cached by getParameters
+        };
+
+        // rows of the buffer matching the precision
+        double* getRow(int row) { return m_buffer.data() + m_offset + row * m_stride; }
+        const double* getRow(int row) const { return m_buffer.data() + m_offset + row * m_stride; }
+        uint16_t* getHalfRow(int row) { return m_halfBuffer.data() + m_offset + row * m_stride; }
+        const uint16_t* getHalfRow(int row) const { return m_halfBuffer.data() + m_offset + row * m_stride; }
+
+        /// converts from and to the stored precision
+        void writeRow(int row, const double* values, int numValues);
+        void readRow(int row, double* values, int numValues) const;
+
+        int allocateRow(int rowLength);
+
+        /// makes sure there is room for numRows rows with at least rowLength values each
+        void reserve(int numRows, int rowLength);
+
+        /// moves the rows into a new buffer with newCapacity rows of newStride values each
+        template <typename T>
+        void reallocate(std::vector<T>& buffer, int newCapacity, int newStride);
+
+        /// appends a slot for the set, without any values
+        int addSlot(int id, const ParamSet& pset, int numParams);
+
+        /// stores the set in slot as a full copy
+        void flatten(int slot);
+
+        /// turns all sets stored as differences to id into full copies
+        void flattenDependents(int id);
+
+    private:
+        // one value per slot
+        std::vector<int> m_ids;
+        std::vector<double> m_scores;
+        std::vector<double> m_errors;
+        std::vector<uint8_t> m_active;
+        std::vector<uint8_t> m_evaluated;
+        std::vector<int> m_numParams;
+        std::vector<SlotData> m_slotData;
+
+        std::vector<int> m_slotForId; /// indexed by id, -1 if the id isn't used (anymore)
+
+        ParameterPrecision m_precision = PP_DOUBLE;
+
+        /// parameter matrix: one row per set that isn't stored as differences, in m_buffer or m_halfBuffer depending on the precision
+        /// the first row starts at m_offset, so it's aligned to a cache line, and m_stride is a multiple of the cache line size
+        /// (both counted in values of the buffer in use)
+        std::vector<double> m_buffer;
+        std::vector<uint16_t> m_halfBuffer;
+        int m_offset = 0;
+        int m_stride = 0;
+        int m_capacity = 0; /// number of rows that fit into the buffer
+        int m_numRows = 0; /// number of rows handed out so far (including free ones)
+        std::vector<int> m_freeRows;
+    };
+}
@@ -0,0 +1,190 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <random>
+
+#include "ParentSampler.h"
+
+namespace NeuralNetwork
+{
+    ParentSampler::ParentSampler()
+        : m_generator(Math::Random::getGenerator()())
+    {
+    }
+
+    bool ParentSampler::parseSelectionMethod(const std::string& name, SelectionMethod& selectionMethod)
+    {
+        if (name == "fitness_proportional")
+        {
+            selectionMethod = SM_FITNESS_PROPORTIONAL;
+        }
+        else if (name == "tournament")
+        {
+            selectionMethod = SM_TOURNAMENT;
+        }
+        else if (name == "rank")
+        {
+            selectionMethod = SM_RANK;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string ParentSampler::getSelectionMethodDescription(SelectionMethod selectionMethod)
+    {
+        switch (selectionMethod)
+        {
+        case SM_FITNESS_PROPORTIONAL: return "fitness proportional";
+        case SM_TOURNAMENT:           return "tournament";
+        case SM_RANK:                 return "rank";
+        default:                      return "";
+        }
+    }
+
+    void ParentSampler::setup(SelectionMethod selectionMethod, const std::vector<int>& idsSortedByScore, const std::vector<double>& scores, int tournamentSize)
+    {
+        assert(idsSortedByScore.size() == scores.size());
+
+        m_selectionMethod = selectionMethod;
+        m_tournamentSize = std::max(1, tournamentSize);
+        m_ids = idsSortedByScore;
+        m_aliasChance.clear();
+        m_alias.clear();
+
+        const int numIds = getNumCandidates();
+        if (numIds == 0 || m_selectionMethod == SM_TOURNAMENT)
+        {
+            return;
+        }
+
+        std::vector<double> weights(numIds, 1.0);
+
+        if (m_selectionMethod == SM_RANK)
+        {
+            for (int k = 0; k < numIds; k++)
+            {
+                weights[k] = numIds - k;
+            }
+        }
+        else
+        {
+            const double lowestScore = *std::min_element(scores.begin(), scores.end());
+
+            int numPositiveWeights = 0;
+            for (int k = 0; k < numIds; k++)
+            {
+                weights[k] = scores[k] - lowestScore;
+                if (weights[k] > 0)
+                {
+                    numPositiveWeights++;
+                }
+            }
+
+            // a single candidate can't be crossed with anything else
+            if (numPositiveWeights < 2)
+            {
+                std::fill(weights.begin(), weights.end(), 1.0);
+            }
+        }
+
+        setupAliasTable(weights);
+    }
+
+    void ParentSampler::setupAliasTable(const std::vector<double>& weights)
+    {
+        const int numWeights = static_cast<int>(weights.size());
+
+        double sum = 0;
+        for (auto weight : weights)
+        {
+            sum += weight;
+        }
+
+        assert(sum > 0);
+
+        // scale so that the average weight is 1
+        std::vector<double> scaled(numWeights);
+        std::vector<int> small;
+        std::vector<int> large;
+
+        for (int k = 0; k < numWeights; k++)
+        {
+            scaled[k] = weights[k] * numWeights / sum;
+            if (scaled[k] < 1)
+            {
+                small.push_back(k);
+            }
+            else
+            {
+                large.push_back(k);
+            }
+        }
+
+        m_aliasChance.assign(numWeights, 1.0);
+        m_alias.assign(numWeights, 0);
+
+        // fill each small bucket up to 1 with the excess of a large one
+        while (!small.empty() && !large.empty())
+        {
+            const int smallIndex = small.back();
+            small.pop_back();
+            const int largeIndex = large.back();
+            large.pop_back();
+
+            m_aliasChance[smallIndex] = scaled[smallIndex];
+            m_alias[smallIndex] = largeIndex;
+
+            scaled[largeIndex] = (scaled[largeIndex] + scaled[smallIndex]) - 1;
+            if (scaled[largeIndex] < 1)
+            {
+                small.push_back(largeIndex);
+            }
+            else
+            {
+                large.push_back(largeIndex);
+            }
+        }
+
+        // whatever is left is 1 up to rounding errors, so it keeps its default chance of 1
+        for (auto index : small)
+        {
+            m_alias[index] = index;
+        }
+
+        for (auto index : large)
+        {
+            m_alias[index] = index;
+        }
+    }
+
+    int ParentSampler::sample()
+    {
+        const int numIds = getNumCandidates();
+        if (numIds == 0)
+        {
+            return -1;
+        }
+
+        std::uniform_int_distribution<int> rndIndex(0, numIds - 1);
+
+        if (m_selectionMethod == SM_TOURNAMENT)
+        {
+            // the ids are sorted by score, so the best participant is the one with the lowest index
+            int bestIndex = rndIndex(m_generator);
+            for (int k = 1; k < m_tournamentSize; k++)
+            {
+                bestIndex = std::min(bestIndex, rndIndex(m_generator));
+            }
+
+            return m_ids[bestIndex];
+        }
+
+        const int index = rndIndex(m_generator);
+        return m_ids[m_generator.nextDouble() < m_aliasChance[index] ? index : m_alias[index]];
+    }
+}
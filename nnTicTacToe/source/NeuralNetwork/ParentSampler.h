@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "General/Globals.h"
+#include "Math/Random.h"
+
+namespace NeuralNetwork
+{
+    /// picks parents for crossover; set up once per generation, after which every draw is O(1)
+    /// (O(tournament size) for tournament selection)
+    class ParentSampler
+    {
+    public:
+        ParentSampler();
+
+    public:
+        /// known names: "fitness_proportional", "tournament", "rank"
+        /// returns false (and leaves selectionMethod untouched) for unknown names
+        static bool parseSelectionMethod(const std::string& name, SelectionMethod& selectionMethod);
+        static std::string getSelectionMethodDescription(SelectionMethod selectionMethod);
+
+        /// idsSortedByScore: candidate ids, best first; scores: their scores in the same order
+        /// - fitness proportional: chance proportional to (score - lowest score), the worst set is never picked
+        ///   (falls back to uniform if fewer than two sets have a positive weight)
+        /// - tournament: best of tournamentSize uniformly picked candidates
+        /// - rank: chance proportional to (n - rank), so the best set is n times as likely as the worst one
+        void setup(SelectionMethod selectionMethod, const std::vector<int>& idsSortedByScore, const std::vector<double>& scores, int tournamentSize = 2);
+
+        /// returns -1 if there are no candidates
+        int sample();
+
+        int getNumCandidates() const { return static_cast<int>(m_ids.size()); }
+
+        /// re-seed for reproducible draws independent of the master seed (seeded from Math::Random by default)
+        void seed(uint64_t seedValue) { m_generator = Math::RandomGenerator(seedValue); }
+
+    private:
+        /// Vose's alias method: one uniform index and one uniform chance per draw
+        void setupAliasTable(const std::vector<double>& weights);
+
+    private:
+        SelectionMethod m_selectionMethod = SM_FITNESS_PROPORTIONAL;
+        int m_tournamentSize = 2;
+
+        std::vector<int> m_ids;
+        std::vector<double> m_aliasChance; /// chance of keeping index k rather than switching to m_alias[k]
+        std::vector<int> m_alias;
+
+        Math::RandomGenerator m_generator;
+    };
+}
@@ -0,0 +1,76 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "ScoreRanking.h"
+
+namespace NeuralNetwork
+{
+    void ScoreRanking::insert(int id, double score)
+    {
+        const bool inserted = m_entries.emplace(score, id).second;
+        assert(inserted);
+        (void)inserted;
+    }
+
+    void ScoreRanking::remove(int id, double score)
+    {
+        const size_t numErased = m_entries.erase(std::make_pair(score, id));
+        assert(numErased == 1);
+        (void)numErased;
+    }
+
+    void ScoreRanking::update(int id, double oldScore, double newScore)
+    {
+        if (oldScore == newScore)
+        {
+            return;
+        }
+
+        remove(id, oldScore);
+        insert(id, newScore);
+    }
+
+    void ScoreRanking::getBestIds(int maxNumIds, std::vector<int>& ids) const
+    {
+        ids.clear();
+        ids.reserve(std::min(maxNumIds, size()));
+
+        for (auto it = m_entries.begin(); it != m_entries.end() && static_cast<int>(ids.size()) < maxNumIds; ++it)
+        {
+            ids.push_back(it->second);
+        }
+    }
+
+    void ScoreRanking::getWorstIds(int maxNumIds, std::vector<int>& ids) const
+    {
+        ids.clear();
+        ids.reserve(std::min(maxNumIds, size()));
+
+        for (auto it = m_entries.rbegin(); it != m_entries.rend() && static_cast<int>(ids.size()) < maxNumIds; ++it)
+        {
+            ids.push_back(it->second);
+        }
+    }
+
+    int ScoreRanking::getBestId() const
+    {
+        if (m_entries.empty())
+        {
+            return -1;
+        }
+
+        return m_entries.begin()->second;
+    }
+
+    double ScoreRanking::getLowestScore() const
+    {
+        if (m_entries.empty())
+        {
+            return 0.0;
+        }
+
+        return m_entries.rbegin()->first;
+    }
+}
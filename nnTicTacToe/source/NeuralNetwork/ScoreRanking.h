@@ -0,0 +1,57 @@
+#pragma once
+
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace NeuralNetwork
+{
+    /// ids ordered by score (descending), ties are ordered by id (ascending)
+    /// kept up to date incrementally, so reading the ranking never needs to sort
+    class ScoreRanking
+    {
+    public:
+        ScoreRanking() = default;
+
+    public:
+        void insert(int id, double score);
+
+        /// score needs to be the score the id was inserted (or last updated) with
+        void remove(int id, double score);
+        void update(int id, double oldScore, double newScore);
+
+        void clear() { m_entries.clear(); }
+        bool empty() const { return m_entries.empty(); }
+        int size() const { return static_cast<int>(m_entries.size()); }
+
+        /// fills ids with the (up to) maxNumIds best ids, best first
+        /// only the requested entries are visited, so this is O(log n + maxNumIds)
+        void getBestIds(int maxNumIds, std::vector<int>& ids) const;
+        void getAllIds(std::vector<int>& ids) const { getBestIds(size(), ids); }
+
+        /// fills ids with the (up to) maxNumIds worst ids, worst first (in the reverse order of getBestIds)
+        void getWorstIds(int maxNumIds, std::vector<int>& ids) const;
+
+        /// returns -1 if the ranking is empty
+        int getBestId() const;
+
+        /// lowest score in the ranking, 0 if the ranking is empty
+        double getLowestScore() const;
+
+    private:
+        struct ScoreOrder
+        {
+            bool operator()(const std::pair<double, int>& lhs, const std::pair<double, int>& rhs) const
+            {
+                if (lhs.first != rhs.first)
+                {
+                    return lhs.first > rhs.first;
+                }
+
+                return lhs.second < rhs.second;
+            }
+        };
+
+        std::set<std::pair<double, int>, ScoreOrder> m_entries; /// (score, id)
+    };
+}
@@ -1,13 +1,21 @@
 #include "stdafx.h"
 
+#include <algorithm>
 #include <assert.h> 
 #include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 #include "BaseTrainer.h"
 #include "3rdparty/json/json.hpp"
 
 #include "FileIO/FileManager.h"
+#include "General/NumaTopology.h"
+#include "Game/InputEncoder.h"
+#include "Game/Player.h"
+#include "Math/LossFunctions.h"
+#include "Math/Random.h"
 
 namespace Training
 {
@@ -80,7 +88,7 @@ namespace Training
     {
         json j;
 
-        if (!FileManager::readJsonFromFile(CONFIG_FILE_NAME, j))
+        if (!FileManager::readJsonFromFile(CONFIG_FILE_NAME, j, true))
         {
             return false;
         }
@@ -106,10 +114,41 @@ namespace Training
         m_paramData.numBestSetsMutatedDuringEvolution = j.at("num_best_sets_mutated_during_evolution").get<int>();
         m_paramData.numAddedRandomSetsDuringEvolution = j.at("num_random_sets_added_during_evolution").get<int>();
 
+        const std::string selectionMethodName = j.at("selection_method").get<std::string>();
+        if (!ParentSampler::parseSelectionMethod(selectionMethodName, m_paramData.selectionMethod))
+        {
+            std::ostringstream buffer;
+            buffer << "Unknown selection method \"" << selectionMethodName << "\", using " << ParentSampler::getSelectionMethodDescription(m_paramData.selectionMethod) << " instead";
+            PRINT_ERROR(buffer);
+        }
+
+        m_paramData.tournamentSize = j.at("tournament_size").get<int>();
+        m_paramData.hallOfFameSize = j.at("hall_of_fame_size").get<int>();
+        m_paramData.archiveRetiredSets = j.at("archive_retired_sets").get<bool>();
+
+        const std::string precisionName = j.at("parameter_precision").get<std::string>();
+        if (!ParameterStore::parsePrecision(precisionName, m_paramData.precision))
+        {
+            std::ostringstream buffer;
+            buffer << "Unknown parameter precision \"" << precisionName << "\", using " << ParameterStore::getPrecisionDescription(m_paramData.precision) << " instead";
+            PRINT_ERROR(buffer);
+        }
+
         m_numIterations = j.at("num_iterations").get<int>();
         m_numMatches = j.at("num_matches").get<int>();
+        m_adaptiveNumMatches = j.at("adaptive_num_matches").get<bool>();
+        m_commonRandomOpponents = j.at("common_random_opponents").get<bool>();
+
+        const std::string matchOpponentName = j.at("match_opponent").get<std::string>();
+        if (!Game::BasePlayer::parseMatchOpponent(matchOpponentName, m_matchOpponent))
+        {
+            std::ostringstream buffer;
+            buffer << "Unknown match opponent \"" << matchOpponentName << "\", using " << Game::BasePlayer::getMatchOpponentDescription(m_matchOpponent) << " instead";
+            PRINT_ERROR(buffer);
+        }
 
         m_activationFunctionType = j.at("activation_function").get<std::string>();
+        m_approximateActivationFunctions = j.at("approximate_activation_functions").get<bool>();
 
         const auto& vec = j.at("num_hidden_nodes");
         for (json::const_iterator it = vec.begin(); it != vec.end(); ++it)
@@ -117,7 +156,58 @@ namespace Training
             m_numHiddenNodes.push_back(*it);
         }
 
-        m_useBackpropagation = j.at("use_backpropagation").get<bool>();
+        const std::string trainingMethodName = j.at("training_method").get<std::string>();
+        if (!TrainingMethodHandler::parseTrainingMethod(trainingMethodName, m_trainingMethod))
+        {
+            std::ostringstream buffer;
+            buffer << "Unknown training method \"" << trainingMethodName << "\", using " << TrainingMethodHandler::getTrainingMethodDescription(m_trainingMethod) << " instead";
+            PRINT_ERROR(buffer);
+        }
+
+        m_esData.noiseStandardDeviation = j.at("es_noise_standard_deviation").get<double>();
+        m_esData.learningRate = j.at("es_learning_rate").get<double>();
+        m_esData.noiseTableSize = j.at("es_noise_table_size").get<int>();
+
+        m_cmaData.initialStepSize = j.at("cma_initial_step_size").get<double>();
+        m_cmaData.separable = j.at("cma_separable_covariance").get<bool>();
+
+        m_lbfgsHistorySize = j.at("lbfgs_history_size").get<int>();
+
+        m_islandData.numIslands = j.at("num_islands").get<int>();
+        m_islandData.migrationInterval = j.at("migration_interval").get<int>();
+        m_islandData.numMigrants = j.at("num_migrants").get<int>();
+        m_steadyStateEvolution = j.at("steady_state_evolution").get<bool>();
+
+        m_halvingData.numRungs = j.at("successive_halving_rungs").get<int>();
+        m_halvingData.reductionFactor = j.at("successive_halving_reduction_factor").get<int>();
+
+        const std::string lossFunctionName = j.at("loss_function").get<std::string>();
+        if (!Math::LossFunctions::parseLossFunction(lossFunctionName, m_lossFunction))
+        {
+            std::ostringstream buffer;
+            buffer << "Unknown loss function \"" << lossFunctionName << "\", using " << Math::LossFunctions::getLossFunctionDescription(m_lossFunction) << " instead";
+            PRINT_ERROR(buffer);
+        }
+
+        const std::string inputEncodingName = j.at("input_encoding").get<std::string>();
+        if (!Game::InputEncoder::parseInputEncoding(inputEncodingName, m_inputEncoding))
+        {
+            std::ostringstream buffer;
+            buffer << "Unknown input encoding \"" << inputEncodingName << "\", using " << Game::InputEncoder::getInputEncodingDescription(m_inputEncoding) << " instead";
+            PRINT_ERROR(buffer);
+        }
+
+        m_numThreads = j.at("num_threads").get<int>();
+        m_pinThreadsToNumaNodes = j.at("pin_threads_to_numa_nodes").get<bool>();
+        m_minParallelLayerWidth = j.at("min_parallel_layer_width").get<int>();
+
+        m_fitnessCacheSize = j.at("fitness_cache_size").get<int>();
+        m_policyCacheSize = j.at("policy_cache_size").get<int>();
+
+        m_randomSeed = j.at("random_seed").get<uint64_t>();
+
+        // islands started with the same seed would only evolve copies of the same population
+        Math::Random::setMasterSeed(m_randomSeed != 0 ? m_randomSeed + m_islandData.islandIndex : 0);
 
         return true;
     }
@@ -133,11 +223,89 @@ namespace Training
             return false;
         }
 
-        if (!m_useBackpropagation && m_numIterations > 1)
+        if (usesGradients() && m_approximateActivationFunctions)
+        {
+            std::ostringstream buffer;
+            buffer << "Warning: Approximate activation functions are only meant for inference and won't be used by gradient based training methods";
+            std::cout << buffer.str() << std::endl;
+            PRINT_LOG(buffer);
+        }
+
+        if (m_trainingMethod == TM_EVOLUTION_STRATEGIES && m_esData.noiseStandardDeviation <= 0)
+        {
+            std::ostringstream buffer;
+            buffer << "Option mismatch: the noise standard deviation of the evolution strategies must be positive (currently "
+                << m_esData.noiseStandardDeviation << ")";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        if (m_trainingMethod == TM_CMA_ES && m_cmaData.initialStepSize <= 0)
         {
+            std::ostringstream buffer;
+            buffer << "Option mismatch: the initial CMA-ES step size must be positive (currently " << m_cmaData.initialStepSize << ")";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        if (m_fitnessCacheSize > 0 && usesGradients())
+        {
+            std::ostringstream buffer;
+            buffer << "Option mismatch: the fitness cache can't be used with " << TrainingMethodHandler::getTrainingMethodDescription(m_trainingMethod)
+                << ", evaluating a set also trains it";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        if (m_policyCacheSize > 0 && usesGradients())
+        {
+            std::ostringstream buffer;
+            buffer << "Option mismatch: the policy cache can't be used with " << TrainingMethodHandler::getTrainingMethodDescription(m_trainingMethod)
+                << ", evaluating a set also trains it";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        if (m_matchOpponent != MO_NONE && m_numMatches < 1)
+        {
+            std::ostringstream buffer;
+            buffer << "Option mismatch: at least one match needs to be played against the " << Game::BasePlayer::getMatchOpponentDescription(m_matchOpponent)
+                << " (currently " << m_numMatches << ")";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        if (m_halvingData.numRungs < 1 || m_halvingData.reductionFactor < 2)
+        {
+            std::ostringstream buffer;
+            buffer << "Option mismatch: successive halving needs at least 1 rung (currently " << m_halvingData.numRungs
+                << ") and a reduction factor of at least 2 (currently " << m_halvingData.reductionFactor << ")";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        if (m_halvingData.numRungs > 1 && (m_trainingMethod != TM_GENETIC_ALGORITHM || m_steadyStateEvolution))
+        {
+            std::ostringstream buffer;
+            buffer << "Option mismatch: successive halving is only supported by the generational genetic algorithm; "
+                << "the other training methods need all sets to be scored the same way";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        if (m_trainingMethod == TM_GENETIC_ALGORITHM && m_numIterations > 1)
+        {
+            if (m_steadyStateEvolution && m_islandData.numIslands > 1)
+            {
+                std::ostringstream buffer;
+                buffer << "Option mismatch: steady-state evolution can't be combined with the island model (currently " << m_islandData.numIslands << " islands)";
+                PRINT_ERROR(buffer);
+                return false;
+            }
+
             const int numSpecialEvolutionSets = m_paramData.numBestSetsKeptDuringEvolution + m_paramData.numBestSetsMutatedDuringEvolution + m_paramData.numAddedRandomSetsDuringEvolution;
 
-            if (m_paramData.numParamSets <= numSpecialEvolutionSets)
+            if (!m_steadyStateEvolution && m_paramData.numParamSets <= numSpecialEvolutionSets)
             {
                 std::ostringstream buffer;
                 buffer << "Option mismatch: the number of sets added during the evolution step (kept, mutated and randomly added; currently "
@@ -147,6 +315,25 @@ namespace Training
                 return false;
             }
 
+            if (m_islandData.numIslands > 1 && (m_islandData.islandIndex < 0 || m_islandData.islandIndex >= m_islandData.numIslands
+                || m_islandData.migrationInterval < 1 || m_islandData.numMigrants < 1))
+            {
+                std::ostringstream buffer;
+                buffer << "Option mismatch: the island index (currently " << m_islandData.islandIndex << ") must be in [0, " << m_islandData.numIslands
+                    << "), and the migration interval (" << m_islandData.migrationInterval << ") and number of migrants (" << m_islandData.numMigrants
+                    << ") must be at least 1";
+                PRINT_ERROR(buffer);
+                return false;
+            }
+
+            if (m_paramData.selectionMethod == SM_TOURNAMENT && m_paramData.tournamentSize < 1)
+            {
+                std::ostringstream buffer;
+                buffer << "Option mismatch: the tournament size must be at least 1 (currently " << m_paramData.tournamentSize << ")";
+                PRINT_ERROR(buffer);
+                return false;
+            }
+
             if (m_paramData.mutationBonusChance > 0 && m_paramData.mutationBonusScale == 0
                 || m_paramData.mutationBonusChance <= 0 && m_paramData.mutationBonusScale != 0)
             {
@@ -166,7 +353,43 @@ namespace Training
         std::ostringstream buffer;
         buffer << getName() << ": ";
         buffer << std::endl << "  #matches: " << m_numMatches;
+        if (m_matchOpponent == MO_NONE)
+        {
+            buffer << " (no matches are played)";
+        }
+        else
+        {
+            buffer << (m_adaptiveNumMatches ? " at most" : "") << " against the " << Game::BasePlayer::getMatchOpponentDescription(m_matchOpponent);
+            if (m_commonRandomOpponents)
+            {
+                buffer << " (the same opponent moves for all sets of an iteration)";
+            }
+        }
         buffer << std::endl << "  #iterations: " << m_numIterations;
+        buffer << std::endl << "  training method: " << TrainingMethodHandler::getTrainingMethodDescription(m_trainingMethod);
+        if (m_trainingMethod == TM_GENETIC_ALGORITHM && m_steadyStateEvolution)
+        {
+            buffer << " (steady-state)";
+        }
+        if (m_halvingData.numRungs > 1)
+        {
+            buffer << std::endl << "  successive halving: " << m_halvingData.numRungs << " rungs, keeping 1 / " << m_halvingData.reductionFactor << " of the sets per rung";
+        }
+        buffer << std::endl << "  input encoding: " << Game::InputEncoder::getInputEncodingDescription(m_inputEncoding);
+        buffer << std::endl << "  #threads: " << (m_numThreads > 0 ? std::to_string(m_numThreads) : "all");
+        if (m_pinThreadsToNumaNodes)
+        {
+            buffer << " (pinned to " << General::NumaTopology::getNumNodes() << " NUMA nodes)";
+        }
+        if (m_fitnessCacheSize > 0)
+        {
+            buffer << std::endl << "  fitness cache size: " << m_fitnessCacheSize;
+        }
+        if (m_policyCacheSize > 0)
+        {
+            buffer << std::endl << "  policy cache size: " << m_policyCacheSize;
+        }
+        buffer << std::endl << "  random seed: " << Math::Random::getMasterSeed() << (m_randomSeed == 0 ? " (picked randomly)" : "");
         buffer << std::endl;
         PRINT_LOG(buffer);
     }
@@ -188,12 +411,16 @@ namespace Training
         const NetworkSizeData sizeData = getNetworkSizeData();
 
         m_nodeNetwork = std::make_shared<NodeNetwork>();
+        m_nodeNetwork->setUseApproximateActivation(m_approximateActivationFunctions && !usesGradients());
         if (!m_nodeNetwork->createNetwork(sizeData, m_activationFunctionType))
         {
             PRINT_ERROR("Network creation failed!");
             return false;
         }
 
+        m_threadPool = std::make_shared<General::ThreadPool>(m_numThreads, m_pinThreadsToNumaNodes);
+        m_nodeNetwork->setThreadPool(m_threadPool, m_minParallelLayerWidth);
+
         return true;
     }
 
@@ -209,8 +436,11 @@ namespace Training
         // setup parameter manager
         m_paramData.numParams = m_nodeNetwork->getNumParameters();
         m_paramManager = std::make_shared<ParameterManager>(m_paramData);
+        m_paramManager->setThreadPool(m_threadPool);
         m_paramManager->describeParameterManager();
 
+        m_fitnessCache.setCapacity(m_fitnessCacheSize);
+
         // create N different parameter sets
         for (int k = 0; k < m_paramData.numParamSets; k++)
         {
@@ -222,6 +452,56 @@ namespace Training
         return true;
     }
 
+    void BaseTrainer::computeRungEndSteps(int numSteps, int numRungs, int reductionFactor, std::vector<int>& rungEndSteps)
+    {
+        rungEndSteps.clear();
+        for (int rung = 0; rung < numRungs; rung++)
+        {
+            int endStep = numSteps;
+            for (int k = rung; k < numRungs - 1; k++)
+            {
+                endStep /= reductionFactor;
+            }
+
+            endStep = std::max(endStep, 1);
+            if (rungEndSteps.empty() || endStep > rungEndSteps.back())
+            {
+                rungEndSteps.push_back(endStep);
+            }
+        }
+    }
+
+    int BaseTrainer::computeNumSurvivors(int numRemaining, int minNumSurvivors, int reductionFactor)
+    {
+        return std::min(numRemaining, std::max(minNumSurvivors, (numRemaining + reductionFactor - 1) / reductionFactor));
+    }
+
+    void BaseTrainer::capEliminatedScores(double lowestSurvivorScore, std::vector<std::vector<double>>& eliminatedScoresPerRung)
+    {
+        // a set dropped at some rung may not rank above the sets that got past that rung,
+        // even if its score on the first few steps is higher than their score on all steps
+        for (int rung = static_cast<int>(eliminatedScoresPerRung.size()) - 1; rung >= 0; rung--)
+        {
+            double lowestScore = lowestSurvivorScore;
+            for (auto& score : eliminatedScoresPerRung[rung])
+            {
+                if (score >= lowestSurvivorScore)
+                {
+                    score = std::nextafter(lowestSurvivorScore, -std::numeric_limits<double>::max());
+                }
+
+                lowestScore = std::min(lowestScore, score);
+            }
+
+            lowestSurvivorScore = lowestScore;
+        }
+    }
+
+    double BaseTrainer::getEvaluationThroughput() const
+    {
+        return (m_evaluationSeconds > 0) ? m_numEvaluatedSets / m_evaluationSeconds : 0;
+    }
+
     void BaseTrainer::run()
     {
         const auto processStart = std::chrono::high_resolution_clock::now();
@@ -247,6 +527,7 @@ namespace Training
         const std::chrono::duration<double> elapsedSeconds = processEnd - processStart;
 
         std::ostringstream buffer;
+        buffer << "Evaluated " << m_numEvaluatedSets << " parameter sets (" << getEvaluationThroughput() << " per second)" << std::endl;
         buffer << "Time taken: " << elapsedSeconds.count() << " seconds";
         std::cout << buffer.str();
         PRINT_LOG(buffer);
@@ -266,6 +547,31 @@ namespace Training
 
         const bool isLastIteration = (iteration == m_numIterations - 1);
 
+        const auto evaluationStart = std::chrono::high_resolution_clock::now();
+        double numEvaluatedSets = 0;
+
+        int numCachedSets = 0;
+        std::vector<double> params;
+
+        // the raced sets have a score afterwards, so the loop below only logs them
+        if (m_halvingData.numRungs > 1 && getNumEvaluationSteps() > 0)
+        {
+            // sets found in the fitness cache don't need to be raced
+            if (m_fitnessCache.isEnabled())
+            {
+                for (auto id : currentIds)
+                {
+                    if (!m_paramManager->isEvaluated(id))
+                    {
+                        m_trainingMethodHandler->getParameters(id, params);
+                        numCachedSets += applyCachedFitness(id, params) ? 1 : 0;
+                    }
+                }
+            }
+
+            numEvaluatedSets = evaluateBySuccessiveHalving(currentIds, isLastIteration);
+        }
+
         for (auto id : currentIds)
         {
             // reset network parameters
@@ -275,41 +581,83 @@ namespace Training
                    << std::endl << "Trying parameter set " << id << ": ";
             PRINT_LOG(buffer);
 
-            ParamSet pset;
-            m_paramManager->getParamSetForId(id, pset);
-
-            if (pset.score != 0)
+            if (m_paramManager->isEvaluated(id))
             {
-                // skip parameter sets for which we already have a score from the previous run
+                // skip parameter sets for which we already have a score from the previous run (or successive halving)
                 // but print the previous score again for convenience
                 describeScoreForId(id);
                 continue;
             }
 
-            m_nodeNetwork->assignParameters(pset.params);
-            handleNetworkComputation(id, isLastIteration);
+            m_trainingMethodHandler->getParameters(id, params);
+
+            // a set identical to one that has already been scored is scored as soon as it's its turn,
+            // e.g. steady-state evolution replaces sets in the order they are scored
+            if (m_fitnessCache.isEnabled() && applyCachedFitness(id, params))
+            {
+                numCachedSets++;
+            }
+            else
+            {
+                m_nodeNetwork->assignParameters(params);
+                handleNetworkComputation(id, isLastIteration);
+
+                // update score
+                const double newScore = computeFinalScore(id);
+                m_paramManager->setScore(id, newScore);
+                numEvaluatedSets++;
+
+                cacheFitness(id, params);
+            }
 
-            // update score
-            const double newScore = computeFinalScore(id);
-            m_paramManager->setScore(id, newScore);
             describeScoreForId(id);
+            m_trainingMethodHandler->candidateEvaluated(id, isLastIteration);
         }
 
+        if (m_fitnessCache.isEnabled())
+        {
+            buffer.clear();
+            buffer.str("");
+            buffer << "Found " << numCachedSets << " parameter sets in the fitness cache";
+            PRINT_LOG(buffer);
+        }
+
+        const std::chrono::duration<double> evaluationSeconds = std::chrono::high_resolution_clock::now() - evaluationStart;
+        m_numEvaluatedSets += numEvaluatedSets;
+        m_evaluationSeconds += evaluationSeconds.count();
+
+        buffer.clear();
+        buffer.str("");
+        buffer << "Evaluated " << numEvaluatedSets << " parameter sets in " << evaluationSeconds.count() << " seconds ("
+            << (evaluationSeconds.count() > 0 ? numEvaluatedSets / evaluationSeconds.count() : 0) << " per second)";
+        std::cout << buffer.str() << std::endl;
+        PRINT_LOG(buffer);
+
         std::vector<int> bestSetIds;
         m_paramManager->getParameterSetIdsSortedByScore(bestSetIds);
         assert(!bestSetIds.empty());
 
-        m_idsPerIteration.emplace(iteration, bestSetIds);
-
-        ParamSet pset;
-        m_paramManager->getParamSetForId(bestSetIds[0], pset);
+        handleIterationSummary(iteration, bestSetIds);
 
         buffer.clear();
         buffer.str("");
-        buffer << std::endl << "Best parameter set: " << bestSetIds[0] << ", with score: " << pset.score;
+        buffer << std::endl << "Best parameter set: " << bestSetIds[0] << ", with score: " << m_paramManager->getScore(bestSetIds[0]);
         PRINT_LOG(buffer);
 
         m_trainingMethodHandler->postIteration(isLastIteration);
+
+        // bounded memory: only keep the active sets and the hall of fame
+        if (m_paramData.hallOfFameSize >= 0)
+        {
+            const int numEvicted = m_paramManager->evictRetiredParameterSets();
+            releaseRemovedParamSets();
+
+            buffer.clear();
+            buffer.str("");
+            buffer << "Removed " << numEvicted << " inactive parameter sets";
+            PRINT_LOG(buffer);
+        }
+
         return isLastIteration;
     }
 
@@ -318,6 +666,114 @@ namespace Training
         // nothing to do
     }
 
+    int BaseTrainer::getNumEvaluationSteps() const
+    {
+        return 0;
+    }
+
+    void BaseTrainer::handlePartialNetworkComputation(int id, int firstStep, int endStep, bool isLastIteration)
+    {
+        // nothing to do
+    }
+
+    double BaseTrainer::evaluateBySuccessiveHalving(const std::vector<int>& ids, bool isLastIteration)
+    {
+        std::vector<int> racedIds;
+        for (auto id : ids)
+        {
+            if (!m_paramManager->isEvaluated(id))
+            {
+                racedIds.push_back(id);
+            }
+        }
+
+        const int numSteps = getNumEvaluationSteps();
+        const int minNumSurvivors = std::max(1, std::max(m_paramData.numBestSetsKeptDuringEvolution, m_paramData.numBestSetsMutatedDuringEvolution));
+
+        std::vector<int> rungEndSteps;
+        computeRungEndSteps(numSteps, m_halvingData.numRungs, m_halvingData.reductionFactor, rungEndSteps);
+        const int numRungs = static_cast<int>(rungEndSteps.size());
+
+        std::vector<int> remainingIds = racedIds;
+        std::vector<std::vector<int>> eliminatedIdsPerRung(numRungs);
+        std::vector<double> params;
+        int numEvaluatedSteps = 0;
+        int64_t numStepsOfAllSets = 0;
+
+        std::ostringstream buffer;
+        buffer << "Successive halving of " << racedIds.size() << " parameter sets:";
+        if (numRungs < m_halvingData.numRungs)
+        {
+            buffer << std::endl << " only " << numRungs << " of " << m_halvingData.numRungs << " rungs, there are too few steps for the others";
+        }
+
+        for (int rung = 0; rung < numRungs; rung++)
+        {
+            const int endStep = rungEndSteps[rung];
+            for (auto id : remainingIds)
+            {
+                // the scores of the earlier rungs are kept, so only the new steps are evaluated
+                m_trainingMethodHandler->getParameters(id, params);
+                m_nodeNetwork->assignParameters(params);
+                handlePartialNetworkComputation(id, numEvaluatedSteps, endStep, isLastIteration);
+                m_paramManager->setScore(id, computeFinalScore(id));
+
+                // the sets dropped at earlier rungs only have a partial score
+                if (rung == numRungs - 1)
+                {
+                    cacheFitness(id, params);
+                }
+            }
+
+            numStepsOfAllSets += static_cast<int64_t>(endStep - numEvaluatedSteps) * remainingIds.size();
+            numEvaluatedSteps = endStep;
+            buffer << std::endl << " rung " << rung << ": " << remainingIds.size() << " sets scored on " << endStep << " of " << numSteps << " steps";
+
+            if (rung == numRungs - 1)
+            {
+                break;
+            }
+
+            // ties keep the older set
+            std::stable_sort(remainingIds.begin(), remainingIds.end(), [this](int id1, int id2) { return m_paramManager->getScore(id1) > m_paramManager->getScore(id2); });
+
+            const int numSurvivors = computeNumSurvivors(static_cast<int>(remainingIds.size()), minNumSurvivors, m_halvingData.reductionFactor);
+            eliminatedIdsPerRung[rung].assign(remainingIds.begin() + numSurvivors, remainingIds.end());
+            remainingIds.resize(numSurvivors);
+        }
+
+        double lowestSurvivorScore = std::numeric_limits<double>::max();
+        for (auto id : remainingIds)
+        {
+            lowestSurvivorScore = std::min(lowestSurvivorScore, m_paramManager->getScore(id));
+        }
+
+        std::vector<std::vector<double>> eliminatedScoresPerRung(numRungs);
+        for (int rung = 0; rung < numRungs; rung++)
+        {
+            for (auto id : eliminatedIdsPerRung[rung])
+            {
+                eliminatedScoresPerRung[rung].push_back(m_paramManager->getScore(id));
+            }
+        }
+
+        capEliminatedScores(lowestSurvivorScore, eliminatedScoresPerRung);
+        for (int rung = 0; rung < numRungs; rung++)
+        {
+            for (size_t k = 0; k < eliminatedIdsPerRung[rung].size(); k++)
+            {
+                const int id = eliminatedIdsPerRung[rung][k];
+                if (eliminatedScoresPerRung[rung][k] != m_paramManager->getScore(id))
+                {
+                    m_paramManager->setScore(id, eliminatedScoresPerRung[rung][k]);
+                }
+            }
+        }
+
+        PRINT_LOG(buffer);
+        return (numSteps > 0) ? static_cast<double>(numStepsOfAllSets) / numSteps : 0;
+    }
+
     void BaseTrainer::describeScoreForId(int id) const
     {
         // nothing to do
@@ -328,6 +784,49 @@ namespace Training
         return 0;
     }
 
+    void BaseTrainer::handleIterationSummary(int iteration, const std::vector<int>& idsSortedByScore)
+    {
+        // nothing to do
+    }
+
+    void BaseTrainer::releaseRemovedParamSets()
+    {
+        // nothing to do
+    }
+
+    void BaseTrainer::handleCachedScore(int id, int cachedId)
+    {
+        // nothing to do
+    }
+
+    bool BaseTrainer::applyCachedFitness(int id, const std::vector<double>& params)
+    {
+        FitnessCache::Entry entry;
+        if (!m_fitnessCache.find(FitnessCache::computeHash(params), entry))
+        {
+            return false;
+        }
+
+        m_paramManager->setScore(id, entry.score);
+        m_paramManager->setError(id, entry.error);
+        handleCachedScore(id, entry.id);
+        return true;
+    }
+
+    void BaseTrainer::cacheFitness(int id, const std::vector<double>& params)
+    {
+        if (!m_fitnessCache.isEnabled())
+        {
+            return;
+        }
+
+        FitnessCache::Entry entry;
+        entry.id = id;
+        entry.score = m_paramManager->getScore(id);
+        entry.error = m_paramManager->getError(id);
+        m_fitnessCache.insert(FitnessCache::computeHash(params), entry);
+    }
+
     void BaseTrainer::handleParamSetEvolution()
     {
     }
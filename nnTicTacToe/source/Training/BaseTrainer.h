@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
+#include "General/ThreadPool.h"
+#include "NeuralNetwork/FitnessCache.h"
 #include "NeuralNetwork/NodeNetwork.h"
 #include "NeuralNetwork/ParameterManager.h"
 #include "TrainingMethodHandler.h"
@@ -25,10 +28,37 @@ namespace Training
         virtual bool setupParameters();
         virtual bool handleOptionValidation() const;
 
+    public:
+        /// position of this process in the island model ring (see IslandModelData)
+        void setIslandIndex(int islandIndex) { m_islandData.islandIndex = islandIndex; }
+
+        /// parameter sets evaluated per second of evaluation time, over all iterations so far
+        /// a set dropped during successive halving counts as the fraction of the steps it was evaluated on
+        double getEvaluationThroughput() const;
+
+    public:
+        // successive halving
+        /// the last rung covers all numSteps steps, each rung before it a reductionFactor-th of the next one;
+        /// rungs that wouldn't add any steps are left out, so there may be fewer than numRungs
+        static void computeRungEndSteps(int numSteps, int numRungs, int reductionFactor, std::vector<int>& rungEndSteps);
+
+        /// the best 1 / reductionFactor of the numRemaining sets (rounded up) get to the next rung, but at least minNumSurvivors
+        static int computeNumSurvivors(int numRemaining, int minNumSurvivors, int reductionFactor);
+
+        /// lowers the scores of the sets dropped at each rung below the lowest score of the sets that got further
+        /// eliminatedScoresPerRung[k] are the scores of the sets dropped at rung k, lowestSurvivorScore is the lowest score of the last rung
+        static void capEliminatedScores(double lowestSurvivorScore, std::vector<std::vector<double>>& eliminatedScoresPerRung);
+
     public:
         virtual void run();
         virtual bool handleTrainingIteration(int iteration);
         virtual void handleNetworkComputation(int id, bool isLastIteration);
+
+        /// number of parts (e.g. training boards) the evaluation of a set can be split into, 0 if it can't be split
+        virtual int getNumEvaluationSteps() const;
+
+        /// evaluates parameter set id on the steps [firstStep, endStep) only; the results of several calls add up
+        virtual void handlePartialNetworkComputation(int id, int firstStep, int endStep, bool isLastIteration);
         virtual void handleParamSetEvolution();
 
     protected:
@@ -36,10 +66,31 @@ namespace Training
         virtual void describeScoreForId(int id) const;
         virtual double computeFinalScore(int id);
 
+        /// called once per iteration with the active sets sorted by score, while they all still exist
+        virtual void handleIterationSummary(int iteration, const std::vector<int>& idsSortedByScore);
+
+        /// drops the per-set data kept for sets that the parameter manager doesn't know anymore
+        virtual void releaseRemovedParamSets();
+
+        /// set id got the score of the identical set cachedId from the fitness cache (cachedId may have been removed already)
+        virtual void handleCachedScore(int id, int cachedId);
+
     private:
         bool readConfigValues();
         void describeTrainer() const;
 
+        /// scores the sets in ids that don't have a score yet by successive halving (see SuccessiveHalvingData)
+        /// returns the evaluated steps in units of complete evaluations, i.e. the sets dropped early count partially
+        double evaluateBySuccessiveHalving(const std::vector<int>& ids, bool isLastIteration);
+
+        /// params are the values set id is evaluated with
+        /// returns true if an identical set has already been scored, and copies its score and error
+        bool applyCachedFitness(int id, const std::vector<double>& params);
+        void cacheFitness(int id, const std::vector<double>& params);
+
+        /// true for the training methods that follow the gradient of the loss
+        bool usesGradients() const { return m_trainingMethod == TM_BACKPROPAGATION || m_trainingMethod == TM_LBFGS; }
+
     protected:
         // parameters
         ParameterManagerData m_paramData; /// collection of data needed by the parameter manager
@@ -49,9 +100,40 @@ namespace Training
         /// actually, we run twice this amount (trying both as first and second player)
         int m_numMatches = 10;
 
-        /// if true, uses back propagation to improve the parameter sets
-        /// otherwise, use a genetic algorithm
-        bool m_useBackpropagation = true;
+        /// opponent of the matches; MO_NONE only scores the moves on the training boards
+        MatchOpponent m_matchOpponent = MO_NONE;
+
+        /// if true, m_numMatches is only the maximum: a set stops playing once its match score
+        /// is confidently above or below the score needed to be among the best sets
+        bool m_adaptiveNumMatches = false;
+
+        /// if true, all sets scored in the same iteration face opponents making the same random choices,
+        /// so the differences between their match scores don't come from luck
+        bool m_commonRandomOpponents = false;
+
+        /// how the parameter sets are improved between iterations
+        TrainingMethod m_trainingMethod = TM_BACKPROPAGATION;
+
+        /// only used by the evolution strategies
+        EvolutionStrategiesData m_esData;
+
+        /// only used by CMA-ES
+        CmaEsData m_cmaData;
+
+        /// only used by the genetic algorithm
+        IslandModelData m_islandData;
+
+        /// only used by the genetic algorithm: replace one set after each evaluation instead of evolving the whole population per iteration
+        bool m_steadyStateEvolution = false;
+
+        /// only used by the (generational) genetic algorithm
+        SuccessiveHalvingData m_halvingData;
+
+        /// number of previous steps used by L-BFGS to approximate the curvature
+        int m_lbfgsHistorySize = 10;
+
+        /// error measure minimized by backpropagation
+        LossFunction m_lossFunction = LF_SQUARED_ERROR;
         double m_learningRate = 0.5;
 
         /// defines the type of activation function 
@@ -59,15 +141,44 @@ namespace Training
         /// anything else is treated as the identity activation function (no modification)
         std::string m_activationFunctionType;
 
+        /// if true, sigmoid and tanh are replaced by faster table-based approximations
+        /// only used for the genetic algorithm, backpropagation always uses the exact functions
+        bool m_approximateActivationFunctions = false;
+
         std::vector<int> m_numHiddenNodes; /// number of nodes within each hidden layer
 
+        /// how game states are converted into network input values
+        InputEncoding m_inputEncoding = IE_TWO_PLANES;
+
+        /// number of threads in the thread pool (including the main thread); 0 uses all hardware threads
+        int m_numThreads = 0;
+
+        /// if true, the threads are spread over the NUMA nodes and pinned there (see General::ThreadPool)
+        bool m_pinThreadsToNumaNodes = false;
+
+        /// network layers with at least this many nodes are computed in parallel (0 disables this)
+        int m_minParallelLayerWidth = 0;
+
+        /// number of scored parameter vectors remembered, so identical sets aren't evaluated again (0 disables the cache)
+        int m_fitnessCacheSize = 0;
+
+        /// number of board score sets remembered by the moves the network picks, so sets with an unchanged policy
+        /// don't need to be scored again (0 disables the cache)
+        int m_policyCacheSize = 0;
+
+        /// master seed for all random numbers; runs with the same non-zero seed are reproducible, 0 picks a random seed
+        uint64_t m_randomSeed = 0;
+
     protected:
         // internal members
         bool m_initialized = false;
+        double m_numEvaluatedSets = 0; /// partially evaluated sets count as a fraction
+        double m_evaluationSeconds = 0;
 
+        std::shared_ptr<General::ThreadPool> m_threadPool;
         std::shared_ptr<TrainingMethodHandler> m_trainingMethodHandler;
         std::shared_ptr<NeuralNetwork::ParameterManager> m_paramManager;
         std::shared_ptr<NeuralNetwork::NodeNetwork> m_nodeNetwork;
-        std::map<int, std::vector<int>> m_idsPerIteration;
+        NeuralNetwork::FitnessCache m_fitnessCache;
     };
 }
@@ -0,0 +1,158 @@
+#include "stdafx.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
+#include "IslandMigration.h"
+#include "3rdparty/json/json.hpp"
+#include "FileIO/FileManager.h"
+
+namespace Training
+{
+    using namespace FileIO;
+    using namespace NeuralNetwork;
+    using json = nlohmann::json;
+
+    const int MAX_REPLACE_ATTEMPTS = 10;
+    const int REPLACE_RETRY_MILLISECONDS = 10;
+
+    // moves the file in tempPath to path, replacing the file there in a single step
+    bool replaceFile(const std::string& tempPath, const std::string& path)
+    {
+#ifdef _WIN32
+        // rename doesn't replace existing files on Windows
+        return MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return std::rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+    }
+
+    IslandMigration::IslandMigration(int islandIndex, int numIslands)
+        : m_islandIndex(islandIndex)
+        , m_numIslands(numIslands)
+    {
+    }
+
+    std::string IslandMigration::getMailboxFileName(int islandIndex)
+    {
+        std::ostringstream fileName;
+        fileName << "island" << islandIndex << "_migrants.json";
+        return fileName.str();
+    }
+
+    void IslandMigration::clearMailbox() const
+    {
+        std::string relativePath;
+        if (FileManager::getRelativeDataFilePath(getMailboxFileName(m_islandIndex), relativePath, true))
+        {
+            // there's nothing to remove if this island has never sent any migrants
+            std::remove(relativePath.c_str());
+        }
+    }
+
+    bool IslandMigration::sendMigrants(int generation, const std::vector<ParamSet>& migrants) const
+    {
+        std::string relativePath;
+        if (!FileManager::getRelativeDataFilePath(getMailboxFileName(m_islandIndex), relativePath, true))
+        {
+            return false;
+        }
+
+        json j;
+        j["generation"] = generation;
+        j["sets"] = json::array();
+        for (const auto& migrant : migrants)
+        {
+            json jps;
+            jps["score"] = migrant.score;
+            jps["params"] = migrant.params;
+            j["sets"].push_back(jps);
+        }
+
+        // write to a temporary file first, so the reader never sees a half written mailbox
+        const std::string tempPath = relativePath + ".tmp";
+        {
+            std::ofstream ofs;
+            if (!FileManager::openOutFileStream(tempPath, ofs))
+            {
+                std::ostringstream buffer;
+                buffer << "Failed to open file '" << tempPath.c_str() << "' for writing";
+                PRINT_ERROR(buffer);
+                return false;
+            }
+
+            ofs << j << std::endl;
+        }
+
+        // the old mailbox stays in place until the new one replaces it, so the reader always finds a complete one;
+        // on Windows, the replacement fails while the next island has the old mailbox open, so it's retried a few times
+        // before giving up on this generation's migrants (the next migration replaces the mailbox again)
+        for (int attempt = 0; attempt < MAX_REPLACE_ATTEMPTS; attempt++)
+        {
+            if (replaceFile(tempPath, relativePath))
+            {
+                return true;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(REPLACE_RETRY_MILLISECONDS));
+        }
+
+        std::remove(tempPath.c_str());
+
+        std::ostringstream buffer;
+        buffer << "Failed to replace '" << relativePath.c_str() << "'";
+        PRINT_ERROR(buffer);
+        return false;
+    }
+
+    bool IslandMigration::receiveMigrants(std::vector<ParamSet>& migrants)
+    {
+        migrants.clear();
+
+        const int previousIsland = (m_islandIndex + m_numIslands - 1) % m_numIslands;
+
+        std::string relativePath;
+        if (!FileManager::getRelativeDataFilePath(getMailboxFileName(previousIsland), relativePath, true))
+        {
+            return false;
+        }
+
+        // a missing mailbox just means that the previous island hasn't sent anything yet
+        std::ifstream ifs(relativePath);
+        if (!ifs.is_open())
+        {
+            return false;
+        }
+
+        const json j = json::parse(ifs, nullptr, false);
+        if (j.is_discarded() || !j.is_object() || j.find("generation") == j.end() || j.find("sets") == j.end())
+        {
+            return false;
+        }
+
+        const int generation = j.at("generation").get<int>();
+        if (generation <= m_lastReceivedGeneration)
+        {
+            return false;
+        }
+
+        for (const auto& jps : j.at("sets"))
+        {
+            ParamSet pset;
+            pset.score = jps.at("score").get<double>();
+            pset.params = jps.at("params").get<std::vector<double>>();
+            migrants.push_back(pset);
+        }
+
+        m_lastReceivedGeneration = generation;
+        return !migrants.empty();
+    }
+}
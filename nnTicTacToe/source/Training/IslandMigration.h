@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "NeuralNetwork/ParameterStore.h"
+
+namespace Training
+{
+    /// mailbox files in the data directory through which the islands of an island model pass their best sets around a ring
+    /// Each island only replaces its own file and reads the one of the previous island,
+    /// so no process ever waits for another one; migrants that aren't there yet are simply picked up later.
+    /// Each island clears its mailbox when it starts. An island that reads before the previous island has started
+    /// may still import the migrants of an earlier run, so all islands should be started together.
+    class IslandMigration
+    {
+    public:
+        IslandMigration(int islandIndex, int numIslands);
+
+    public:
+        /// removes the migrants offered to the next island, e.g. the ones left over from an earlier run
+        void clearMailbox() const;
+
+        /// replaces the migrants offered to the next island
+        /// returns false if the mailbox couldn't be replaced, e.g. because the next island kept reading it for too long
+        bool sendMigrants(int generation, const std::vector<NeuralNetwork::ParamSet>& migrants) const;
+
+        /// the migrants of the previous island, if it has sent new ones since the last call
+        /// returns false if there are none (yet)
+        bool receiveMigrants(std::vector<NeuralNetwork::ParamSet>& migrants);
+
+        static std::string getMailboxFileName(int islandIndex);
+
+    private:
+        int m_islandIndex;
+        int m_numIslands;
+        int m_lastReceivedGeneration = -1;
+    };
+}
@@ -1,19 +1,41 @@
 #include "stdafx.h"
 
+#include <algorithm>
 #include <assert.h> 
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <numeric>
 
 #include "TicTacToeTrainer.h"
 
 #include "FileIO/FileManager.h"
 #include "Game/GameLogic.h"
+#include "Math/Random.h"
 
 namespace Training
 {
     using namespace FileIO;
     using namespace Game;
     using namespace NeuralNetwork;
+
+    const int MIN_ADAPTIVE_NUM_MATCHES = 10; // the confidence interval isn't reliable for fewer matches
+    const double MATCH_SCORE_CONFIDENCE_Z = 2.576; // 99% two-sided
     
+    // weighted quotas of the valid, won and tied games among totalCount games
+    double computeOutcomeRatioScore(int invalidCount, int wonCount, int tiedCount, int totalCount)
+    {
+        if (totalCount <= 0)
+        {
+            return 0.0;
+        }
+
+        const double quotaValid = 1 - (double)invalidCount / totalCount;
+        const double quotaWon = (double)wonCount / totalCount;
+        const double quotaTied = (double)tiedCount / totalCount;
+        return 100 * quotaValid + 10 * quotaWon + quotaTied;
+    }
+
     TicTacToeTrainer::TicTacToeTrainer(std::shared_ptr<GameLogic>& gameLogic)
         : BaseTrainer()
         , m_gameLogic(gameLogic)
@@ -27,19 +49,78 @@ namespace Training
     bool TicTacToeTrainer::setupTrainingData()
     {
         TicTacToeLogic::collectInconclusiveFinalGameBoardStates(m_gameStateCollection);
+
+        m_gameStateOrder.resize(m_gameStateCollection.size());
+        std::iota(m_gameStateOrder.begin(), m_gameStateOrder.end(), 0);
+
+        // the boards are collected in a systematic order, so the first few wouldn't be a representative sample for successive halving
+        if (m_halvingData.numRungs > 1)
+        {
+            std::shuffle(m_gameStateOrder.begin(), m_gameStateOrder.end(), Math::Random::getGenerator());
+        }
+
+        // the network size depends on the encoding, so this needs to be set before the network is created
+        m_gameLogic->setInputEncoding(m_inputEncoding);
         return true;
     }
 
     bool TicTacToeTrainer::setupTrainingMethod()
     {
-        if (m_useBackpropagation)
+        switch (m_trainingMethod)
         {
-            m_trainingMethodHandler = std::make_shared<BackpropagationHandler>(m_nodeNetwork, m_paramManager, m_gameLogic);
+        case TM_BACKPROPAGATION:
+        {
+            std::shared_ptr<BackpropagationHandler> backpropagationHandler = std::make_shared<BackpropagationHandler>(m_nodeNetwork, m_paramManager, m_gameLogic);
+            backpropagationHandler->setLossFunction(m_lossFunction);
+            m_trainingMethodHandler = backpropagationHandler;
+            break;
         }
-        else
+        case TM_LBFGS:
         {
-            m_trainingMethodHandler = std::make_shared<ParameterEvolutionHandler>(m_nodeNetwork, m_paramManager, m_gameLogic);
+            std::shared_ptr<LbfgsHandler> lbfgsHandler = std::make_shared<LbfgsHandler>(m_nodeNetwork, m_paramManager, m_gameLogic, m_lbfgsHistorySize);
+            lbfgsHandler->setLossFunction(m_lossFunction);
+            m_trainingMethodHandler = lbfgsHandler;
+            break;
         }
+        case TM_EVOLUTION_STRATEGIES:
+        {
+            std::shared_ptr<EvolutionStrategiesHandler> esHandler = std::make_shared<EvolutionStrategiesHandler>(m_nodeNetwork, m_paramManager, m_gameLogic, m_esData, m_paramData.numParamSets);
+            if (!esHandler->initialize())
+            {
+                return false;
+            }
+
+            m_trainingMethodHandler = esHandler;
+            break;
+        }
+        case TM_CMA_ES:
+        {
+            std::shared_ptr<CmaEsHandler> cmaHandler = std::make_shared<CmaEsHandler>(m_nodeNetwork, m_paramManager, m_gameLogic, m_cmaData, m_paramData.numParamSets);
+            cmaHandler->setThreadPool(m_threadPool);
+            if (!cmaHandler->initialize())
+            {
+                return false;
+            }
+
+            m_trainingMethodHandler = cmaHandler;
+            break;
+        }
+        default:
+            if (m_islandData.numIslands > 1)
+            {
+                m_trainingMethodHandler = std::make_shared<IslandModelHandler>(m_nodeNetwork, m_paramManager, m_gameLogic, m_islandData);
+            }
+            else if (m_steadyStateEvolution)
+            {
+                m_trainingMethodHandler = std::make_shared<SteadyStateEvolutionHandler>(m_nodeNetwork, m_paramManager, m_gameLogic);
+            }
+            else
+            {
+                m_trainingMethodHandler = std::make_shared<ParameterEvolutionHandler>(m_nodeNetwork, m_paramManager, m_gameLogic);
+            }
+            break;
+        }
+
         return true;
     }
 
@@ -54,40 +135,267 @@ namespace Training
 
     void TicTacToeTrainer::run()
     {
+        openTrainingStatsFiles();
+
         BaseTrainer::run();
 
-        dumpTrainingStats();
-        dumpBestSetImprovementStats();
+        if (m_policyCacheSize > 0)
+        {
+            std::ostringstream buffer;
+            buffer << "Policy cache: " << m_numPolicyCacheHits << " parameter sets picked the same moves as an already scored set";
+            PRINT_LOG(buffer);
+        }
+
+        m_trainingStatsStream.close();
+        m_bestSetStatsStream.close();
+    }
+
+    bool TicTacToeTrainer::handleTrainingIteration(int iteration)
+    {
+        // a new seed per iteration, so the sets aren't all tuned to the same few opponent games
+        if (m_commonRandomOpponents)
+        {
+            m_opponentSeed = Math::Random::getGenerator()();
+        }
+
+        return BaseTrainer::handleTrainingIteration(iteration);
     }
 
     void TicTacToeTrainer::handleNetworkComputation(int id, bool isLastIteration)
+    {
+        handlePartialNetworkComputation(id, 0, getNumEvaluationSteps(), isLastIteration);
+    }
+
+    int TicTacToeTrainer::getNumEvaluationSteps() const
+    {
+        return static_cast<int>(m_gameStateCollection.size());
+    }
+
+    void TicTacToeTrainer::handlePartialNetworkComputation(int id, int firstStep, int endStep, bool isLastIteration)
     {
         m_trainingMethodHandler->iterationStart(id);
 
-        // for each possible permutation on inconclusive last-turn states,
-        // try whether the ai makes a valid move
-        for (const auto& gameCells : m_gameStateCollection)
+        // only full passes are fingerprinted, the rungs of successive halving score parts of the boards
+        if (m_policyCacheSize > 0 && firstStep == 0 && endStep == getNumEvaluationSteps())
+        {
+            computePolicyScores(id);
+        }
+        else
         {
-            m_gameLogic->setGameCells(gameCells);
+            // for each possible permutation on inconclusive last-turn states,
+            // try whether the ai makes a valid move
+            for (int step = firstStep; step < endStep; step++)
+            {
+                const auto& gameCells = m_gameStateCollection[m_gameStateOrder[step]];
+                m_gameLogic->setGameCells(gameCells);
 
-            std::shared_ptr<BasePlayer> aiPlayer = std::make_shared<AiPlayer>(id, CellState::CS_PLAYER1, m_nodeNetwork);
-            std::vector<double> outputValues;
+                std::shared_ptr<BasePlayer> aiPlayer = std::make_shared<AiPlayer>(id, CellState::CS_PLAYER1, m_nodeNetwork, m_inputEncoding);
+                std::vector<double> outputValues;
 
-            const int nextMove = aiPlayer->decideMove(gameCells, outputValues);
+                const int nextMove = aiPlayer->decideMove(gameCells, outputValues);
+
+                GameState finalState = GameState::GS_GAMEOVER_TIMEOUT;
+                if (!m_gameLogic->isValidMove(0, nextMove))
+                {
+                    finalState = GameState::GS_INVALID;
+                }
+
+                const double score = computeMatchScore(*aiPlayer, 4, finalState);
+                m_trainingMethodHandler->handleTrainingIteration(aiPlayer);
+                addScore(*aiPlayer, score, finalState);
+
+            }
+        }
+
+        // with successive halving, only the sets that make it to the last rung play matches
+        if (m_matchOpponent != MO_NONE && endStep == getNumEvaluationSteps())
+        {
+            playMatches(id);
+        }
+
+        m_trainingMethodHandler->iterationEnd(isLastIteration);
+    }
+
+    void TicTacToeTrainer::computePolicyScores(int id)
+    {
+        // the board scores only depend on the picked moves, so the moves are computed first,
+        // and a set picking the same moves as an already scored one (e.g. after a small mutation) gets its scores
+        AiPlayer aiPlayer(id, CellState::CS_PLAYER1, m_nodeNetwork, m_inputEncoding);
+        const int numSteps = getNumEvaluationSteps();
+
+        std::vector<int> moves(numSteps);
+        for (int step = 0; step < numSteps; step++)
+        {
+            moves[step] = aiPlayer.decideMove(m_gameStateCollection[m_gameStateOrder[step]]);
+        }
+
+        const uint64_t fingerprint = FitnessCache::computeHash(moves);
+        const auto& found = m_policyScores.find(fingerprint);
+        if (found != m_policyScores.end())
+        {
+            m_scoreMap[id] = found->second;
+            m_numPolicyCacheHits++;
+            return;
+        }
+
+        // the moves are known already, no need to compute the network again
+        m_scoreMap.erase(id);
+        for (int step = 0; step < numSteps; step++)
+        {
+            m_gameLogic->setGameCells(m_gameStateCollection[m_gameStateOrder[step]]);
 
             GameState finalState = GameState::GS_GAMEOVER_TIMEOUT;
-            if (!m_gameLogic->isValidMove(0, nextMove))
+            if (!m_gameLogic->isValidMove(0, moves[step]))
             {
                 finalState = GameState::GS_INVALID;
             }
 
-            const double score = computeMatchScore(*aiPlayer, 4, finalState);
-            m_trainingMethodHandler->handleTrainingIteration(aiPlayer);
-            addScore(*aiPlayer, score, finalState);
+            addScore(aiPlayer, computeMatchScore(aiPlayer, 4, finalState), finalState);
+        }
 
+        const auto& scored = m_scoreMap.find(id);
+        if (scored != m_scoreMap.end())
+        {
+            cachePolicyScores(fingerprint, scored->second);
         }
+    }
 
-        m_trainingMethodHandler->iterationEnd(isLastIteration);
+    void TicTacToeTrainer::cachePolicyScores(uint64_t fingerprint, const ScoreSet& scoreSet)
+    {
+        if (!m_policyScores.emplace(fingerprint, scoreSet).second)
+        {
+            return;
+        }
+
+        m_policyInsertionOrder.push_back(fingerprint);
+        while (static_cast<int>(m_policyInsertionOrder.size()) > m_policyCacheSize)
+        {
+            m_policyScores.erase(m_policyInsertionOrder.front());
+            m_policyInsertionOrder.pop_front();
+        }
+    }
+
+    bool TicTacToeTrainer::isMatchScoreDecided(int numMatches, double matchScoreSum, double matchScoreSquareSum, double threshold)
+    {
+        if (numMatches < MIN_ADAPTIVE_NUM_MATCHES)
+        {
+            return false;
+        }
+
+        const double mean = matchScoreSum / numMatches;
+        const double variance = std::max(0.0, (matchScoreSquareSum - matchScoreSum * mean) / (numMatches - 1));
+        const double halfWidth = MATCH_SCORE_CONFIDENCE_Z * std::sqrt(variance / numMatches);
+
+        return mean - halfWidth > threshold || mean + halfWidth < threshold;
+    }
+
+    void TicTacToeTrainer::playMatches(int id)
+    {
+        double threshold = 0;
+        const bool hasThreshold = m_adaptiveNumMatches && getMatchScoreThreshold(threshold);
+
+        std::shared_ptr<RandomPlayer> firstOpponent = createMatchOpponent(CellState::CS_PLAYER1);
+        std::shared_ptr<RandomPlayer> secondOpponent = createMatchOpponent(CellState::CS_PLAYER2);
+        AiPlayer firstAiPlayer(id, CellState::CS_PLAYER1, m_nodeNetwork, m_inputEncoding);
+        AiPlayer secondAiPlayer(id, CellState::CS_PLAYER2, m_nodeNetwork, m_inputEncoding);
+
+        ScoreSet& scoreSet = m_scoreMap[id];
+        for (int m = 0; m < m_numMatches; m++)
+        {
+            // try both as first and second player
+            for (int side = 0; side < 2; side++)
+            {
+                const size_t numScores = scoreSet.scores.size();
+                const int invalidCount = scoreSet.invalidCount;
+                const int wonCount = scoreSet.wonCount;
+                const int lostCount = scoreSet.lostCount;
+                const int tiedCount = scoreSet.tiedCount;
+                RandomPlayer& opponent = (side == 0) ? *secondOpponent : *firstOpponent;
+                if (m_commonRandomOpponents)
+                {
+                    opponent.setSeed(getMatchOpponentSeed(m_opponentSeed, m, side));
+                }
+
+                if (side == 0)
+                {
+                    playMatch(firstAiPlayer, opponent);
+                }
+                else
+                {
+                    playMatch(opponent, secondAiPlayer);
+                }
+
+                if (scoreSet.scores.size() > numScores)
+                {
+                    const double matchScore = scoreSet.scores.back();
+                    scoreSet.numMatches++;
+                    scoreSet.matchScoreSum += matchScore;
+                    scoreSet.matchScoreSquareSum += matchScore * matchScore;
+                    scoreSet.matchInvalidCount += scoreSet.invalidCount - invalidCount;
+                    scoreSet.matchWonCount += scoreSet.wonCount - wonCount;
+                    scoreSet.matchLostCount += scoreSet.lostCount - lostCount;
+                    scoreSet.matchTiedCount += scoreSet.tiedCount - tiedCount;
+                }
+            }
+
+            if (hasThreshold && isMatchScoreDecided(scoreSet.numMatches, scoreSet.matchScoreSum, scoreSet.matchScoreSquareSum, threshold))
+            {
+                break;
+            }
+        }
+    }
+
+    uint64_t TicTacToeTrainer::getMatchOpponentSeed(uint64_t opponentSeed, int match, int side)
+    {
+        // the generator expands neighbouring seeds into unrelated states,
+        // mixing the opponent seed first keeps the matches of neighbouring opponent seeds apart
+        const uint64_t firstMatchSeed = Math::RandomGenerator(opponentSeed)();
+        Math::RandomGenerator generator(firstMatchSeed + 2 * static_cast<uint64_t>(match) + side);
+        return generator();
+    }
+
+    std::shared_ptr<RandomPlayer> TicTacToeTrainer::createMatchOpponent(CellState player) const
+    {
+        // scores are only added for parameter sets, so the opponents don't need a valid id
+        std::shared_ptr<RandomPlayer> opponent;
+        if (m_matchOpponent == MO_SEMI_RANDOM)
+        {
+            opponent = std::make_shared<SemiRandomPlayer>(-1, player);
+        }
+        else
+        {
+            opponent = std::make_shared<RandomPlayer>(-1, player);
+        }
+
+        // with common random opponents, playMatches reseeds the opponent for every match
+        return opponent;
+    }
+
+    bool TicTacToeTrainer::getMatchScoreThreshold(double& threshold) const
+    {
+        const int numKeptSets = std::max(1, m_paramData.numBestSetsKeptDuringEvolution);
+
+        std::vector<int> activeIds;
+        m_paramManager->getActiveParameterSetIds(activeIds);
+
+        std::vector<double> meanMatchScores;
+        for (auto activeId : activeIds)
+        {
+            const auto& found = m_scoreMap.find(activeId);
+            if (m_paramManager->isEvaluated(activeId) && found != m_scoreMap.end() && found->second.numMatches > 0)
+            {
+                meanMatchScores.push_back(found->second.matchScoreSum / found->second.numMatches);
+            }
+        }
+
+        if (static_cast<int>(meanMatchScores.size()) < numKeptSets)
+        {
+            return false;
+        }
+
+        std::nth_element(meanMatchScores.begin(), meanMatchScores.begin() + (numKeptSets - 1), meanMatchScores.end(), std::greater<double>());
+        threshold = meanMatchScores[numKeptSets - 1];
+        return true;
     }
 
     void TicTacToeTrainer::playMatch(BasePlayer& playerA, BasePlayer& playerB)
@@ -238,6 +546,12 @@ namespace Training
 
     void TicTacToeTrainer::addScore(const BasePlayer& player, double score, GameState playerGameState)
     {
+        if (!m_paramManager->hasParameterSet(player.getId()))
+        {
+            // e.g. the opponent in a match
+            return;
+        }
+
         auto& found = m_scoreMap.find(player.getId());
         if (found == m_scoreMap.end())
         {
@@ -270,6 +584,16 @@ namespace Training
         }
     }
 
+    void TicTacToeTrainer::handleCachedScore(int id, int cachedId)
+    {
+        // the details are only known while the cached set is still around
+        const auto& found = m_scoreMap.find(cachedId);
+        if (found != m_scoreMap.end())
+        {
+            m_scoreMap[id] = found->second;
+        }
+    }
+
     void TicTacToeTrainer::describeScoreForId(int id) const
     {
         auto& found = m_scoreMap.find(id);
@@ -296,6 +620,11 @@ namespace Training
             buffer << "#tied: " << found->second.tiedCount << std::endl;
         }
 
+        if (found->second.numMatches)
+        {
+            buffer << "#matches: " << found->second.numMatches << " (avg. match score: " << found->second.matchScoreSum / found->second.numMatches << ")" << std::endl;
+        }
+
         buffer << "Scores: ";
         for (auto score : found->second.scores)
         {
@@ -305,13 +634,12 @@ namespace Training
         buffer << std::endl << "outcome score: " << getOutcomeRatioScoreForId(id);
         buffer << std::endl << "avg. score: " << getAverageScoreForId(id);
 
-        ParamSet pset;
-        m_paramManager->getParamSetForId(id, pset);
-        buffer << std::endl << "final score: " << pset.score;
+        buffer << std::endl << "final score: " << m_paramManager->getScore(id);
 
-        if (pset.error >= 0)
+        const double error = m_paramManager->getError(id);
+        if (error >= 0)
         {
-            buffer << std::endl << "avg. error: " << pset.error;
+            buffer << std::endl << "avg. error: " << error;
         }
 
         PRINT_LOG(buffer);
@@ -331,18 +659,25 @@ namespace Training
 
     double TicTacToeTrainer::getAverageScoreForId(int id) const
     {
-        double score = 0.0;
-
         const auto& found = m_scoreMap.find(id);
-        if (found != m_scoreMap.end())
+        if (found == m_scoreMap.end())
         {
-            assert(!found->second.scores.empty());
-            for (const auto& val : found->second.scores)
-            {
-                score += val;
-            }
+            return 0.0;
+        }
+
+        assert(!found->second.scores.empty());
+        return getAverageScore(found->second);
+    }
 
-            score /= found->second.scores.size();
+    double TicTacToeTrainer::getAverageScore(const ScoreSet& scoreSet)
+    {
+        const int numBoardScores = static_cast<int>(scoreSet.scores.size()) - scoreSet.numMatches;
+        const double boardScoreSum = std::accumulate(scoreSet.scores.begin(), scoreSet.scores.end(), 0.0) - scoreSet.matchScoreSum;
+
+        double score = (numBoardScores > 0) ? boardScoreSum / numBoardScores : 0.0;
+        if (scoreSet.numMatches > 0)
+        {
+            score += scoreSet.matchScoreSum / scoreSet.numMatches;
         }
 
         return score;
@@ -350,19 +685,28 @@ namespace Training
 
     double TicTacToeTrainer::getOutcomeRatioScoreForId(int id) const
     {
-        double score = 0.0;
-
         const auto& found = m_scoreMap.find(id);
-        if (found != m_scoreMap.end())
+        if (found == m_scoreMap.end())
         {
-            const int totalCount = found->second.invalidCount + found->second.lostCount + found->second.tiedCount + found->second.wonCount;
-            assert(totalCount > 0);
-            assert(found->second.scores.size() == totalCount);
+            return 0.0;
+        }
+
+        const int totalCount = found->second.invalidCount + found->second.lostCount + found->second.tiedCount + found->second.wonCount;
+        assert(totalCount > 0);
+        assert(found->second.scores.size() == totalCount);
 
-            const double quotaValid = 1 - (double)found->second.invalidCount / totalCount;
-            const double quotaWon = (double)found->second.wonCount / totalCount;
-            const double quotaTied = (double)found->second.tiedCount / totalCount;
-            score = 100 * quotaValid + 10 * quotaWon + quotaTied;
+        return getOutcomeRatioScore(found->second);
+    }
+
+    double TicTacToeTrainer::getOutcomeRatioScore(const ScoreSet& scoreSet)
+    {
+        const int numBoardGames = static_cast<int>(scoreSet.scores.size()) - scoreSet.numMatches;
+        double score = computeOutcomeRatioScore(scoreSet.invalidCount - scoreSet.matchInvalidCount, scoreSet.wonCount - scoreSet.matchWonCount,
+            scoreSet.tiedCount - scoreSet.matchTiedCount, numBoardGames);
+
+        if (scoreSet.numMatches > 0)
+        {
+            score += computeOutcomeRatioScore(scoreSet.matchInvalidCount, scoreSet.matchWonCount, scoreSet.matchTiedCount, scoreSet.numMatches);
         }
 
         return score;
@@ -380,93 +724,98 @@ namespace Training
         return true;
     }
 
-    void TicTacToeTrainer::dumpTrainingStats() const
+    void TicTacToeTrainer::handleIterationSummary(int iteration, const std::vector<int>& idsSortedByScore)
     {
-        const std::string allSetsFileName = "iteration_scores.csv";
-        const std::string bestSetsFileName = "best_iteration_stats.csv";
-
-        std::string relativePath;
-        if (!FileManager::getRelativeDataFilePath(allSetsFileName, relativePath))
-        {
-            return;
-        }
+        writeTrainingStats(iteration, idsSortedByScore);
+        writeBestSetImprovementStats(iteration, idsSortedByScore);
+    }
 
-        std::ofstream ofs;
-        if (!FileManager::openOutFileStream(relativePath, ofs))
+    void TicTacToeTrainer::releaseRemovedParamSets()
+    {
+        for (auto it = m_scoreMap.begin(); it != m_scoreMap.end();)
         {
-
-            std::ostringstream buffer;
-            buffer << "Failed to open file '" << relativePath.c_str() << "' for writing";
-            PRINT_ERROR(buffer);
-            return;
+            if (m_paramManager->hasParameterSet(it->first))
+            {
+                ++it;
+            }
+            else
+            {
+                it = m_scoreMap.erase(it);
+            }
         }
+    }
 
-        ofs << "Iteration, Score, Error" << std::endl;
+    void TicTacToeTrainer::openTrainingStatsFiles()
+    {
+        const std::string allSetsFileName = "iteration_scores.csv";
+        const std::string bestSetsFileName = "best_iteration_stats.csv";
 
-        for (const auto& iter : m_idsPerIteration)
+        const auto openFile = [](const std::string& fileName, std::ofstream& ofs)
         {
-            for (const auto& id : iter.second)
+            std::string relativePath;
+            if (!FileManager::getRelativeDataFilePath(fileName, relativePath))
             {
-                ScoreSet score;
-                if (getScoreSetForId(id, score))
-                {
-                    ParamSet pset;
-                    m_paramManager->getParamSetForId(id, pset);
+                return;
+            }
 
-                    ofs << (iter.first+1) << ", " << score.finalScore << ", " << pset.error << std::endl;
-                }
+            std::ostringstream buffer;
+            if (!FileManager::openOutFileStream(relativePath, ofs))
+            {
+                buffer << "Failed to open file '" << relativePath.c_str() << "' for writing";
+                PRINT_ERROR(buffer);
+                return;
             }
-        }
 
-        std::ostringstream buffer;
-        buffer << "dumped training stats to '" << relativePath.c_str() << "'";
-        PRINT_LOG(buffer);
-    }
+            buffer << "writing training stats to '" << relativePath.c_str() << "'";
+            PRINT_LOG(buffer);
+        };
 
-    void TicTacToeTrainer::dumpBestSetImprovementStats() const
-    {
-        const std::string bestSetsFileName = "best_iteration_stats.csv";
+        openFile(allSetsFileName, m_trainingStatsStream);
+        openFile(bestSetsFileName, m_bestSetStatsStream);
 
-        std::string relativePath;
-        if (!FileManager::getRelativeDataFilePath(bestSetsFileName, relativePath))
+        if (m_trainingStatsStream.is_open())
         {
-            return;
+            m_trainingStatsStream << "Iteration, Score, Error" << std::endl;
         }
 
-        std::ofstream ofs;
-        if (!FileManager::openOutFileStream(relativePath, ofs))
+        if (m_bestSetStatsStream.is_open())
         {
-            std::ostringstream buffer;
-            buffer << "Failed to open file '" << relativePath.c_str() << "' for writing";
-            PRINT_ERROR(buffer);
-            return;
+            m_bestSetStatsStream << "Iteration, Id, Error, Score, OutcomeScore, AvgScore, CountInvalid, CountLost, CountTied, CountWon" << std::endl;
         }
+    }
 
-        ofs << "Iteration, Id, Error, Score, OutcomeScore, AvgScore, CountInvalid, CountLost, CountTied, CountWon" << std::endl;
-
-        for (const auto& iter : m_idsPerIteration)
+    void TicTacToeTrainer::writeTrainingStats(int iteration, const std::vector<int>& idsSortedByScore)
+    {
+        if (!m_trainingStatsStream.is_open())
         {
-            if (iter.second.empty())
-            {
-                continue;
-            }
+            return;
+        }
 
+        for (const auto& id : idsSortedByScore)
+        {
             ScoreSet score;
-            const int bestId = iter.second[0];
-            if (getScoreSetForId(bestId, score))
+            if (getScoreSetForId(id, score))
             {
-                ParamSet pset;
-                m_paramManager->getParamSetForId(bestId, pset);
-
-                ofs << (iter.first+1) << ", " << bestId 
-                    << ", " << pset.error << ", " << score.finalScore 
-                    << ", " << getOutcomeRatioScoreForId(bestId) << ", " << getAverageScoreForId(bestId)
-                    << ", " << score.invalidCount << ", " << score.lostCount << ", " << score.tiedCount << ", " << score.wonCount << std::endl;
+                m_trainingStatsStream << (iteration+1) << ", " << score.finalScore << ", " << m_paramManager->getError(id) << std::endl;
             }
         }
+    }
 
-        std::ostringstream buffer;
-        buffer << "dumped improvement stats to '" << relativePath.c_str() << "'";
-        PRINT_LOG(buffer);
+    void TicTacToeTrainer::writeBestSetImprovementStats(int iteration, const std::vector<int>& idsSortedByScore)
+    {
+        if (!m_bestSetStatsStream.is_open() || idsSortedByScore.empty())
+        {
+            return;
+        }
+
+        ScoreSet score;
+        const int bestId = idsSortedByScore[0];
+        if (getScoreSetForId(bestId, score))
+        {
+            m_bestSetStatsStream << (iteration+1) << ", " << bestId 
+                << ", " << m_paramManager->getError(bestId) << ", " << score.finalScore 
+                << ", " << getOutcomeRatioScoreForId(bestId) << ", " << getAverageScoreForId(bestId)
+                << ", " << score.invalidCount << ", " << score.lostCount << ", " << score.tiedCount << ", " << score.wonCount << std::endl;
+        }
     }
 }
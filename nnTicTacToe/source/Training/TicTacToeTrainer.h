@@ -1,6 +1,9 @@
 #pragma once
 
+#include <deque>
+#include <fstream>
 #include <memory>
+#include <unordered_map>
 
 #include "Game/GameLogic.h"
 #include "Game/Player.h"
@@ -19,6 +22,15 @@ namespace Training
 
         std::vector<double> scores;
         double finalScore = 0;
+
+        // matches against the opponent (their scores and outcomes are also part of scores and the counts above)
+        int numMatches = 0;
+        double matchScoreSum = 0;
+        double matchScoreSquareSum = 0;
+        int matchInvalidCount = 0;
+        int matchWonCount = 0;
+        int matchLostCount = 0;
+        int matchTiedCount = 0;
     };
 
     class TicTacToeTrainer
@@ -33,7 +45,25 @@ namespace Training
         bool setupTrainingMethod() override;
         NetworkSizeData getNetworkSizeData() const override;
         void run() override;
+        bool handleTrainingIteration(int iteration) override;
         void handleNetworkComputation(int id, bool isLastIteration) override;
+        int getNumEvaluationSteps() const override;
+        void handlePartialNetworkComputation(int id, int firstStep, int endStep, bool isLastIteration) override;
+
+        /// true once the mean match score is confidently (99%) above or below the threshold
+        static bool isMatchScoreDecided(int numMatches, double matchScoreSum, double matchScoreSquareSum, double threshold);
+
+        /// the boards and the matches are weighted the same for any number of matches,
+        /// so stopping the matches early doesn't change the weight of their results
+        static double getAverageScore(const ScoreSet& scoreSet);
+        static double getOutcomeRatioScore(const ScoreSet& scoreSet);
+
+        /// seed of the common random opponent in one match, the side is 0 if the opponent plays second
+        /// every match gets its own stream, so the opponent's moves don't depend on how long the earlier matches took
+        static uint64_t getMatchOpponentSeed(uint64_t opponentSeed, int match, int side);
+
+        /// number of sets that got their board scores from the policy cache so far
+        int getNumPolicyCacheHits() const { return m_numPolicyCacheHits; }
 
     protected:
         std::string getName() const override { return "TicTacToeTrainer"; }
@@ -42,20 +72,46 @@ namespace Training
         // scoring
         void describeScoreForId(int id) const override;
         double computeFinalScore(int id) override;
+        void handleIterationSummary(int iteration, const std::vector<int>& idsSortedByScore) override;
+        void releaseRemovedParamSets() override;
+        void handleCachedScore(int id, int cachedId) override;
 
+        /// scores all boards, but first looks up the moves the network picks in the policy cache
+        void computePolicyScores(int id);
+        void cachePolicyScores(uint64_t fingerprint, const ScoreSet& scoreSet);
+
+        /// plays up to m_numMatches matches as first and as second player against m_matchOpponent
+        void playMatches(int id);
         void playMatch(Game::BasePlayer& playerA, Game::BasePlayer& playerB);
+        std::shared_ptr<Game::RandomPlayer> createMatchOpponent(CellState player) const;
+
+        /// the mean match score a set needs to be among the sets kept during evolution
+        /// returns false if too few sets have played matches yet
+        bool getMatchScoreThreshold(double& threshold) const;
         GameState playOneTurn(Game::BasePlayer& player, bool firstPlayer);
         double computeMatchScore(Game::BasePlayer& player, int numTurns, GameState finalGameState);
         void addScore(const Game::BasePlayer& player, double score, GameState playerGameState);
         double getAverageScoreForId(int id) const;
         double getOutcomeRatioScoreForId(int id) const;
         bool getScoreSetForId(int id, ScoreSet& scoreSet) const;
-        void dumpTrainingStats() const;
-        void dumpBestSetImprovementStats() const;
+
+        // the stats are written while training, so no history of all iterations needs to be kept
+        void openTrainingStatsFiles();
+        void writeTrainingStats(int iteration, const std::vector<int>& idsSortedByScore);
+        void writeBestSetImprovementStats(int iteration, const std::vector<int>& idsSortedByScore);
 
     private:
         std::shared_ptr<Game::GameLogic> m_gameLogic;
         std::map<int, ScoreSet> m_scoreMap;
         std::vector<std::vector<CellState>> m_gameStateCollection;
+        std::vector<int> m_gameStateOrder; /// evaluation step k uses m_gameStateCollection[m_gameStateOrder[k]]
+        std::ofstream m_trainingStatsStream;
+        std::ofstream m_bestSetStatsStream;
+        uint64_t m_opponentSeed = 0; /// only used with common random opponents, changes each iteration
+
+        // board scores (without matches) by the hash of the moves picked on all boards, oldest first in m_policyInsertionOrder
+        std::unordered_map<uint64_t, ScoreSet> m_policyScores;
+        std::deque<uint64_t> m_policyInsertionOrder;
+        int m_numPolicyCacheHits = 0;
     };
 }
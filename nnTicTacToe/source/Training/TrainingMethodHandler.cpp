@@ -1,9 +1,13 @@
 #include "stdafx.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <iostream>
+#include <numeric>
 
 #include "FileIO/FileManager.h"
+#include "Math/LossFunctions.h"
+#include "Math/Random.h"
 #include "TrainingMethodHandler.h"
 
 
@@ -11,6 +15,7 @@ namespace Training
 {
     using namespace FileIO;
     using namespace Game;
+    using namespace Math;
     using namespace NeuralNetwork;
 
     TrainingMethodHandler::TrainingMethodHandler(std::shared_ptr<NodeNetwork>& network, std::shared_ptr<ParameterManager>& paramManager, std::shared_ptr<GameLogic>& gameLogic)
@@ -20,6 +25,49 @@ namespace Training
     {
     }
 
+    bool TrainingMethodHandler::parseTrainingMethod(const std::string& name, TrainingMethod& trainingMethod)
+    {
+        if (name == "backpropagation")
+        {
+            trainingMethod = TM_BACKPROPAGATION;
+        }
+        else if (name == "genetic_algorithm")
+        {
+            trainingMethod = TM_GENETIC_ALGORITHM;
+        }
+        else if (name == "evolution_strategies")
+        {
+            trainingMethod = TM_EVOLUTION_STRATEGIES;
+        }
+        else if (name == "cma_es")
+        {
+            trainingMethod = TM_CMA_ES;
+        }
+        else if (name == "lbfgs")
+        {
+            trainingMethod = TM_LBFGS;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string TrainingMethodHandler::getTrainingMethodDescription(TrainingMethod trainingMethod)
+    {
+        switch (trainingMethod)
+        {
+        case TM_BACKPROPAGATION:      return "backpropagation";
+        case TM_GENETIC_ALGORITHM:    return "genetic algorithm";
+        case TM_EVOLUTION_STRATEGIES: return "evolution strategies";
+        case TM_CMA_ES:               return "CMA-ES";
+        case TM_LBFGS:                return "L-BFGS";
+        default:                      return "";
+        }
+    }
+
     void TrainingMethodHandler::describeTrainingMethod() const
     {
         std::ostringstream buffer;
@@ -27,11 +75,21 @@ namespace Training
         PRINT_LOG(buffer);
     }
 
+    bool TrainingMethodHandler::getParameters(int id, std::vector<double>& params) const
+    {
+        return m_paramManager->copyParameters(id, params);
+    }
+
     void TrainingMethodHandler::iterationStart(int paramSetId)
     {
         m_currentParamSetId = paramSetId;
     }
 
+    void TrainingMethodHandler::candidateEvaluated(int paramSetId, bool lastIteration)
+    {
+        // nothing to do
+    }
+
     //---------------------------------------
     // ParameterEvolutionHandler
     //---------------------------------------
@@ -66,9 +124,12 @@ namespace Training
         std::vector<int> currentParameterSetIds;
         m_paramManager->getActiveParameterSetIds(currentParameterSetIds);
 
+        // sorted for binary searches, a linear search per set would be quadratic in the population size
+        std::sort(newParameterSetIds.begin(), newParameterSetIds.end());
+
         for (auto id : currentParameterSetIds)
         {
-            if (std::find(newParameterSetIds.begin(), newParameterSetIds.end(), id) == newParameterSetIds.end())
+            if (!std::binary_search(newParameterSetIds.begin(), newParameterSetIds.end(), id))
             {
                 buffer.clear();
                 buffer.str("");
@@ -80,6 +141,144 @@ namespace Training
         }
     }
 
+    //---------------------------------------
+    // IslandModelHandler
+    //---------------------------------------
+    IslandModelHandler::IslandModelHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+        const IslandModelData& islandData)
+        : ParameterEvolutionHandler(network, paramManager, gameLogic)
+        , m_islandData(islandData)
+        , m_migration(islandData.islandIndex, islandData.numIslands)
+    {
+        // the next island mustn't import the migrants of an earlier run
+        m_migration.clearMailbox();
+    }
+
+    void IslandModelHandler::describeTrainingMethod() const
+    {
+        std::ostringstream buffer;
+        buffer << "Training method: " << getName();
+        buffer << std::endl << "  island " << m_islandData.islandIndex << " of " << m_islandData.numIslands;
+        buffer << std::endl << "  sending the best " << m_islandData.numMigrants << " sets every " << m_islandData.migrationInterval << " generations";
+        buffer << std::endl;
+        PRINT_LOG(buffer);
+    }
+
+    void IslandModelHandler::postIteration(bool lastIteration)
+    {
+        // the scores of the current generation are only known before evolving it
+        m_generation++;
+        if (m_generation % m_islandData.migrationInterval == 0)
+        {
+            sendMigrants();
+        }
+
+        ParameterEvolutionHandler::postIteration(lastIteration);
+
+        receiveMigrants();
+    }
+
+    void IslandModelHandler::sendMigrants()
+    {
+        std::vector<int> bestIds;
+        m_paramManager->getBestParameterSetIds(m_islandData.numMigrants, bestIds);
+
+        std::vector<ParamSet> migrants(bestIds.size());
+        for (size_t k = 0; k < bestIds.size(); k++)
+        {
+            migrants[k].score = m_paramManager->getScore(bestIds[k]);
+            m_paramManager->copyParameters(bestIds[k], migrants[k].params);
+        }
+
+        if (m_migration.sendMigrants(m_generation, migrants))
+        {
+            std::ostringstream buffer;
+            buffer << "Sent " << migrants.size() << " migrants to the next island";
+            PRINT_LOG(buffer);
+        }
+    }
+
+    void IslandModelHandler::receiveMigrants()
+    {
+        std::vector<ParamSet> migrants;
+        if (!m_migration.receiveMigrants(migrants))
+        {
+            return;
+        }
+
+        // the newest sets are the crossover children, which haven't been evaluated yet
+        std::vector<int> activeIds;
+        m_paramManager->getActiveParameterSetIds(activeIds);
+
+        const int numParameters = m_nodeNetwork->getNumParameters();
+
+        int numAccepted = 0;
+        for (auto& migrant : migrants)
+        {
+            if (activeIds.empty())
+            {
+                break;
+            }
+
+            if (static_cast<int>(migrant.params.size()) != numParameters)
+            {
+                // sent by an island with a different network
+                continue;
+            }
+
+            const int replacedId = activeIds.back();
+            if (m_paramManager->isEvaluated(replacedId))
+            {
+                // only evaluated sets are left
+                break;
+            }
+
+            activeIds.pop_back();
+            m_paramManager->setParameterSetActive(replacedId, false);
+
+            // evaluated again on this island, like every new set
+            migrant.score = 0;
+            const int newId = m_paramManager->addNewParamSet(migrant);
+            numAccepted++;
+
+            std::ostringstream buffer;
+            buffer << "Migrant from the previous island added as parameter set " << newId << ", replacing " << replacedId;
+            PRINT_LOG(buffer);
+        }
+
+        std::ostringstream buffer;
+        buffer << "Accepted " << numAccepted << " of " << migrants.size() << " migrants";
+        PRINT_LOG(buffer);
+    }
+
+    //---------------------------------------
+    // SteadyStateEvolutionHandler
+    //---------------------------------------
+    SteadyStateEvolutionHandler::SteadyStateEvolutionHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic)
+        : ParameterEvolutionHandler(network, paramManager, gameLogic)
+    {
+    }
+
+    void SteadyStateEvolutionHandler::candidateEvaluated(int paramSetId, bool lastIteration)
+    {
+        // does nothing while the initial population is still being evaluated
+        m_paramManager->retireWorstParameterSet(paramSetId);
+
+        // children created now would never be evaluated
+        if (lastIteration)
+        {
+            return;
+        }
+
+        m_paramManager->addOffspringParameterSet();
+    }
+
+    void SteadyStateEvolutionHandler::postIteration(bool lastIteration)
+    {
+        // the population has already been evolved set by set, only the mutation rates are adapted per iteration
+        m_paramManager->updateEffectiveMutationRates(m_paramManager->getBestParameterSetId());
+    }
+
     //---------------------------------------
     // BackpropagationHandler
     //---------------------------------------
@@ -92,6 +291,7 @@ namespace Training
     {
         std::ostringstream buffer;
         buffer << "Training method: " << getName();
+        buffer << std::endl << "  Loss function: " << LossFunctions::getLossFunctionDescription(m_lossFunction);
         buffer << std::endl << "  Initial learning rate: " << m_learningRate;
         buffer << std::endl << "  Min. learning rate: " << m_minLearningRate;
         buffer << std::endl << "  Max. learning rate: " << m_maxLearningRate;
@@ -119,13 +319,25 @@ namespace Training
         m_nodeNetwork->getOutputValues(outputValues, false);
         m_gameLogic->correctOutputValues(player->getPlayerId() == CS_PLAYER1 ? 0 : 1, outputValues);
 
-        // then compute the error
-        const double error = m_nodeNetwork->getTotalError(outputValues);
-        m_errors.push_back(error);
-
-        // and propagate back based on these values
+        double error = 0;
         std::vector<double> tempAdjustmentValues;
-        m_nodeNetwork->handleBackpropagation(outputValues, tempAdjustmentValues);
+        if (m_lossFunction == LF_SOFTMAX_CROSS_ENTROPY)
+        {
+            // loss and adjustment values are computed together
+            std::vector<double> targetDistribution;
+            getTargetDistribution(outputValues, targetDistribution);
+            error = m_nodeNetwork->handleSoftMaxCrossEntropyBackpropagation(targetDistribution, tempAdjustmentValues);
+        }
+        else
+        {
+            // compute the error
+            error = m_nodeNetwork->getTotalError(outputValues);
+
+            // and propagate back based on these values
+            m_nodeNetwork->handleBackpropagation(outputValues, tempAdjustmentValues);
+        }
+
+        m_errors.push_back(error);
         assert(tempAdjustmentValues.size() == m_parameterAdjustmentValues.size());
 
         for (unsigned int k = 0; k < tempAdjustmentValues.size(); k++)
@@ -136,6 +348,31 @@ namespace Training
         return error;
     }
 
+    void BackpropagationHandler::getTargetDistribution(const std::vector<double>& correctedValues, std::vector<double>& targetDistribution)
+    {
+        targetDistribution.clear();
+
+        // negative values can't be probabilities
+        double sum = 0;
+        for (auto val : correctedValues)
+        {
+            targetDistribution.push_back(std::max(0.0, val));
+            sum += targetDistribution.back();
+        }
+
+        if (sum <= 0)
+        {
+            // no preferred move, so all of them are equally fine
+            std::fill(targetDistribution.begin(), targetDistribution.end(), 1.0 / targetDistribution.size());
+            return;
+        }
+
+        for (auto& val : targetDistribution)
+        {
+            val /= sum;
+        }
+    }
+
     void BackpropagationHandler::iterationEnd(bool lastIteration)
     {
         // calculate average error
@@ -218,4 +455,434 @@ namespace Training
     void BackpropagationHandler::postIteration(bool lastIteration)
     {
     }
+
+    //---------------------------------------
+    // LbfgsHandler
+    //---------------------------------------
+    LbfgsHandler::LbfgsHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+                               int historySize)
+        : TrainingMethodHandler(network, paramManager, gameLogic)
+        , m_historySize(std::max(1, historySize))
+    {
+        // the line search relies on the gradient matching the loss
+        m_nodeNetwork->setUseExactGradient(true);
+    }
+
+    void LbfgsHandler::describeTrainingMethod() const
+    {
+        std::ostringstream buffer;
+        buffer << "Training method: " << getName();
+        buffer << std::endl << "  Loss function: " << LossFunctions::getLossFunctionDescription(m_lossFunction);
+        buffer << std::endl << "  History size: " << m_historySize;
+        buffer << std::endl;
+        PRINT_LOG(buffer);
+    }
+
+    void LbfgsHandler::iterationStart(int paramSetId)
+    {
+        TrainingMethodHandler::iterationStart(paramSetId);
+
+        m_inputValues.clear();
+        m_gameCells.clear();
+        m_playerIndices.clear();
+    }
+
+    double LbfgsHandler::handleTrainingIteration(std::shared_ptr<Game::BasePlayer>& player)
+    {
+        // only remember the board, the loss is computed for all of them at once in iterationEnd
+        std::vector<double> inputValues;
+        m_nodeNetwork->getInputValues(inputValues);
+        m_inputValues.push_back(inputValues);
+
+        std::vector<CellState> gameCells;
+        m_gameLogic->getGameCells(gameCells);
+        m_gameCells.push_back(gameCells);
+
+        m_playerIndices.push_back(player->getPlayerId() == CS_PLAYER1 ? 0 : 1);
+        return 0;
+    }
+
+    double LbfgsHandler::computeLoss(const std::vector<double>& params, std::vector<double>& gradient)
+    {
+        assert(!m_inputValues.empty());
+
+        m_nodeNetwork->assignParameters(params);
+
+        std::vector<std::vector<double>> outputValues;
+        m_nodeNetwork->computeValues(m_inputValues, outputValues);
+
+        // same targets as the backpropagation handler: the output values as corrected by the game logic
+        const int numSamples = static_cast<int>(m_inputValues.size());
+        std::vector<std::vector<double>> targetValues(numSamples);
+        double loss = 0;
+        for (int s = 0; s < numSamples; s++)
+        {
+            m_gameLogic->setGameCells(m_gameCells[s]);
+            targetValues[s] = outputValues[s];
+            m_gameLogic->correctOutputValues(m_playerIndices[s], targetValues[s]);
+
+            if (m_lossFunction == LF_SOFTMAX_CROSS_ENTROPY)
+            {
+                std::vector<double> targetDistribution;
+                BackpropagationHandler::getTargetDistribution(targetValues[s], targetDistribution);
+                targetValues[s].swap(targetDistribution);
+                continue;
+            }
+
+            for (unsigned int k = 0; k < targetValues[s].size(); k++)
+            {
+                const double diff = outputValues[s][k] - targetValues[s][k];
+                loss += diff * diff;
+            }
+        }
+
+        if (m_lossFunction == LF_SOFTMAX_CROSS_ENTROPY)
+        {
+            loss = m_nodeNetwork->handleSoftMaxCrossEntropyBackpropagation(targetValues, gradient);
+        }
+        else
+        {
+            m_nodeNetwork->handleBackpropagation(targetValues, gradient);
+        }
+
+        // averages, so the scale doesn't depend on the number of boards
+        for (auto& value : gradient)
+        {
+            value /= numSamples;
+        }
+
+        return loss / numSamples;
+    }
+
+    void LbfgsHandler::iterationEnd(bool lastIteration)
+    {
+        auto objective = [this](const std::vector<double>& params, std::vector<double>& gradient)
+        {
+            return computeLoss(params, gradient);
+        };
+
+        std::vector<double> params;
+        m_nodeNetwork->getParameters(params);
+
+        std::vector<double> gradient;
+        double loss = computeLoss(params, gradient);
+        m_paramManager->setError(m_currentParamSetId, loss);
+
+        std::ostringstream buffer;
+        buffer << "  avg. error: " << loss;
+
+        if (lastIteration)
+        {
+            PRINT_LOG(buffer);
+            return;
+        }
+
+        Lbfgs& optimizer = m_optimizers.emplace(m_currentParamSetId, Lbfgs(m_historySize)).first->second;
+        if (!optimizer.step(objective, params, loss, gradient))
+        {
+            // converged (or stuck), so the set stays as it is
+            buffer << std::endl << "  no decrease found along the search direction, keeping the parameters";
+            PRINT_LOG(buffer);
+            return;
+        }
+
+        buffer << std::endl << "  new avg. error: " << loss << " (after " << optimizer.getNumEvaluations() << " line search evaluations)";
+        PRINT_LOG(buffer);
+
+        ParamSet pset;
+        pset.params = params;
+        const int newId = m_paramManager->addNewParamSet(pset);
+        m_paramManager->setParameterSetActive(m_currentParamSetId, false);
+
+        // the curvature history belongs to the new parameters now
+        m_optimizers.emplace(newId, std::move(optimizer));
+        m_optimizers.erase(m_currentParamSetId);
+    }
+
+    void LbfgsHandler::postIteration(bool lastIteration)
+    {
+    }
+
+    //---------------------------------------
+    // CandidatePopulationHandler
+    //---------------------------------------
+    CandidatePopulationHandler::CandidatePopulationHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+                                                           int numCandidates)
+        : TrainingMethodHandler(network, paramManager, gameLogic)
+        , m_numCandidates(numCandidates)
+    {
+    }
+
+    bool CandidatePopulationHandler::initialize()
+    {
+        const int startId = m_paramManager->getBestParameterSetId();
+        if (startId < 0 || !m_paramManager->copyParameters(startId, m_currentParams))
+        {
+            std::ostringstream buffer;
+            buffer << "No parameter set to start the " << getName() << " from";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        if (!setupSearch())
+        {
+            return false;
+        }
+
+        // the starting set is added again by createCandidates
+        std::vector<int> ids;
+        m_paramManager->getActiveParameterSetIds(ids);
+        for (auto id : ids)
+        {
+            m_paramManager->removeParameterSetForId(id);
+        }
+
+        createCandidates();
+        return true;
+    }
+
+    bool CandidatePopulationHandler::getParameters(int id, std::vector<double>& params) const
+    {
+        const int candidate = m_firstCandidateId >= 0 ? id - m_firstCandidateId : -1;
+        if (candidate < 0 || candidate >= m_numCandidates)
+        {
+            return TrainingMethodHandler::getParameters(id, params);
+        }
+
+        getCandidateParameters(candidate, params);
+        return true;
+    }
+
+    double CandidatePopulationHandler::handleTrainingIteration(std::shared_ptr<BasePlayer>& player)
+    {
+        return 0;
+    }
+
+    void CandidatePopulationHandler::iterationEnd(bool lastIteration)
+    {
+    }
+
+    void CandidatePopulationHandler::postIteration(bool lastIteration)
+    {
+        if (lastIteration)
+        {
+            // the current parameters are the result, the candidates have no values of their own
+            removeCandidates();
+            return;
+        }
+
+        std::vector<double> scores(m_numCandidates);
+        for (int c = 0; c < m_numCandidates; c++)
+        {
+            scores[c] = m_paramManager->getScore(m_firstCandidateId + c);
+        }
+
+        updateParameters(scores);
+        removeCandidates();
+        m_paramManager->setParameterSetActive(m_currentId, false);
+        createCandidates();
+
+        std::ostringstream buffer;
+        buffer << "Updated parameters in new parameter set " << m_currentId << ", adding candidates "
+            << m_firstCandidateId << " to " << (m_firstCandidateId + m_numCandidates - 1);
+        PRINT_LOG(buffer);
+    }
+
+    void CandidatePopulationHandler::createCandidates()
+    {
+        ParamSet pset;
+        pset.params = m_currentParams;
+        m_currentId = m_paramManager->addNewParamSet(pset);
+
+        sampleCandidates();
+
+        // the values are put together by getParameters when a candidate is evaluated
+        const ParamSet candidate;
+        for (int c = 0; c < m_numCandidates; c++)
+        {
+            const int id = m_paramManager->addNewParamSet(candidate);
+            if (c == 0)
+            {
+                m_firstCandidateId = id;
+            }
+
+            assert(id == m_firstCandidateId + c);
+        }
+    }
+
+    void CandidatePopulationHandler::removeCandidates()
+    {
+        for (int c = 0; c < m_numCandidates; c++)
+        {
+            m_paramManager->removeParameterSetForId(m_firstCandidateId + c);
+        }
+
+        m_firstCandidateId = -1;
+    }
+
+    //---------------------------------------
+    // EvolutionStrategiesHandler
+    //---------------------------------------
+    EvolutionStrategiesHandler::EvolutionStrategiesHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+                                                           const EvolutionStrategiesData& esData, int populationSize)
+        : CandidatePopulationHandler(network, paramManager, gameLogic, 2 * std::max(1, (populationSize + 1) / 2))
+        , m_esData(esData)
+    {
+    }
+
+    void EvolutionStrategiesHandler::describeTrainingMethod() const
+    {
+        std::ostringstream buffer;
+        buffer << "Training method: " << getName();
+        buffer << std::endl << "  #candidates per iteration: " << m_numCandidates;
+        buffer << std::endl << "  Noise standard deviation: " << m_esData.noiseStandardDeviation;
+        buffer << std::endl << "  Learning rate: " << m_esData.learningRate;
+        buffer << std::endl << "  Noise table size: " << m_esData.noiseTableSize;
+        buffer << std::endl;
+        PRINT_LOG(buffer);
+    }
+
+    bool EvolutionStrategiesHandler::setupSearch()
+    {
+        const int numParams = static_cast<int>(m_currentParams.size());
+        if (m_esData.noiseTableSize < numParams)
+        {
+            std::ostringstream buffer;
+            buffer << "The noise table (" << m_esData.noiseTableSize << " values) needs to be at least as large as the number of parameters (" << numParams << ")";
+            PRINT_ERROR(buffer);
+            return false;
+        }
+
+        m_noiseTable.create(Math::Random::getGenerator(), m_esData.noiseTableSize);
+        return true;
+    }
+
+    void EvolutionStrategiesHandler::sampleCandidates()
+    {
+        const int numParams = static_cast<int>(m_currentParams.size());
+        Math::RandomGenerator& generator = Math::Random::getGenerator();
+
+        m_offsets.resize(m_numCandidates / 2);
+        for (auto& offset : m_offsets)
+        {
+            offset = m_noiseTable.sampleOffset(generator, numParams);
+        }
+    }
+
+    void EvolutionStrategiesHandler::getCandidateParameters(int c, std::vector<double>& params) const
+    {
+        const int numParams = static_cast<int>(m_currentParams.size());
+        const double* noise = m_noiseTable.getSlice(m_offsets[c / 2]);
+        const double scale = (c % 2 == 0) ? m_esData.noiseStandardDeviation : -m_esData.noiseStandardDeviation;
+
+        params.resize(numParams);
+        for (int k = 0; k < numParams; k++)
+        {
+            params[k] = m_currentParams[k] + scale * noise[k];
+        }
+    }
+
+    void EvolutionStrategiesHandler::computeCenteredRanks(const std::vector<double>& scores, std::vector<double>& ranks)
+    {
+        const int numScores = static_cast<int>(scores.size());
+        ranks.assign(numScores, 0.0);
+        if (numScores < 2)
+        {
+            return;
+        }
+
+        std::vector<int> order(numScores);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&scores](int a, int b) { return scores[a] < scores[b]; });
+
+        for (int first = 0; first < numScores; )
+        {
+            // tied scores share the average of their ranks
+            int last = first;
+            while (last + 1 < numScores && scores[order[last + 1]] == scores[order[first]])
+            {
+                last++;
+            }
+
+            const double rank = (first + last) * 0.5 / (numScores - 1) - 0.5;
+            for (int k = first; k <= last; k++)
+            {
+                ranks[order[k]] = rank;
+            }
+
+            first = last + 1;
+        }
+    }
+
+    void EvolutionStrategiesHandler::updateParameters(const std::vector<double>& scores)
+    {
+        // ranks instead of the scores themselves, so a few outliers can't dominate the step
+        std::vector<double> ranks;
+        computeCenteredRanks(scores, ranks);
+
+        // mirrored candidates share their slice of the noise table, so each pair only contributes once
+        std::vector<double> weights(m_offsets.size());
+        for (size_t p = 0; p < weights.size(); p++)
+        {
+            weights[p] = ranks[2 * p] - ranks[2 * p + 1];
+        }
+
+        const int numParams = static_cast<int>(m_currentParams.size());
+        std::vector<double> gradient(numParams, 0.0);
+        m_noiseTable.addWeightedSum(m_offsets, weights, numParams, gradient.data());
+
+        const double stepScale = m_esData.learningRate / (m_numCandidates * m_esData.noiseStandardDeviation);
+        for (int k = 0; k < numParams; k++)
+        {
+            m_currentParams[k] += stepScale * gradient[k];
+        }
+    }
+
+    //---------------------------------------
+    // CmaEsHandler
+    //---------------------------------------
+    CmaEsHandler::CmaEsHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+                               const CmaEsData& cmaData, int populationSize)
+        : CandidatePopulationHandler(network, paramManager, gameLogic, std::max(2, populationSize))
+        , m_cmaData(cmaData)
+    {
+    }
+
+    void CmaEsHandler::describeTrainingMethod() const
+    {
+        std::ostringstream buffer;
+        buffer << "Training method: " << getName();
+        buffer << std::endl << "  #candidates per iteration: " << m_numCandidates;
+        buffer << std::endl << "  Initial step size: " << m_cmaData.initialStepSize;
+        buffer << std::endl << "  Covariance matrix: " << (m_cmaData.separable ? "diagonal (separable)" : "full");
+        buffer << std::endl;
+        PRINT_LOG(buffer);
+    }
+
+    bool CmaEsHandler::setupSearch()
+    {
+        m_cma.setup(m_currentParams, m_cmaData.initialStepSize, m_numCandidates, m_cmaData.separable);
+        return true;
+    }
+
+    void CmaEsHandler::sampleCandidates()
+    {
+        m_cma.samplePopulation();
+    }
+
+    void CmaEsHandler::getCandidateParameters(int c, std::vector<double>& params) const
+    {
+        const double* candidate = m_cma.getCandidate(c);
+        params.assign(candidate, candidate + m_cma.getNumParams());
+    }
+
+    void CmaEsHandler::updateParameters(const std::vector<double>& scores)
+    {
+        m_cma.update(scores);
+        m_currentParams = m_cma.getMean();
+
+        std::ostringstream buffer;
+        buffer << "  new step size: " << m_cma.getStepSize();
+        PRINT_LOG(buffer);
+    }
 }
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <map>
 #include <memory>
 #include <vector>
 
 #include "Game/GameLogic.h"
 #include "Game/Player.h"
+#include "IslandMigration.h"
+#include "Math/Lbfgs.h"
+#include "Math/NoiseTable.h"
+#include "NeuralNetwork/CmaEvolutionStrategy.h"
 #include "NeuralNetwork/NodeNetwork.h"
 #include "NeuralNetwork/ParameterManager.h"
 
@@ -16,14 +21,26 @@ namespace Training
         TrainingMethodHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<NeuralNetwork::ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic);
         virtual ~TrainingMethodHandler() = default;
 
+    public:
+        static bool parseTrainingMethod(const std::string& name, TrainingMethod& trainingMethod);
+        static std::string getTrainingMethodDescription(TrainingMethod trainingMethod);
+
     public:
         virtual std::string getName() const { return "TrainingMethodHandler"; }
         virtual void describeTrainingMethod() const;
+
+        /// the values assigned to the network when evaluating parameter set id
+        /// by default, these are the values stored in the parameter manager
+        virtual bool getParameters(int id, std::vector<double>& params) const;
+
         virtual void iterationStart(int paramSetId);
         virtual double handleTrainingIteration(std::shared_ptr<Game::BasePlayer>& player) = 0;
         virtual void iterationEnd(bool lastIteration) = 0;
         virtual void postIteration(bool lastIteration = false) = 0;
 
+        /// called by the trainer as soon as the score of a parameter set is known, before the next set is evaluated
+        virtual void candidateEvaluated(int paramSetId, bool lastIteration);
+
     protected:
         std::shared_ptr<NeuralNetwork::NodeNetwork> m_nodeNetwork;
         std::shared_ptr<NeuralNetwork::ParameterManager> m_paramManager;
@@ -47,6 +64,47 @@ namespace Training
     private:
     };
 
+    /// genetic algorithm on one island of an island model
+    /// Every few generations, the best sets are sent to the next island. Migrants from the previous island
+    /// replace some of the new crossover children whenever they arrive, without waiting for them.
+    class IslandModelHandler
+        : public ParameterEvolutionHandler
+    {
+    public:
+        IslandModelHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<NeuralNetwork::ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+            const IslandModelData& islandData);
+        virtual ~IslandModelHandler() = default;
+
+    public:
+        std::string getName() const override { return "IslandModelHandler"; }
+        void describeTrainingMethod() const override;
+        void postIteration(bool lastIteration = false) override;
+
+    private:
+        void sendMigrants();
+        void receiveMigrants();
+
+    private:
+        IslandModelData m_islandData;
+        IslandMigration m_migration;
+        int m_generation = 0;
+    };
+
+    /// steady-state genetic algorithm: there is no evolution step for the whole population between iterations.
+    /// As soon as a set has been evaluated, a child of the evaluated population is added, so a slow evaluation never holds back the others.
+    /// The children are evaluated in the next iteration, and each one replaces the worst population member if it beats it.
+    class SteadyStateEvolutionHandler
+        : public ParameterEvolutionHandler
+    {
+    public:
+        SteadyStateEvolutionHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<NeuralNetwork::ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic);
+        virtual ~SteadyStateEvolutionHandler() = default;
+
+    public:
+        std::string getName() const override { return "SteadyStateEvolutionHandler"; }
+        void candidateEvaluated(int paramSetId, bool lastIteration) override;
+        void postIteration(bool lastIteration = false) override;
+    };
 
     class BackpropagationHandler
         : public TrainingMethodHandler
@@ -63,7 +121,13 @@ namespace Training
         void iterationEnd(bool lastIteration) override;
         void postIteration(bool lastIteration = false) override;
 
+        void setLossFunction(LossFunction lossFunction) { m_lossFunction = lossFunction; }
+
+        /// turns the corrected output values into a probability distribution over the moves
+        static void getTargetDistribution(const std::vector<double>& correctedValues, std::vector<double>& targetDistribution);
+
     private:
+        LossFunction m_lossFunction = LF_SQUARED_ERROR;
         std::vector<double> m_parameterAdjustmentValues;
         std::vector<double> m_errors;
 
@@ -78,4 +142,156 @@ namespace Training
         int m_countTrainingSets = 0;
         double m_prevError = INFINITY;
     };
+
+
+    /// full-batch L-BFGS: the boards of an iteration are collected while the trainer evaluates a parameter set,
+    /// afterwards the loss over all of them is minimized with one quasi-Newton step (including a line search).
+    /// Each parameter set keeps its own curvature history, which moves on to the set created from it.
+    class LbfgsHandler
+        : public TrainingMethodHandler
+    {
+    public:
+        LbfgsHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<NeuralNetwork::ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+                     int historySize);
+        virtual ~LbfgsHandler() = default;
+
+    public:
+        std::string getName() const override { return "LbfgsHandler"; }
+        void describeTrainingMethod() const override;
+        void iterationStart(int paramSetId) override;
+        double handleTrainingIteration(std::shared_ptr<Game::BasePlayer>& player) override;
+        void iterationEnd(bool lastIteration) override;
+        void postIteration(bool lastIteration = false) override;
+
+        void setLossFunction(LossFunction lossFunction) { m_lossFunction = lossFunction; }
+
+        /// average loss over the collected boards for the given parameters, and its gradient
+        double computeLoss(const std::vector<double>& params, std::vector<double>& gradient);
+
+    private:
+        LossFunction m_lossFunction = LF_SQUARED_ERROR;
+        int m_historySize;
+
+        /// one optimizer (i.e. curvature history) per parameter set id
+        std::map<int, Math::Lbfgs> m_optimizers;
+
+        // boards collected during the current iteration
+        std::vector<std::vector<double>> m_inputValues;
+        std::vector<std::vector<CellState>> m_gameCells;
+        std::vector<int> m_playerIndices;
+    };
+
+
+    /// base for methods that try a population of candidates around the current parameters in each iteration
+    /// and then move the current parameters based on the scores of the candidates.
+    /// The candidates are added to the parameter manager without values and only put together when they are evaluated,
+    /// the current parameters are added as a regular set (so they also get a score).
+    class CandidatePopulationHandler
+        : public TrainingMethodHandler
+    {
+    public:
+        CandidatePopulationHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<NeuralNetwork::ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+                                   int numCandidates);
+        virtual ~CandidatePopulationHandler() = default;
+
+    public:
+        bool getParameters(int id, std::vector<double>& params) const override;
+        double handleTrainingIteration(std::shared_ptr<Game::BasePlayer>& player) override;
+        void iterationEnd(bool lastIteration) override;
+        void postIteration(bool lastIteration = false) override;
+
+        /// starts from the best existing parameter set and replaces all sets by the first generation of candidates
+        bool initialize();
+
+        int getCurrentParameterSetId() const { return m_currentId; }
+        int getNumCandidates() const { return m_numCandidates; }
+
+    protected:
+        /// called once by initialize, after the starting parameters have been picked
+        virtual bool setupSearch() = 0;
+
+        /// draws the candidates for the next iteration
+        virtual void sampleCandidates() = 0;
+
+        /// values of candidate c (in [0, getNumCandidates()))
+        virtual void getCandidateParameters(int c, std::vector<double>& params) const = 0;
+
+        /// moves m_currentParams based on the scores of the candidates (scores[c] belongs to candidate c)
+        virtual void updateParameters(const std::vector<double>& scores) = 0;
+
+    private:
+        /// adds the current parameters as a new set, followed by the (newly sampled) candidates
+        void createCandidates();
+
+        /// removes all candidates from the parameter manager
+        void removeCandidates();
+
+    protected:
+        int m_numCandidates;
+        std::vector<double> m_currentParams;
+        int m_currentId = -1; /// parameter set holding m_currentParams
+        int m_firstCandidateId = -1; /// candidate c has the id m_firstCandidateId + c
+    };
+
+
+    /// evolution strategies (Salimans et al., 2017): the candidates are the current parameters plus and minus
+    /// (antithetic sampling) random perturbations, and the current parameters are moved along the score-weighted
+    /// sum of the perturbations.
+    /// The perturbations are slices of one shared noise table, so each pair of candidates is stored as a single offset.
+    class EvolutionStrategiesHandler
+        : public CandidatePopulationHandler
+    {
+    public:
+        EvolutionStrategiesHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<NeuralNetwork::ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+                                   const EvolutionStrategiesData& esData, int populationSize);
+        virtual ~EvolutionStrategiesHandler() = default;
+
+    public:
+        std::string getName() const override { return "EvolutionStrategiesHandler"; }
+        void describeTrainingMethod() const override;
+
+        /// converts scores into weights in [-0.5, 0.5] that only depend on the order of the scores (tied scores get the same weight)
+        static void computeCenteredRanks(const std::vector<double>& scores, std::vector<double>& ranks);
+
+    protected:
+        bool setupSearch() override;
+        void sampleCandidates() override;
+        void getCandidateParameters(int c, std::vector<double>& params) const override;
+        void updateParameters(const std::vector<double>& scores) override;
+
+    private:
+        EvolutionStrategiesData m_esData;
+        Math::NoiseTable m_noiseTable;
+
+        /// candidate 2 * p uses the slice of the noise table at m_offsets[p], candidate 2 * p + 1 the negated slice
+        std::vector<int> m_offsets;
+    };
+
+
+    /// covariance matrix adaptation evolution strategy (see NeuralNetwork::CmaEvolutionStrategy)
+    class CmaEsHandler
+        : public CandidatePopulationHandler
+    {
+    public:
+        CmaEsHandler(std::shared_ptr<NeuralNetwork::NodeNetwork>& network, std::shared_ptr<NeuralNetwork::ParameterManager>& paramManager, std::shared_ptr<Game::GameLogic>& gameLogic,
+                     const CmaEsData& cmaData, int populationSize);
+        virtual ~CmaEsHandler() = default;
+
+    public:
+        std::string getName() const override { return "CmaEsHandler"; }
+        void describeTrainingMethod() const override;
+
+        /// candidates are sampled in parallel on this pool (nullptr: on the calling thread)
+        void setThreadPool(const std::shared_ptr<General::ThreadPool>& threadPool) { m_cma.setThreadPool(threadPool); }
+
+    protected:
+        bool setupSearch() override;
+        void sampleCandidates() override;
+        void getCandidateParameters(int c, std::vector<double>& params) const override;
+        void updateParameters(const std::vector<double>& scores) override;
+
+    private:
+        CmaEsData m_cmaData;
+        NeuralNetwork::CmaEvolutionStrategy m_cma;
+    };
 }
@@ -1,14 +1,26 @@
 #include "stdafx.h"
 
+#include <cstdlib>
 #include <memory>
+#include <string>
 
+#include "FileIO/FileManager.h"
 #include "Game/GameLogic.h"
 #include "Training/TicTacToeTrainer.h"
 
-int main()
+int main(int argc, char* argv[])
 {
     std::shared_ptr<Game::GameLogic> gameLogic = std::make_shared<Game::TicTacToeLogic>();
     Training::TicTacToeTrainer trainer(gameLogic);
+
+    // island model: each process is started with its island index and writes its own files
+    if (argc > 1)
+    {
+        const int islandIndex = std::atoi(argv[1]);
+        trainer.setIslandIndex(islandIndex);
+        FileIO::FileManager::setFileNamePrefix("island" + std::to_string(islandIndex) + "_");
+    }
+
     trainer.run();
     return 0;
 }